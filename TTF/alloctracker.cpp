@@ -0,0 +1,79 @@
+#include "alloctracker.h"
+
+#ifdef TTF_ALLOC_TRACKING
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+static std::atomic<uint64_t> g_heapAllocations(0);
+
+uint64_t GetHeapAllocations()
+{
+    return g_heapAllocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if(size == 0)
+        size = 1;
+
+    for(;;)
+    {
+        void* block = malloc(size);
+        if(block)
+            return block;
+
+        std::new_handler handler = std::get_new_handler();
+        if(!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* block) noexcept
+{
+    free(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept
+{
+    free(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+    free(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept
+{
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept
+{
+    free(block);
+}
+#endif
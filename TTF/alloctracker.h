@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+// Counts heap allocations made through operator new anywhere in the plugin
+// Hot paths are meant to allocate nothing once their glyphs are cached, these counters are how that gets checked
+// Everything compiles to nothing unless TTF_ALLOC_TRACKING is defined, then the global operator new and delete get replaced
+#ifdef TTF_ALLOC_TRACKING
+#define TTF_ALLOC_TRACKING_ENABLED true
+
+uint64_t GetHeapAllocations();
+#else
+#define TTF_ALLOC_TRACKING_ENABLED false
+
+inline uint64_t GetHeapAllocations() {return 0;}
+#endif
@@ -0,0 +1,193 @@
+#include "atlasdump.h"
+
+#include <stdio.h>
+
+// Largest payload of a stored deflate block
+#define DEFLATE_STORED_BLOCK 65535
+
+static uint32_t g_crcTable[256];
+
+static void InitCrcTable()
+{
+    if(g_crcTable[1])
+        return;
+
+    for(uint32_t n = 0; n < 256; ++n)
+    {
+        uint32_t c = n;
+        for(int k = 0; k < 8; ++k)
+            c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+        g_crcTable[n] = c;
+    }
+}
+
+static uint32_t UpdateCrc(uint32_t crc, const unsigned char* data, size_t len)
+{
+    for(size_t i = 0; i < len; ++i)
+        crc = g_crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void AppendU32(std::vector<unsigned char>& out, uint32_t value)
+{
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static void WriteChunk(FILE* f, const char* type, const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> chunk;
+    AppendU32(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    AppendU32(chunk, UpdateCrc(0xFFFFFFFF, chunk.data() + 4, chunk.size() - 4) ^ 0xFFFFFFFF);
+    fwrite(chunk.data(), 1, chunk.size(), f);
+}
+
+bool WriteGrayPNG(const char* path, unsigned int width, unsigned int height, const unsigned char* pixels)
+{
+    InitCrcTable();
+
+    // Every scanline starts with filter type 0
+    std::vector<unsigned char> raw;
+    raw.reserve(static_cast<size_t>(width + 1) * height);
+    for(unsigned int y = 0; y < height; ++y)
+    {
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels + static_cast<size_t>(y) * width, pixels + static_cast<size_t>(y + 1) * width);
+    }
+
+    std::vector<unsigned char> zlib = {0x78, 0x01};
+    uint32_t adlerA = 1, adlerB = 0;
+    for(size_t pos = 0; pos < raw.size(); pos += DEFLATE_STORED_BLOCK)
+    {
+        size_t len = raw.size() - pos;
+        if(len > DEFLATE_STORED_BLOCK)
+            len = DEFLATE_STORED_BLOCK;
+
+        zlib.push_back(pos + len >= raw.size() ? 1 : 0);
+        zlib.push_back(static_cast<unsigned char>(len));
+        zlib.push_back(static_cast<unsigned char>(len >> 8));
+        zlib.push_back(static_cast<unsigned char>(~len));
+        zlib.push_back(static_cast<unsigned char>(~len >> 8));
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + len);
+        for(size_t i = pos; i < pos + len; ++i)
+        {
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+    }
+    AppendU32(zlib, (adlerB << 16) | adlerA);
+
+    FILE* f = fopen(path, "wb");
+    if(!f)
+        return false;
+
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, sizeof(signature), f);
+
+    std::vector<unsigned char> header;
+    AppendU32(header, width);
+    AppendU32(header, height);
+    header.push_back(8); // bit depth
+    header.push_back(0); // grayscale
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    WriteChunk(f, "IHDR", header);
+    WriteChunk(f, "IDAT", zlib);
+    WriteChunk(f, "IEND", std::vector<unsigned char>());
+    fclose(f);
+    return true;
+}
+
+static void WriteJsonString(FILE* f, const char* str)
+{
+    fputc('"', f);
+    for(; *str; ++str)
+    {
+        unsigned char c = static_cast<unsigned char>(*str);
+        if(c == '"' || c == '\\')
+            fprintf(f, "\\%c", c);
+        else if(c < 0x20)
+            fprintf(f, "\\u%04X", c);
+        else
+            fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+bool WriteAtlasDump(const char* prefix, const GlyphAtlas& atlas, const std::vector<AtlasDumpGlyph>& glyphs,
+    const std::vector<std::vector<unsigned char>>& pixels, uint32_t frame)
+{
+    std::string base(prefix);
+    size_t nameStart = base.find_last_of("\\/");
+    std::string baseName = (nameStart == std::string::npos ? base : base.substr(nameStart + 1));
+
+    FILE* f = fopen((base + ".json").c_str(), "w");
+    if(!f)
+        return false;
+
+    unsigned int pageSize = atlas.GetPageSize();
+    double pageArea = static_cast<double>(pageSize) * pageSize;
+    size_t livePages = 0, usedArea = 0, shelfArea = 0, freeArea = 0;
+    fprintf(f, "{\"frame\":%u,\"pageSize\":%u,\"padding\":%u,\"pages\":[", frame, pageSize, atlas.GetPadding());
+    for(size_t i = 0; i < atlas.GetPageCount(); ++i)
+    {
+        int page = static_cast<int>(i);
+        if(!atlas.IsPageUsed(page))
+            continue;
+
+        std::string file = baseName + "_" + std::to_string(i) + ".png";
+        if(i < pixels.size() && pixels[i].size() == static_cast<size_t>(pageSize) * pageSize)
+            WriteGrayPNG((base + "_" + std::to_string(i) + ".png").c_str(), pageSize, pageSize, pixels[i].data());
+        else
+            file.clear();
+
+        // Shelves cover glyphs, padding and holes, free slots are the holes that can still be reused
+        const AtlasPacker& packer = atlas.GetPacker(page);
+        size_t pageShelfArea = 0, pageFreeArea = 0;
+        fprintf(f, "%s\n{\"index\":%u,\"file\":", (livePages ? "," : ""), static_cast<unsigned int>(i));
+        WriteJsonString(f, file.c_str());
+        fprintf(f, ",\"glyphs\":%u,\"shelves\":[", static_cast<unsigned int>(packer.GetAllocations()));
+        bool firstShelf = true;
+        for(const AtlasPacker::Shelf& shelf : packer.GetShelves())
+        {
+            fprintf(f, "%s{\"y\":%u,\"height\":%u,\"end\":%u,\"free\":[", (firstShelf ? "" : ","), shelf.y, shelf.height, shelf.end);
+            for(size_t s = 0; s < shelf.freeSlots.size(); ++s)
+            {
+                fprintf(f, "%s{\"x\":%u,\"width\":%u}", (s ? "," : ""), shelf.freeSlots[s].x, shelf.freeSlots[s].width);
+                pageFreeArea += static_cast<size_t>(shelf.freeSlots[s].width) * shelf.height;
+            }
+            fprintf(f, "]}");
+            pageShelfArea += static_cast<size_t>(shelf.end) * shelf.height;
+            firstShelf = false;
+        }
+        fprintf(f, "],\"occupancy\":%.2f,\"shelved\":%.2f,\"freeList\":%.2f}", packer.GetUsedArea() * 100.0 / pageArea,
+            pageShelfArea * 100.0 / pageArea, pageFreeArea * 100.0 / pageArea);
+
+        ++livePages;
+        usedArea += packer.GetUsedArea();
+        shelfArea += pageShelfArea;
+        freeArea += pageFreeArea;
+    }
+
+    fprintf(f, "\n],\"glyphs\":[");
+    for(size_t i = 0; i < glyphs.size(); ++i)
+    {
+        const AtlasDumpGlyph& glyph = glyphs[i];
+        fprintf(f, "%s\n{\"font\":", (i ? "," : ""));
+        WriteJsonString(f, glyph.font.c_str());
+        fprintf(f, ",\"codepoint\":%u,\"page\":%d,\"x\":%u,\"y\":%u,\"width\":%u,\"height\":%u,\"lastUsed\":%u}", glyph.codepoint, glyph.page,
+            glyph.rect.x, glyph.rect.y, glyph.rect.width, glyph.rect.height, glyph.lastUsed);
+    }
+
+    double atlasArea = pageArea * livePages;
+    fprintf(f, "\n],\"summary\":{\"pages\":%u,\"glyphs\":%u,\"occupancy\":%.2f,\"shelved\":%.2f,\"freeList\":%.2f}}\n",
+        static_cast<unsigned int>(livePages), static_cast<unsigned int>(glyphs.size()), (atlasArea > 0.0 ? usedArea * 100.0 / atlasArea : 0.0),
+        (atlasArea > 0.0 ? shelfArea * 100.0 / atlasArea : 0.0), (atlasArea > 0.0 ? freeArea * 100.0 / atlasArea : 0.0));
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "glyphatlas.h"
+
+struct AtlasDumpGlyph
+{
+    std::string font;
+    uint32_t codepoint;
+    int page;
+    AtlasRect rect;
+    uint32_t lastUsed;
+};
+
+// 8-bit grayscale PNG with stored deflate blocks, big but needs no compressor
+bool WriteGrayPNG(const char* path, unsigned int width, unsigned int height, const unsigned char* pixels);
+
+// Writes <prefix>_<page>.png for every page that has pixels and <prefix>.json with the glyph rectangles,
+// the shelves and free slots of every page and the occupancy of each page and of the whole atlas
+bool WriteAtlasDump(const char* prefix, const GlyphAtlas& atlas, const std::vector<AtlasDumpGlyph>& glyphs,
+    const std::vector<std::vector<unsigned char>>& pixels, uint32_t frame);
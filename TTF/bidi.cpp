@@ -0,0 +1,378 @@
+#include "bidi.h"
+#include "compose.h"
+#include "shaping.h"
+#include "textcore.h"
+
+#include <algorithm>
+
+struct BidiRange
+{
+    uint32_t first;
+    uint32_t last;
+    BidiClass bidiClass;
+};
+
+#include "bidiclasses.h"
+
+static const BidiClass g_asciiBidiClasses[128] = {
+    Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN,
+    Bidi_BN, Bidi_S, Bidi_B, Bidi_S, Bidi_WS, Bidi_B, Bidi_BN, Bidi_BN,
+    Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN,
+    Bidi_BN, Bidi_BN, Bidi_BN, Bidi_BN, Bidi_B, Bidi_B, Bidi_B, Bidi_S,
+    Bidi_WS, Bidi_ON, Bidi_ON, Bidi_ET, Bidi_ET, Bidi_ET, Bidi_ON, Bidi_ON,
+    Bidi_ON, Bidi_ON, Bidi_ON, Bidi_ES, Bidi_CS, Bidi_ES, Bidi_CS, Bidi_CS,
+    Bidi_EN, Bidi_EN, Bidi_EN, Bidi_EN, Bidi_EN, Bidi_EN, Bidi_EN, Bidi_EN,
+    Bidi_EN, Bidi_EN, Bidi_CS, Bidi_ON, Bidi_ON, Bidi_ON, Bidi_ON, Bidi_ON,
+    Bidi_ON, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L,
+    Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L,
+    Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L,
+    Bidi_L, Bidi_L, Bidi_L, Bidi_ON, Bidi_ON, Bidi_ON, Bidi_ON, Bidi_ON,
+    Bidi_ON, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L,
+    Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L,
+    Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L, Bidi_L,
+    Bidi_L, Bidi_L, Bidi_L, Bidi_ON, Bidi_ON, Bidi_ON, Bidi_ON, Bidi_BN,
+};
+
+// Bidi_Mirroring_Glyph of the brackets and comparison signs, sorted by the first code point
+static const uint32_t g_mirroredPairs[][2] = {
+    {0x0028, 0x0029}, {0x0029, 0x0028}, {0x003C, 0x003E}, {0x003E, 0x003C}, {0x005B, 0x005D}, {0x005D, 0x005B},
+    {0x007B, 0x007D}, {0x007D, 0x007B}, {0x00AB, 0x00BB}, {0x00BB, 0x00AB}, {0x2039, 0x203A}, {0x203A, 0x2039},
+    {0x2045, 0x2046}, {0x2046, 0x2045}, {0x207D, 0x207E}, {0x207E, 0x207D}, {0x208D, 0x208E}, {0x208E, 0x208D},
+    {0x2264, 0x2265}, {0x2265, 0x2264}, {0x2308, 0x2309}, {0x2309, 0x2308}, {0x230A, 0x230B}, {0x230B, 0x230A},
+    {0x2329, 0x232A}, {0x232A, 0x2329}, {0x27E8, 0x27E9}, {0x27E9, 0x27E8}, {0x3008, 0x3009}, {0x3009, 0x3008},
+    {0x300A, 0x300B}, {0x300B, 0x300A}, {0x300C, 0x300D}, {0x300D, 0x300C}, {0x300E, 0x300F}, {0x300F, 0x300E},
+    {0x3010, 0x3011}, {0x3011, 0x3010}, {0x3014, 0x3015}, {0x3015, 0x3014}, {0x3016, 0x3017}, {0x3017, 0x3016},
+    {0x3018, 0x3019}, {0x3019, 0x3018}, {0x301A, 0x301B}, {0x301B, 0x301A}, {0xFF08, 0xFF09}, {0xFF09, 0xFF08},
+    {0xFF1C, 0xFF1E}, {0xFF1E, 0xFF1C}, {0xFF3B, 0xFF3D}, {0xFF3D, 0xFF3B}, {0xFF5B, 0xFF5D}, {0xFF5D, 0xFF5B},
+    {0xFF5F, 0xFF60}, {0xFF60, 0xFF5F}, {0xFF62, 0xFF63}, {0xFF63, 0xFF62},
+};
+
+BidiClass GetBidiClass(uint32_t utf32)
+{
+    if(utf32 < 128)
+        return g_asciiBidiClasses[utf32];
+
+    const BidiRange* end = g_bidiRanges + sizeof(g_bidiRanges) / sizeof(g_bidiRanges[0]);
+    const BidiRange* it = std::upper_bound(g_bidiRanges, end, utf32, [](uint32_t value, const BidiRange& range)
+    {
+        return value < range.first;
+    });
+    if(it != g_bidiRanges && utf32 <= (it - 1)->last)
+        return (it - 1)->bidiClass;
+    return Bidi_L;
+}
+
+static uint32_t GetMirroredCharacter(uint32_t utf32)
+{
+    const uint32_t(*end)[2] = g_mirroredPairs + sizeof(g_mirroredPairs) / sizeof(g_mirroredPairs[0]);
+    const uint32_t(*it)[2] = std::lower_bound(g_mirroredPairs, end, utf32, [](const uint32_t(&pair)[2], uint32_t value)
+    {
+        return pair[0] < value;
+    });
+    return ((it != end && (*it)[0] == utf32) ? (*it)[1] : utf32);
+}
+
+bool MayNeedBidi(int encoding, const char* text, int len)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text);
+    if(encoding == 1255 || encoding == 1256)
+    {
+        for(int i = 0; i < len; ++i)
+        {
+            if(bytes[i] >= 0x80)
+                return true;
+        }
+        return false;
+    }
+    if(encoding >= 1250 && encoding <= 1258)
+        return false;
+
+    // UTF-8 lead bytes of U+0590 to U+07FF, the right-to-left mark, the Hebrew and Arabic presentation forms
+    // and the right-to-left blocks of the supplementary planes
+    for(int i = 0; i < len; ++i)
+    {
+        unsigned char lead = bytes[i];
+        if(lead < 0xD6)
+            continue;
+        if(lead <= 0xDF)
+            return true;
+        if(i + 2 < len && lead == 0xE2 && bytes[i + 1] == 0x80 && bytes[i + 2] == 0x8F)
+            return true;
+        if(i + 1 < len && lead == 0xEF && bytes[i + 1] >= 0xAC && bytes[i + 1] <= 0xBB)
+            return true;
+        if(i + 2 < len && lead == 0xF0 && (bytes[i + 1] == 0x90 || bytes[i + 1] == 0x9E) && bytes[i + 2] >= 0xA0)
+            return true;
+    }
+    return false;
+}
+
+static bool IsNeutral(uint8_t bidiClass)
+{
+    return (bidiClass == Bidi_B || bidiClass == Bidi_S || bidiClass == Bidi_WS || bidiClass == Bidi_ON);
+}
+
+// Numbers count as right-to-left when they decide the direction of neutrals
+static uint8_t GetStrongDirection(uint8_t bidiClass)
+{
+    return (bidiClass == Bidi_L ? Bidi_L : Bidi_R);
+}
+
+void ReorderBidi(const uint32_t* characters, size_t count, BidiBuffers& buffers, std::vector<uint32_t>& visual)
+{
+    visual.clear();
+    if(count == 0)
+        return;
+
+    std::vector<uint8_t>& classes = buffers.classes;
+    std::vector<uint8_t>& levels = buffers.levels;
+    std::vector<uint32_t>& order = buffers.order;
+    classes.resize(count);
+    levels.resize(count);
+    order.resize(count);
+
+    // P2, P3
+    uint8_t paragraphLevel = 0;
+    bool strongFound = false;
+    for(size_t i = 0; i < count; ++i)
+    {
+        classes[i] = GetBidiClass(characters[i]);
+        if(!strongFound && (classes[i] == Bidi_L || classes[i] == Bidi_R || classes[i] == Bidi_AL))
+        {
+            paragraphLevel = (classes[i] == Bidi_L ? 0 : 1);
+            strongFound = true;
+        }
+    }
+    uint8_t embeddingDirection = (paragraphLevel ? Bidi_R : Bidi_L);
+
+    // W1, BN is kept in place and treated like a mark
+    uint8_t previous = embeddingDirection;
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(classes[i] == Bidi_NSM || classes[i] == Bidi_BN)
+            classes[i] = previous;
+        else
+            previous = classes[i];
+    }
+
+    // W2, W3
+    uint8_t lastStrong = embeddingDirection;
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(classes[i] == Bidi_L || classes[i] == Bidi_R || classes[i] == Bidi_AL)
+            lastStrong = classes[i];
+        else if(classes[i] == Bidi_EN && lastStrong == Bidi_AL)
+            classes[i] = Bidi_AN;
+    }
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(classes[i] == Bidi_AL)
+            classes[i] = Bidi_R;
+    }
+
+    // W4
+    for(size_t i = 1; i + 1 < count; ++i)
+    {
+        if(classes[i] == Bidi_ES && classes[i - 1] == Bidi_EN && classes[i + 1] == Bidi_EN)
+            classes[i] = Bidi_EN;
+        else if(classes[i] == Bidi_CS && classes[i - 1] == classes[i + 1] && (classes[i - 1] == Bidi_EN || classes[i - 1] == Bidi_AN))
+            classes[i] = classes[i - 1];
+    }
+
+    // W5, W6
+    for(size_t i = 0; i < count;)
+    {
+        if(classes[i] != Bidi_ET)
+        {
+            ++i;
+            continue;
+        }
+        size_t end = i;
+        while(end < count && classes[end] == Bidi_ET)
+            ++end;
+        bool number = ((i > 0 && classes[i - 1] == Bidi_EN) || (end < count && classes[end] == Bidi_EN));
+        std::fill(classes.begin() + i, classes.begin() + end, static_cast<uint8_t>(number ? Bidi_EN : Bidi_ON));
+        i = end;
+    }
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(classes[i] == Bidi_ES || classes[i] == Bidi_CS)
+            classes[i] = Bidi_ON;
+    }
+
+    // W7
+    lastStrong = embeddingDirection;
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(classes[i] == Bidi_L || classes[i] == Bidi_R)
+            lastStrong = classes[i];
+        else if(classes[i] == Bidi_EN && lastStrong == Bidi_L)
+            classes[i] = Bidi_L;
+    }
+
+    // N1, N2
+    for(size_t i = 0; i < count;)
+    {
+        if(!IsNeutral(classes[i]))
+        {
+            ++i;
+            continue;
+        }
+        size_t end = i;
+        while(end < count && IsNeutral(classes[end]))
+            ++end;
+        uint8_t before = (i > 0 ? GetStrongDirection(classes[i - 1]) : embeddingDirection);
+        uint8_t after = (end < count ? GetStrongDirection(classes[end]) : embeddingDirection);
+        std::fill(classes.begin() + i, classes.begin() + end, (before == after ? before : embeddingDirection));
+        i = end;
+    }
+
+    // I1, I2
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint8_t level = paragraphLevel;
+        if((level & 1) == 0)
+            level += (classes[i] == Bidi_R ? 1 : (classes[i] == Bidi_AN || classes[i] == Bidi_EN ? 2 : 0));
+        else if(classes[i] != Bidi_R)
+            ++level;
+        levels[i] = level;
+    }
+
+    // L1 looks at the original classes, whitespace before a separator and at the end of the line goes back to the paragraph level
+    bool trailing = true;
+    for(size_t i = count; i-- > 0;)
+    {
+        BidiClass bidiClass = GetBidiClass(characters[i]);
+        if(bidiClass == Bidi_S || bidiClass == Bidi_B)
+        {
+            levels[i] = paragraphLevel;
+            trailing = true;
+        }
+        else if(bidiClass == Bidi_WS || bidiClass == Bidi_BN)
+        {
+            if(trailing)
+                levels[i] = paragraphLevel;
+        }
+        else
+            trailing = false;
+    }
+
+    // L2, reverse every run at or above each level from the highest down to the lowest odd one
+    uint8_t highestLevel = 0, lowestOddLevel = 0xFF;
+    for(size_t i = 0; i < count; ++i)
+    {
+        order[i] = static_cast<uint32_t>(i);
+        highestLevel = std::max(highestLevel, levels[i]);
+        if(levels[i] & 1)
+            lowestOddLevel = std::min(lowestOddLevel, levels[i]);
+    }
+    for(uint8_t level = highestLevel; level >= lowestOddLevel && level > 0; --level)
+    {
+        for(size_t i = 0; i < count;)
+        {
+            if(levels[order[i]] < level)
+            {
+                ++i;
+                continue;
+            }
+            size_t end = i;
+            while(end < count && levels[order[end]] >= level)
+                ++end;
+            std::reverse(order.begin() + i, order.begin() + end);
+            i = end;
+        }
+    }
+
+    // L4
+    visual.resize(count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        uint32_t index = order[i];
+        visual[i] = ((levels[index] & 1) ? GetMirroredCharacter(characters[index]) : characters[index]);
+    }
+}
+
+bool BidiCache::IsNeeded(int encoding, const char* text, int len) const
+{
+    return ((m_reorder && MayNeedBidi(encoding, text, len)) || (m_composeMarks && MayNeedComposition(encoding, text, len)));
+}
+
+const std::vector<uint32_t>& BidiCache::Reorder(int encoding, const char* text, int len, const void* font, CharacterCoverage hasCharacter)
+{
+    // FNV-1a over the encoding, the font and the bytes
+    ++m_stats.lookups;
+    uint64_t hash = (14695981039346656037ull ^ static_cast<uint32_t>(encoding)) * 1099511628211ull;
+    hash = (hash ^ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(font))) * 1099511628211ull;
+    for(int i = 0; i < len; ++i)
+        hash = (hash ^ static_cast<unsigned char>(text[i])) * 1099511628211ull;
+
+    auto it = m_entries.find(hash);
+    if(it != m_entries.end() && it->second.encoding == encoding && it->second.font == font
+        && it->second.text.compare(0, std::string::npos, text, static_cast<size_t>(len)) == 0)
+        return it->second.visual;
+
+    ++m_stats.misses;
+    if(it == m_entries.end() && m_entries.size() >= m_maxEntries)
+    {
+        m_entries.clear();
+        ++m_stats.flushes;
+    }
+
+    // A colliding string simply takes the entry over
+    Entry& entry = m_entries[hash];
+    entry.encoding = encoding;
+    entry.font = font;
+    entry.text.assign(text, static_cast<size_t>(len));
+    m_logical.clear();
+    for(int i = 0; i < len;)
+    {
+        int utf8size;
+        m_logical.push_back(DecodeCharacter(encoding, text + i, len - i, utf8size));
+        i += utf8size;
+    }
+
+    const std::vector<uint32_t>* characters = &m_logical;
+    if(m_composeMarks)
+    {
+        ComposeCharacters(characters->data(), characters->size(), m_composed, [font, hasCharacter](uint32_t utf32)
+        {
+            return (!hasCharacter || hasCharacter(font, utf32));
+        });
+        characters = &m_composed;
+    }
+    if(m_shapeArabic)
+    {
+        ShapeArabic(characters->data(), characters->size(), m_shaped);
+        characters = &m_shaped;
+    }
+    if(m_reorder)
+        ReorderBidi(characters->data(), characters->size(), m_buffers, entry.visual);
+    else
+        entry.visual = *characters;
+    return entry.visual;
+}
+
+void BidiCache::Clear()
+{
+    m_entries.clear();
+}
+
+void BidiCache::SetComposition(bool composeMarks)
+{
+    if(composeMarks != m_composeMarks)
+        m_entries.clear();
+    m_composeMarks = composeMarks;
+}
+
+void BidiCache::SetShaping(bool shapeArabic)
+{
+    if(shapeArabic != m_shapeArabic)
+        m_entries.clear();
+    m_shapeArabic = shapeArabic;
+}
+
+void BidiCache::SetReordering(bool reorder)
+{
+    if(reorder != m_reorder)
+        m_entries.clear();
+    m_reorder = reorder;
+}
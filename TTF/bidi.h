@@ -0,0 +1,98 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Bidi_Class values the reordering tells apart, the explicit formatting characters are folded into BN
+enum BidiClass : uint8_t
+{
+    Bidi_L = 0,
+    Bidi_R,
+    Bidi_AL,
+    Bidi_EN,
+    Bidi_ES,
+    Bidi_ET,
+    Bidi_AN,
+    Bidi_CS,
+    Bidi_NSM,
+    Bidi_BN,
+    Bidi_B,
+    Bidi_S,
+    Bidi_WS,
+    Bidi_ON
+};
+
+BidiClass GetBidiClass(uint32_t utf32);
+// Looks at the encoded bytes only, false means the text can't hold a right-to-left character and draws in logical order
+bool MayNeedBidi(int encoding, const char* text, int len);
+
+// Scratch space of the reordering, kept so reordering doesn't allocate once it grew
+struct BidiBuffers
+{
+    std::vector<uint8_t> classes;
+    std::vector<uint8_t> levels;
+    std::vector<uint32_t> order;
+};
+
+// Unicode bidirectional algorithm for a single line: paragraph level from the first strong character (P2, P3),
+// weak and neutral types (W1 to W7, N1, N2), implicit levels (I1, I2), whitespace levels (L1), run reversal (L2) and
+// mirrored brackets in right-to-left runs (L4). Explicit embeddings and isolates and bracket pairs (N0) aren't applied.
+// visual receives the characters in the order they are drawn from left to right.
+void ReorderBidi(const uint32_t* characters, size_t count, BidiBuffers& buffers, std::vector<uint32_t>& visual);
+
+struct BidiCacheStats
+{
+    size_t lookups = 0;
+    size_t misses = 0;
+    size_t flushes = 0;
+};
+
+// Tells whether the font a string is drawn with has a glyph for a character
+typedef bool (*CharacterCoverage)(const void* font, uint32_t utf32);
+
+// Composed, shaped and visual order of every distinct string drawn, keyed by a hash of its bytes and the font so text
+// that stays on screen goes through the passes once. The whole cache is dropped when it holds more strings than it was made for.
+class BidiCache
+{
+    public:
+        explicit BidiCache(size_t maxEntries = 1024) : m_maxEntries(maxEntries) {}
+        BidiCache(const BidiCache&) = delete;
+        BidiCache& operator=(const BidiCache&) = delete;
+
+        // False when none of the passes turned on can change the text, it's drawn straight from its bytes then
+        bool IsNeeded(int encoding, const char* text, int len) const;
+        // The characters stay valid until the next Reorder or Clear call, marks only fold into the precomposed
+        // characters hasCharacter accepts for font, without it into every one
+        const std::vector<uint32_t>& Reorder(int encoding, const char* text, int len, const void* font = nullptr, CharacterCoverage hasCharacter = nullptr);
+        void Clear();
+        // Marks are composed with their base letter first, then Arabic letters are replaced by their presentation forms
+        // and last the line is put in visual order, each pass can be turned off
+        void SetComposition(bool composeMarks);
+        void SetShaping(bool shapeArabic);
+        void SetReordering(bool reorder);
+
+        const BidiCacheStats& GetStats() const {return m_stats;}
+        size_t GetEntryCount() const {return m_entries.size();}
+
+    private:
+        struct Entry
+        {
+            int encoding;
+            const void* font;
+            std::string text;
+            std::vector<uint32_t> visual;
+        };
+
+        size_t m_maxEntries;
+        bool m_composeMarks = true;
+        bool m_shapeArabic = true;
+        bool m_reorder = true;
+        std::unordered_map<uint64_t, Entry> m_entries;
+        std::vector<uint32_t> m_logical;
+        std::vector<uint32_t> m_composed;
+        std::vector<uint32_t> m_shaped;
+        BidiBuffers m_buffers;
+        BidiCacheStats m_stats;
+};
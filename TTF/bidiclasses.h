@@ -0,0 +1,150 @@
+#pragma once
+
+// Bidi_Class of everything above ASCII that isn't L, generated from the Unicode 14.0.0 character database
+// Unassigned code points between two ranges of the same class are folded into them, the explicit embedding,
+// override and isolate controls are stored as BN because ReorderBidi doesn't apply them
+static const BidiRange g_bidiRanges[] = {
+	{0x0080, 0x0084, Bidi_BN}, {0x0085, 0x0085, Bidi_B}, {0x0086, 0x009F, Bidi_BN}, {0x00A0, 0x00A0, Bidi_CS},
+	{0x00A1, 0x00A1, Bidi_ON}, {0x00A2, 0x00A5, Bidi_ET}, {0x00A6, 0x00A9, Bidi_ON}, {0x00AB, 0x00AC, Bidi_ON},
+	{0x00AD, 0x00AD, Bidi_BN}, {0x00AE, 0x00AF, Bidi_ON}, {0x00B0, 0x00B1, Bidi_ET}, {0x00B2, 0x00B3, Bidi_EN},
+	{0x00B4, 0x00B4, Bidi_ON}, {0x00B6, 0x00B8, Bidi_ON}, {0x00B9, 0x00B9, Bidi_EN}, {0x00BB, 0x00BF, Bidi_ON},
+	{0x00D7, 0x00D7, Bidi_ON}, {0x00F7, 0x00F7, Bidi_ON}, {0x02B9, 0x02BA, Bidi_ON}, {0x02C2, 0x02CF, Bidi_ON},
+	{0x02D2, 0x02DF, Bidi_ON}, {0x02E5, 0x02ED, Bidi_ON}, {0x02EF, 0x02FF, Bidi_ON}, {0x0300, 0x036F, Bidi_NSM},
+	{0x0374, 0x0375, Bidi_ON}, {0x037E, 0x037E, Bidi_ON}, {0x0384, 0x0385, Bidi_ON}, {0x0387, 0x0387, Bidi_ON},
+	{0x03F6, 0x03F6, Bidi_ON}, {0x0483, 0x0489, Bidi_NSM}, {0x058A, 0x058E, Bidi_ON}, {0x058F, 0x058F, Bidi_ET},
+	{0x0591, 0x05BD, Bidi_NSM}, {0x05BE, 0x05BE, Bidi_R}, {0x05BF, 0x05BF, Bidi_NSM}, {0x05C0, 0x05C0, Bidi_R},
+	{0x05C1, 0x05C2, Bidi_NSM}, {0x05C3, 0x05C3, Bidi_R}, {0x05C4, 0x05C5, Bidi_NSM}, {0x05C6, 0x05C6, Bidi_R},
+	{0x05C7, 0x05C7, Bidi_NSM}, {0x05D0, 0x05F4, Bidi_R}, {0x0600, 0x0605, Bidi_AN}, {0x0606, 0x0607, Bidi_ON},
+	{0x0608, 0x0608, Bidi_AL}, {0x0609, 0x060A, Bidi_ET}, {0x060B, 0x060B, Bidi_AL}, {0x060C, 0x060C, Bidi_CS},
+	{0x060D, 0x060D, Bidi_AL}, {0x060E, 0x060F, Bidi_ON}, {0x0610, 0x061A, Bidi_NSM}, {0x061B, 0x064A, Bidi_AL},
+	{0x064B, 0x065F, Bidi_NSM}, {0x0660, 0x0669, Bidi_AN}, {0x066A, 0x066A, Bidi_ET}, {0x066B, 0x066C, Bidi_AN},
+	{0x066D, 0x066F, Bidi_AL}, {0x0670, 0x0670, Bidi_NSM}, {0x0671, 0x06D5, Bidi_AL}, {0x06D6, 0x06DC, Bidi_NSM},
+	{0x06DD, 0x06DD, Bidi_AN}, {0x06DE, 0x06DE, Bidi_ON}, {0x06DF, 0x06E4, Bidi_NSM}, {0x06E5, 0x06E6, Bidi_AL},
+	{0x06E7, 0x06E8, Bidi_NSM}, {0x06E9, 0x06E9, Bidi_ON}, {0x06EA, 0x06ED, Bidi_NSM}, {0x06EE, 0x06EF, Bidi_AL},
+	{0x06F0, 0x06F9, Bidi_EN}, {0x06FA, 0x0710, Bidi_AL}, {0x0711, 0x0711, Bidi_NSM}, {0x0712, 0x072F, Bidi_AL},
+	{0x0730, 0x074A, Bidi_NSM}, {0x074D, 0x07A5, Bidi_AL}, {0x07A6, 0x07B0, Bidi_NSM}, {0x07B1, 0x07B1, Bidi_AL},
+	{0x07C0, 0x07EA, Bidi_R}, {0x07EB, 0x07F3, Bidi_NSM}, {0x07F4, 0x07F5, Bidi_R}, {0x07F6, 0x07F9, Bidi_ON},
+	{0x07FA, 0x07FA, Bidi_R}, {0x07FD, 0x07FD, Bidi_NSM}, {0x07FE, 0x0815, Bidi_R}, {0x0816, 0x0819, Bidi_NSM},
+	{0x081A, 0x081A, Bidi_R}, {0x081B, 0x0823, Bidi_NSM}, {0x0824, 0x0824, Bidi_R}, {0x0825, 0x0827, Bidi_NSM},
+	{0x0828, 0x0828, Bidi_R}, {0x0829, 0x082D, Bidi_NSM}, {0x0830, 0x0858, Bidi_R}, {0x0859, 0x085B, Bidi_NSM},
+	{0x085E, 0x085E, Bidi_R}, {0x0860, 0x088E, Bidi_AL}, {0x0890, 0x0891, Bidi_AN}, {0x0898, 0x089F, Bidi_NSM},
+	{0x08A0, 0x08C9, Bidi_AL}, {0x08CA, 0x08E1, Bidi_NSM}, {0x08E2, 0x08E2, Bidi_AN}, {0x08E3, 0x0902, Bidi_NSM},
+	{0x093A, 0x093A, Bidi_NSM}, {0x093C, 0x093C, Bidi_NSM}, {0x0941, 0x0948, Bidi_NSM}, {0x094D, 0x094D, Bidi_NSM},
+	{0x0951, 0x0957, Bidi_NSM}, {0x0962, 0x0963, Bidi_NSM}, {0x0981, 0x0981, Bidi_NSM}, {0x09BC, 0x09BC, Bidi_NSM},
+	{0x09C1, 0x09C4, Bidi_NSM}, {0x09CD, 0x09CD, Bidi_NSM}, {0x09E2, 0x09E3, Bidi_NSM}, {0x09F2, 0x09F3, Bidi_ET},
+	{0x09FB, 0x09FB, Bidi_ET}, {0x09FE, 0x0A02, Bidi_NSM}, {0x0A3C, 0x0A3C, Bidi_NSM}, {0x0A41, 0x0A51, Bidi_NSM},
+	{0x0A70, 0x0A71, Bidi_NSM}, {0x0A75, 0x0A75, Bidi_NSM}, {0x0A81, 0x0A82, Bidi_NSM}, {0x0ABC, 0x0ABC, Bidi_NSM},
+	{0x0AC1, 0x0AC8, Bidi_NSM}, {0x0ACD, 0x0ACD, Bidi_NSM}, {0x0AE2, 0x0AE3, Bidi_NSM}, {0x0AF1, 0x0AF1, Bidi_ET},
+	{0x0AFA, 0x0B01, Bidi_NSM}, {0x0B3C, 0x0B3C, Bidi_NSM}, {0x0B3F, 0x0B3F, Bidi_NSM}, {0x0B41, 0x0B44, Bidi_NSM},
+	{0x0B4D, 0x0B56, Bidi_NSM}, {0x0B62, 0x0B63, Bidi_NSM}, {0x0B82, 0x0B82, Bidi_NSM}, {0x0BC0, 0x0BC0, Bidi_NSM},
+	{0x0BCD, 0x0BCD, Bidi_NSM}, {0x0BF3, 0x0BF8, Bidi_ON}, {0x0BF9, 0x0BF9, Bidi_ET}, {0x0BFA, 0x0BFA, Bidi_ON},
+	{0x0C00, 0x0C00, Bidi_NSM}, {0x0C04, 0x0C04, Bidi_NSM}, {0x0C3C, 0x0C3C, Bidi_NSM}, {0x0C3E, 0x0C40, Bidi_NSM},
+	{0x0C46, 0x0C56, Bidi_NSM}, {0x0C62, 0x0C63, Bidi_NSM}, {0x0C78, 0x0C7E, Bidi_ON}, {0x0C81, 0x0C81, Bidi_NSM},
+	{0x0CBC, 0x0CBC, Bidi_NSM}, {0x0CCC, 0x0CCD, Bidi_NSM}, {0x0CE2, 0x0CE3, Bidi_NSM}, {0x0D00, 0x0D01, Bidi_NSM},
+	{0x0D3B, 0x0D3C, Bidi_NSM}, {0x0D41, 0x0D44, Bidi_NSM}, {0x0D4D, 0x0D4D, Bidi_NSM}, {0x0D62, 0x0D63, Bidi_NSM},
+	{0x0D81, 0x0D81, Bidi_NSM}, {0x0DCA, 0x0DCA, Bidi_NSM}, {0x0DD2, 0x0DD6, Bidi_NSM}, {0x0E31, 0x0E31, Bidi_NSM},
+	{0x0E34, 0x0E3A, Bidi_NSM}, {0x0E3F, 0x0E3F, Bidi_ET}, {0x0E47, 0x0E4E, Bidi_NSM}, {0x0EB1, 0x0EB1, Bidi_NSM},
+	{0x0EB4, 0x0EBC, Bidi_NSM}, {0x0EC8, 0x0ECD, Bidi_NSM}, {0x0F18, 0x0F19, Bidi_NSM}, {0x0F35, 0x0F35, Bidi_NSM},
+	{0x0F37, 0x0F37, Bidi_NSM}, {0x0F39, 0x0F39, Bidi_NSM}, {0x0F3A, 0x0F3D, Bidi_ON}, {0x0F71, 0x0F7E, Bidi_NSM},
+	{0x0F80, 0x0F84, Bidi_NSM}, {0x0F86, 0x0F87, Bidi_NSM}, {0x0F8D, 0x0FBC, Bidi_NSM}, {0x0FC6, 0x0FC6, Bidi_NSM},
+	{0x102D, 0x1030, Bidi_NSM}, {0x1032, 0x1037, Bidi_NSM}, {0x1039, 0x103A, Bidi_NSM}, {0x103D, 0x103E, Bidi_NSM},
+	{0x1058, 0x1059, Bidi_NSM}, {0x105E, 0x1060, Bidi_NSM}, {0x1071, 0x1074, Bidi_NSM}, {0x1082, 0x1082, Bidi_NSM},
+	{0x1085, 0x1086, Bidi_NSM}, {0x108D, 0x108D, Bidi_NSM}, {0x109D, 0x109D, Bidi_NSM}, {0x135D, 0x135F, Bidi_NSM},
+	{0x1390, 0x1399, Bidi_ON}, {0x1400, 0x1400, Bidi_ON}, {0x1680, 0x1680, Bidi_WS}, {0x169B, 0x169C, Bidi_ON},
+	{0x1712, 0x1714, Bidi_NSM}, {0x1732, 0x1733, Bidi_NSM}, {0x1752, 0x1753, Bidi_NSM}, {0x1772, 0x1773, Bidi_NSM},
+	{0x17B4, 0x17B5, Bidi_NSM}, {0x17B7, 0x17BD, Bidi_NSM}, {0x17C6, 0x17C6, Bidi_NSM}, {0x17C9, 0x17D3, Bidi_NSM},
+	{0x17DB, 0x17DB, Bidi_ET}, {0x17DD, 0x17DD, Bidi_NSM}, {0x17F0, 0x180A, Bidi_ON}, {0x180B, 0x180D, Bidi_NSM},
+	{0x180E, 0x180E, Bidi_BN}, {0x180F, 0x180F, Bidi_NSM}, {0x1885, 0x1886, Bidi_NSM}, {0x18A9, 0x18A9, Bidi_NSM},
+	{0x1920, 0x1922, Bidi_NSM}, {0x1927, 0x1928, Bidi_NSM}, {0x1932, 0x1932, Bidi_NSM}, {0x1939, 0x193B, Bidi_NSM},
+	{0x1940, 0x1945, Bidi_ON}, {0x19DE, 0x19FF, Bidi_ON}, {0x1A17, 0x1A18, Bidi_NSM}, {0x1A1B, 0x1A1B, Bidi_NSM},
+	{0x1A56, 0x1A56, Bidi_NSM}, {0x1A58, 0x1A60, Bidi_NSM}, {0x1A62, 0x1A62, Bidi_NSM}, {0x1A65, 0x1A6C, Bidi_NSM},
+	{0x1A73, 0x1A7F, Bidi_NSM}, {0x1AB0, 0x1B03, Bidi_NSM}, {0x1B34, 0x1B34, Bidi_NSM}, {0x1B36, 0x1B3A, Bidi_NSM},
+	{0x1B3C, 0x1B3C, Bidi_NSM}, {0x1B42, 0x1B42, Bidi_NSM}, {0x1B6B, 0x1B73, Bidi_NSM}, {0x1B80, 0x1B81, Bidi_NSM},
+	{0x1BA2, 0x1BA5, Bidi_NSM}, {0x1BA8, 0x1BA9, Bidi_NSM}, {0x1BAB, 0x1BAD, Bidi_NSM}, {0x1BE6, 0x1BE6, Bidi_NSM},
+	{0x1BE8, 0x1BE9, Bidi_NSM}, {0x1BED, 0x1BED, Bidi_NSM}, {0x1BEF, 0x1BF1, Bidi_NSM}, {0x1C2C, 0x1C33, Bidi_NSM},
+	{0x1C36, 0x1C37, Bidi_NSM}, {0x1CD0, 0x1CD2, Bidi_NSM}, {0x1CD4, 0x1CE0, Bidi_NSM}, {0x1CE2, 0x1CE8, Bidi_NSM},
+	{0x1CED, 0x1CED, Bidi_NSM}, {0x1CF4, 0x1CF4, Bidi_NSM}, {0x1CF8, 0x1CF9, Bidi_NSM}, {0x1DC0, 0x1DFF, Bidi_NSM},
+	{0x1FBD, 0x1FBD, Bidi_ON}, {0x1FBF, 0x1FC1, Bidi_ON}, {0x1FCD, 0x1FCF, Bidi_ON}, {0x1FDD, 0x1FDF, Bidi_ON},
+	{0x1FED, 0x1FEF, Bidi_ON}, {0x1FFD, 0x1FFE, Bidi_ON}, {0x2000, 0x200A, Bidi_WS}, {0x200B, 0x200D, Bidi_BN},
+	{0x200F, 0x200F, Bidi_R}, {0x2010, 0x2027, Bidi_ON}, {0x2028, 0x2028, Bidi_WS}, {0x2029, 0x2029, Bidi_B},
+	{0x202A, 0x202E, Bidi_BN}, {0x202F, 0x202F, Bidi_CS}, {0x2030, 0x2034, Bidi_ET}, {0x2035, 0x2043, Bidi_ON},
+	{0x2044, 0x2044, Bidi_CS}, {0x2045, 0x205E, Bidi_ON}, {0x205F, 0x205F, Bidi_WS}, {0x2060, 0x206F, Bidi_BN},
+	{0x2070, 0x2070, Bidi_EN}, {0x2074, 0x2079, Bidi_EN}, {0x207A, 0x207B, Bidi_ES}, {0x207C, 0x207E, Bidi_ON},
+	{0x2080, 0x2089, Bidi_EN}, {0x208A, 0x208B, Bidi_ES}, {0x208C, 0x208E, Bidi_ON}, {0x20A0, 0x20C0, Bidi_ET},
+	{0x20D0, 0x20F0, Bidi_NSM}, {0x2100, 0x2101, Bidi_ON}, {0x2103, 0x2106, Bidi_ON}, {0x2108, 0x2109, Bidi_ON},
+	{0x2114, 0x2114, Bidi_ON}, {0x2116, 0x2118, Bidi_ON}, {0x211E, 0x2123, Bidi_ON}, {0x2125, 0x2125, Bidi_ON},
+	{0x2127, 0x2127, Bidi_ON}, {0x2129, 0x2129, Bidi_ON}, {0x212E, 0x212E, Bidi_ET}, {0x213A, 0x213B, Bidi_ON},
+	{0x2140, 0x2144, Bidi_ON}, {0x214A, 0x214D, Bidi_ON}, {0x2150, 0x215F, Bidi_ON}, {0x2189, 0x2211, Bidi_ON},
+	{0x2212, 0x2212, Bidi_ES}, {0x2213, 0x2213, Bidi_ET}, {0x2214, 0x2335, Bidi_ON}, {0x237B, 0x2394, Bidi_ON},
+	{0x2396, 0x2487, Bidi_ON}, {0x2488, 0x249B, Bidi_EN}, {0x24EA, 0x26AB, Bidi_ON}, {0x26AD, 0x27FF, Bidi_ON},
+	{0x2900, 0x2BFF, Bidi_ON}, {0x2CE5, 0x2CEA, Bidi_ON}, {0x2CEF, 0x2CF1, Bidi_NSM}, {0x2CF9, 0x2CFF, Bidi_ON},
+	{0x2D7F, 0x2D7F, Bidi_NSM}, {0x2DE0, 0x2DFF, Bidi_NSM}, {0x2E00, 0x2FFB, Bidi_ON}, {0x3000, 0x3000, Bidi_WS},
+	{0x3001, 0x3004, Bidi_ON}, {0x3008, 0x3020, Bidi_ON}, {0x302A, 0x302D, Bidi_NSM}, {0x3030, 0x3030, Bidi_ON},
+	{0x3036, 0x3037, Bidi_ON}, {0x303D, 0x303F, Bidi_ON}, {0x3099, 0x309A, Bidi_NSM}, {0x309B, 0x309C, Bidi_ON},
+	{0x30A0, 0x30A0, Bidi_ON}, {0x30FB, 0x30FB, Bidi_ON}, {0x31C0, 0x31E3, Bidi_ON}, {0x321D, 0x321E, Bidi_ON},
+	{0x3250, 0x325F, Bidi_ON}, {0x327C, 0x327E, Bidi_ON}, {0x32B1, 0x32BF, Bidi_ON}, {0x32CC, 0x32CF, Bidi_ON},
+	{0x3377, 0x337A, Bidi_ON}, {0x33DE, 0x33DF, Bidi_ON}, {0x33FF, 0x33FF, Bidi_ON}, {0x4DC0, 0x4DFF, Bidi_ON},
+	{0xA490, 0xA4C6, Bidi_ON}, {0xA60D, 0xA60F, Bidi_ON}, {0xA66F, 0xA672, Bidi_NSM}, {0xA673, 0xA673, Bidi_ON},
+	{0xA674, 0xA67D, Bidi_NSM}, {0xA67E, 0xA67F, Bidi_ON}, {0xA69E, 0xA69F, Bidi_NSM}, {0xA6F0, 0xA6F1, Bidi_NSM},
+	{0xA700, 0xA721, Bidi_ON}, {0xA788, 0xA788, Bidi_ON}, {0xA802, 0xA802, Bidi_NSM}, {0xA806, 0xA806, Bidi_NSM},
+	{0xA80B, 0xA80B, Bidi_NSM}, {0xA825, 0xA826, Bidi_NSM}, {0xA828, 0xA82B, Bidi_ON}, {0xA82C, 0xA82C, Bidi_NSM},
+	{0xA838, 0xA839, Bidi_ET}, {0xA874, 0xA877, Bidi_ON}, {0xA8C4, 0xA8C5, Bidi_NSM}, {0xA8E0, 0xA8F1, Bidi_NSM},
+	{0xA8FF, 0xA8FF, Bidi_NSM}, {0xA926, 0xA92D, Bidi_NSM}, {0xA947, 0xA951, Bidi_NSM}, {0xA980, 0xA982, Bidi_NSM},
+	{0xA9B3, 0xA9B3, Bidi_NSM}, {0xA9B6, 0xA9B9, Bidi_NSM}, {0xA9BC, 0xA9BD, Bidi_NSM}, {0xA9E5, 0xA9E5, Bidi_NSM},
+	{0xAA29, 0xAA2E, Bidi_NSM}, {0xAA31, 0xAA32, Bidi_NSM}, {0xAA35, 0xAA36, Bidi_NSM}, {0xAA43, 0xAA43, Bidi_NSM},
+	{0xAA4C, 0xAA4C, Bidi_NSM}, {0xAA7C, 0xAA7C, Bidi_NSM}, {0xAAB0, 0xAAB0, Bidi_NSM}, {0xAAB2, 0xAAB4, Bidi_NSM},
+	{0xAAB7, 0xAAB8, Bidi_NSM}, {0xAABE, 0xAABF, Bidi_NSM}, {0xAAC1, 0xAAC1, Bidi_NSM}, {0xAAEC, 0xAAED, Bidi_NSM},
+	{0xAAF6, 0xAAF6, Bidi_NSM}, {0xAB6A, 0xAB6B, Bidi_ON}, {0xABE5, 0xABE5, Bidi_NSM}, {0xABE8, 0xABE8, Bidi_NSM},
+	{0xABED, 0xABED, Bidi_NSM}, {0xFB1D, 0xFB1D, Bidi_R}, {0xFB1E, 0xFB1E, Bidi_NSM}, {0xFB1F, 0xFB28, Bidi_R},
+	{0xFB29, 0xFB29, Bidi_ES}, {0xFB2A, 0xFB4F, Bidi_R}, {0xFB50, 0xFD3D, Bidi_AL}, {0xFD3E, 0xFD4F, Bidi_ON},
+	{0xFD50, 0xFDC7, Bidi_AL}, {0xFDCF, 0xFDCF, Bidi_ON}, {0xFDF0, 0xFDFC, Bidi_AL}, {0xFDFD, 0xFDFF, Bidi_ON},
+	{0xFE00, 0xFE0F, Bidi_NSM}, {0xFE10, 0xFE19, Bidi_ON}, {0xFE20, 0xFE2F, Bidi_NSM}, {0xFE30, 0xFE4F, Bidi_ON},
+	{0xFE50, 0xFE50, Bidi_CS}, {0xFE51, 0xFE51, Bidi_ON}, {0xFE52, 0xFE52, Bidi_CS}, {0xFE54, 0xFE54, Bidi_ON},
+	{0xFE55, 0xFE55, Bidi_CS}, {0xFE56, 0xFE5E, Bidi_ON}, {0xFE5F, 0xFE5F, Bidi_ET}, {0xFE60, 0xFE61, Bidi_ON},
+	{0xFE62, 0xFE63, Bidi_ES}, {0xFE64, 0xFE68, Bidi_ON}, {0xFE69, 0xFE6A, Bidi_ET}, {0xFE6B, 0xFE6B, Bidi_ON},
+	{0xFE70, 0xFEFC, Bidi_AL}, {0xFEFF, 0xFEFF, Bidi_BN}, {0xFF01, 0xFF02, Bidi_ON}, {0xFF03, 0xFF05, Bidi_ET},
+	{0xFF06, 0xFF0A, Bidi_ON}, {0xFF0B, 0xFF0B, Bidi_ES}, {0xFF0C, 0xFF0C, Bidi_CS}, {0xFF0D, 0xFF0D, Bidi_ES},
+	{0xFF0E, 0xFF0F, Bidi_CS}, {0xFF10, 0xFF19, Bidi_EN}, {0xFF1A, 0xFF1A, Bidi_CS}, {0xFF1B, 0xFF20, Bidi_ON},
+	{0xFF3B, 0xFF40, Bidi_ON}, {0xFF5B, 0xFF65, Bidi_ON}, {0xFFE0, 0xFFE1, Bidi_ET}, {0xFFE2, 0xFFE4, Bidi_ON},
+	{0xFFE5, 0xFFE6, Bidi_ET}, {0xFFE8, 0xFFFD, Bidi_ON}, {0x10101, 0x10101, Bidi_ON}, {0x10140, 0x1018C, Bidi_ON},
+	{0x10190, 0x101A0, Bidi_ON}, {0x101FD, 0x101FD, Bidi_NSM}, {0x102E0, 0x102E0, Bidi_NSM}, {0x102E1, 0x102FB, Bidi_EN},
+	{0x10376, 0x1037A, Bidi_NSM}, {0x10800, 0x1091B, Bidi_R}, {0x1091F, 0x1091F, Bidi_ON}, {0x10920, 0x10A00, Bidi_R},
+	{0x10A01, 0x10A0F, Bidi_NSM}, {0x10A10, 0x10A35, Bidi_R}, {0x10A38, 0x10A3F, Bidi_NSM}, {0x10A40, 0x10AE4, Bidi_R},
+	{0x10AE5, 0x10AE6, Bidi_NSM}, {0x10AEB, 0x10B35, Bidi_R}, {0x10B39, 0x10B3F, Bidi_ON}, {0x10B40, 0x10CFF, Bidi_R},
+	{0x10D00, 0x10D23, Bidi_AL}, {0x10D24, 0x10D27, Bidi_NSM}, {0x10D30, 0x10E7E, Bidi_AN}, {0x10E80, 0x10EA9, Bidi_R},
+	{0x10EAB, 0x10EAC, Bidi_NSM}, {0x10EAD, 0x10F27, Bidi_R}, {0x10F30, 0x10F45, Bidi_AL}, {0x10F46, 0x10F50, Bidi_NSM},
+	{0x10F51, 0x10F59, Bidi_AL}, {0x10F70, 0x10F81, Bidi_R}, {0x10F82, 0x10F85, Bidi_NSM}, {0x10F86, 0x10FF6, Bidi_R},
+	{0x11001, 0x11001, Bidi_NSM}, {0x11038, 0x11046, Bidi_NSM}, {0x11052, 0x11065, Bidi_ON}, {0x11070, 0x11070, Bidi_NSM},
+	{0x11073, 0x11074, Bidi_NSM}, {0x1107F, 0x11081, Bidi_NSM}, {0x110B3, 0x110B6, Bidi_NSM}, {0x110B9, 0x110BA, Bidi_NSM},
+	{0x110C2, 0x110C2, Bidi_NSM}, {0x11100, 0x11102, Bidi_NSM}, {0x11127, 0x1112B, Bidi_NSM}, {0x1112D, 0x11134, Bidi_NSM},
+	{0x11173, 0x11173, Bidi_NSM}, {0x11180, 0x11181, Bidi_NSM}, {0x111B6, 0x111BE, Bidi_NSM}, {0x111C9, 0x111CC, Bidi_NSM},
+	{0x111CF, 0x111CF, Bidi_NSM}, {0x1122F, 0x11231, Bidi_NSM}, {0x11234, 0x11234, Bidi_NSM}, {0x11236, 0x11237, Bidi_NSM},
+	{0x1123E, 0x1123E, Bidi_NSM}, {0x112DF, 0x112DF, Bidi_NSM}, {0x112E3, 0x112EA, Bidi_NSM}, {0x11300, 0x11301, Bidi_NSM},
+	{0x1133B, 0x1133C, Bidi_NSM}, {0x11340, 0x11340, Bidi_NSM}, {0x11366, 0x11374, Bidi_NSM}, {0x11438, 0x1143F, Bidi_NSM},
+	{0x11442, 0x11444, Bidi_NSM}, {0x11446, 0x11446, Bidi_NSM}, {0x1145E, 0x1145E, Bidi_NSM}, {0x114B3, 0x114B8, Bidi_NSM},
+	{0x114BA, 0x114BA, Bidi_NSM}, {0x114BF, 0x114C0, Bidi_NSM}, {0x114C2, 0x114C3, Bidi_NSM}, {0x115B2, 0x115B5, Bidi_NSM},
+	{0x115BC, 0x115BD, Bidi_NSM}, {0x115BF, 0x115C0, Bidi_NSM}, {0x115DC, 0x115DD, Bidi_NSM}, {0x11633, 0x1163A, Bidi_NSM},
+	{0x1163D, 0x1163D, Bidi_NSM}, {0x1163F, 0x11640, Bidi_NSM}, {0x11660, 0x1166C, Bidi_ON}, {0x116AB, 0x116AB, Bidi_NSM},
+	{0x116AD, 0x116AD, Bidi_NSM}, {0x116B0, 0x116B5, Bidi_NSM}, {0x116B7, 0x116B7, Bidi_NSM}, {0x1171D, 0x1171F, Bidi_NSM},
+	{0x11722, 0x11725, Bidi_NSM}, {0x11727, 0x1172B, Bidi_NSM}, {0x1182F, 0x11837, Bidi_NSM}, {0x11839, 0x1183A, Bidi_NSM},
+	{0x1193B, 0x1193C, Bidi_NSM}, {0x1193E, 0x1193E, Bidi_NSM}, {0x11943, 0x11943, Bidi_NSM}, {0x119D4, 0x119DB, Bidi_NSM},
+	{0x119E0, 0x119E0, Bidi_NSM}, {0x11A01, 0x11A06, Bidi_NSM}, {0x11A09, 0x11A0A, Bidi_NSM}, {0x11A33, 0x11A38, Bidi_NSM},
+	{0x11A3B, 0x11A3E, Bidi_NSM}, {0x11A47, 0x11A47, Bidi_NSM}, {0x11A51, 0x11A56, Bidi_NSM}, {0x11A59, 0x11A5B, Bidi_NSM},
+	{0x11A8A, 0x11A96, Bidi_NSM}, {0x11A98, 0x11A99, Bidi_NSM}, {0x11C30, 0x11C3D, Bidi_NSM}, {0x11C92, 0x11CA7, Bidi_NSM},
+	{0x11CAA, 0x11CB0, Bidi_NSM}, {0x11CB2, 0x11CB3, Bidi_NSM}, {0x11CB5, 0x11CB6, Bidi_NSM}, {0x11D31, 0x11D45, Bidi_NSM},
+	{0x11D47, 0x11D47, Bidi_NSM}, {0x11D90, 0x11D91, Bidi_NSM}, {0x11D95, 0x11D95, Bidi_NSM}, {0x11D97, 0x11D97, Bidi_NSM},
+	{0x11EF3, 0x11EF4, Bidi_NSM}, {0x11FD5, 0x11FDC, Bidi_ON}, {0x11FDD, 0x11FE0, Bidi_ET}, {0x11FE1, 0x11FF1, Bidi_ON},
+	{0x16AF0, 0x16AF4, Bidi_NSM}, {0x16B30, 0x16B36, Bidi_NSM}, {0x16F4F, 0x16F4F, Bidi_NSM}, {0x16F8F, 0x16F92, Bidi_NSM},
+	{0x16FE2, 0x16FE2, Bidi_ON}, {0x16FE4, 0x16FE4, Bidi_NSM}, {0x1BC9D, 0x1BC9E, Bidi_NSM}, {0x1BCA0, 0x1BCA3, Bidi_BN},
+	{0x1CF00, 0x1CF46, Bidi_NSM}, {0x1D167, 0x1D169, Bidi_NSM}, {0x1D173, 0x1D17A, Bidi_BN}, {0x1D17B, 0x1D182, Bidi_NSM},
+	{0x1D185, 0x1D18B, Bidi_NSM}, {0x1D1AA, 0x1D1AD, Bidi_NSM}, {0x1D1E9, 0x1D241, Bidi_ON}, {0x1D242, 0x1D244, Bidi_NSM},
+	{0x1D245, 0x1D245, Bidi_ON}, {0x1D300, 0x1D356, Bidi_ON}, {0x1D6DB, 0x1D6DB, Bidi_ON}, {0x1D715, 0x1D715, Bidi_ON},
+	{0x1D74F, 0x1D74F, Bidi_ON}, {0x1D789, 0x1D789, Bidi_ON}, {0x1D7C3, 0x1D7C3, Bidi_ON}, {0x1D7CE, 0x1D7FF, Bidi_EN},
+	{0x1DA00, 0x1DA36, Bidi_NSM}, {0x1DA3B, 0x1DA6C, Bidi_NSM}, {0x1DA75, 0x1DA75, Bidi_NSM}, {0x1DA84, 0x1DA84, Bidi_NSM},
+	{0x1DA9B, 0x1DAAF, Bidi_NSM}, {0x1E000, 0x1E02A, Bidi_NSM}, {0x1E130, 0x1E136, Bidi_NSM}, {0x1E2AE, 0x1E2AE, Bidi_NSM},
+	{0x1E2EC, 0x1E2EF, Bidi_NSM}, {0x1E2FF, 0x1E2FF, Bidi_ET}, {0x1E800, 0x1E8CF, Bidi_R}, {0x1E8D0, 0x1E8D6, Bidi_NSM},
+	{0x1E900, 0x1E943, Bidi_R}, {0x1E944, 0x1E94A, Bidi_NSM}, {0x1E94B, 0x1E95F, Bidi_R}, {0x1EC71, 0x1EEBB, Bidi_AL},
+	{0x1EEF0, 0x1F0F5, Bidi_ON}, {0x1F100, 0x1F10A, Bidi_EN}, {0x1F10B, 0x1F10F, Bidi_ON}, {0x1F12F, 0x1F12F, Bidi_ON},
+	{0x1F16A, 0x1F16F, Bidi_ON}, {0x1F1AD, 0x1F1AD, Bidi_ON}, {0x1F260, 0x1FBCA, Bidi_ON}, {0x1FBF0, 0x1FBF9, Bidi_EN},
+	{0xE0001, 0xE007F, Bidi_BN}, {0xE0100, 0xE01EF, Bidi_NSM},
+};
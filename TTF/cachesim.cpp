@@ -0,0 +1,195 @@
+#include "cachesim.h"
+#include "glyphatlas.h"
+
+#include <stdio.h>
+#include <list>
+#include <unordered_map>
+
+static const char* GetFormatName(GlyphTextureFormat format)
+{
+    switch(format)
+    {
+        case GlyphFormat_A8L8: return "A8L8";
+        default: return "BGRA";
+    }
+}
+
+static unsigned int GetPowerOf2(unsigned int input)
+{
+    unsigned int value = 1;
+    while(value < input) value <<= 1;
+    return value;
+}
+
+void GetDefaultCachePolicies(std::vector<CachePolicy>& policies)
+{
+    static const GlyphTextureFormat formats[] = {GlyphFormat_BGRA8888, GlyphFormat_A8L8};
+    static const unsigned int pageSizes[] = {0, 256, 512, 1024};
+    static const size_t budgets[] = {0, 512 * 1024, 2048 * 1024};
+
+    policies.clear();
+    for(unsigned int pageSize : pageSizes)
+    {
+        for(GlyphTextureFormat format : formats)
+        {
+            for(size_t budget : budgets)
+            {
+                std::string name = (pageSize == 0 ? std::string("glyph") : "atlas" + std::to_string(pageSize));
+                name += "_";
+                name += GetFormatName(format);
+                if(budget != 0)
+                    name += "_lru" + std::to_string(budget / 1024);
+                policies.push_back({name, pageSize, budget, format});
+            }
+        }
+    }
+}
+
+class GlyphCacheSim
+{
+    public:
+        GlyphCacheSim(const CachePolicy& policy, CacheSimResult& result) : m_policy(policy), m_result(result),
+            m_texelSize(GetGlyphTexelSize(policy.format))
+        {
+            m_atlas.SetPageSize(policy.pageSize);
+            m_pageBytes = static_cast<size_t>(m_atlas.GetPageSize()) * m_atlas.GetPageSize() * m_texelSize;
+        }
+
+        void Request(const GlyphRequest& request)
+        {
+            ++m_result.requests;
+            uint64_t key = (static_cast<uint64_t>(request.font) << 32) | request.codepoint;
+            auto it = m_entries.find(key);
+            if(it != m_entries.end())
+            {
+                m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+                return;
+            }
+
+            ++m_result.misses;
+            Entry entry;
+            entry.glyphBytes = static_cast<size_t>(request.width) * request.rows * m_texelSize;
+            if(!Place(request, entry))
+                return;
+
+            m_lru.push_front(key);
+            entry.lru = m_lru.begin();
+            m_entries.emplace(key, entry);
+            m_result.glyphBytes += entry.glyphBytes;
+            if(m_result.bytes > m_result.peakBytes)
+                m_result.peakBytes = m_result.bytes;
+        }
+
+        void Finish()
+        {
+            m_result.pages = 0;
+            for(size_t i = 0; i < m_atlas.GetPageCount(); ++i)
+                m_result.pages += (m_atlas.IsPageUsed(static_cast<int>(i)) ? 1 : 0);
+        }
+
+    private:
+        struct Entry
+        {
+            std::list<uint64_t>::iterator lru;
+            int page;
+            AtlasRect rect;
+            size_t bytes;
+            size_t glyphBytes;
+        };
+
+        bool IsOverBudget(size_t bytes) const
+        {
+            return (m_policy.budget != 0 && m_result.bytes + bytes > m_policy.budget);
+        }
+
+        bool EvictOldest()
+        {
+            if(m_lru.empty())
+                return false;
+
+            auto it = m_entries.find(m_lru.back());
+            const Entry& entry = it->second;
+            m_result.bytes -= entry.bytes;
+            m_result.glyphBytes -= entry.glyphBytes;
+            if(entry.page >= 0)
+            {
+                m_atlas.Free(entry.page, entry.rect);
+                if(!m_atlas.IsPageUsed(entry.page))
+                    m_result.bytes -= m_pageBytes;
+            }
+            m_entries.erase(it);
+            m_lru.pop_back();
+            ++m_result.evictions;
+            return true;
+        }
+
+        bool Place(const GlyphRequest& request, Entry& entry)
+        {
+            entry.page = -1;
+            entry.bytes = 0;
+            if(!m_atlas.Fits(request.width, request.rows))
+            {
+                // Glyphs too big for a page fall back to a surface of their own like the plugin does today
+                entry.bytes = static_cast<size_t>(GetPowerOf2(request.width)) * GetPowerOf2(request.rows) * m_texelSize;
+                while(IsOverBudget(entry.bytes) && EvictOldest()) {}
+                m_result.bytes += entry.bytes;
+                return true;
+            }
+
+            for(;;)
+            {
+                entry.page = m_atlas.Allocate(request.width, request.rows, entry.rect);
+                if(entry.page >= 0)
+                    return true;
+
+                // A new page only gets opened when it fits the budget or nothing is left to evict
+                if(!IsOverBudget(m_pageBytes) || !EvictOldest())
+                    break;
+            }
+
+            m_atlas.ReservePage();
+            entry.page = m_atlas.Allocate(request.width, request.rows, entry.rect);
+            m_result.bytes += m_pageBytes;
+            return true;
+        }
+
+        const CachePolicy& m_policy;
+        CacheSimResult& m_result;
+        unsigned int m_texelSize;
+        size_t m_pageBytes;
+        GlyphAtlas m_atlas;
+        std::list<uint64_t> m_lru;
+        std::unordered_map<uint64_t, Entry> m_entries;
+};
+
+void SimulateGlyphCache(const CachePolicy& policy, const std::vector<GlyphRequest>& requests, CacheSimResult& result)
+{
+    result = CacheSimResult();
+    GlyphCacheSim sim(policy, result);
+    for(const GlyphRequest& request : requests)
+        sim.Request(request);
+    sim.Finish();
+}
+
+bool WriteCacheSimulation(const char* reportPath, const std::vector<CachePolicy>& policies, const std::vector<GlyphRequest>& requests)
+{
+    FILE* f = fopen(reportPath, "w");
+    if(!f)
+        return false;
+
+    fprintf(f, "policy,format,page_size,budget_kb,requests,misses,miss_rate,evictions,pages,peak_kb,final_kb,packing_efficiency\n");
+    for(const CachePolicy& policy : policies)
+    {
+        CacheSimResult result;
+        SimulateGlyphCache(policy, requests, result);
+
+        double missRate = (result.requests ? static_cast<double>(result.misses) / result.requests : 0.0);
+        double efficiency = (result.bytes ? static_cast<double>(result.glyphBytes) / result.bytes : 0.0);
+        fprintf(f, "%s,%s,%u,%u,%u,%u,%.4f,%u,%u,%.1f,%.1f,%.4f\n", policy.name.c_str(), GetFormatName(policy.format), policy.pageSize,
+            static_cast<unsigned int>(policy.budget / 1024), static_cast<unsigned int>(result.requests), static_cast<unsigned int>(result.misses),
+            missRate, static_cast<unsigned int>(result.evictions), static_cast<unsigned int>(result.pages), result.peakBytes / 1024.0,
+            result.bytes / 1024.0, efficiency);
+    }
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "glyphconvert.h"
+
+// What-if simulation of the glyph texture cache under different page sizes, budgets and texture formats
+// The per-glyph policy mirrors the plugin's surfaces, atlas policies use the same packer as atlas pages
+struct CachePolicy
+{
+    std::string name;
+    // 0 gives every glyph its own power of two surface
+    unsigned int pageSize;
+    // Least recently used glyphs get evicted above this many bytes, 0 never evicts
+    size_t budget;
+    GlyphTextureFormat format;
+};
+
+struct GlyphRequest
+{
+    uint32_t font;
+    uint32_t codepoint;
+    unsigned int width, rows;
+};
+
+struct CacheSimResult
+{
+    size_t requests = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t pages = 0;
+    size_t peakBytes = 0;
+    size_t bytes = 0;
+    size_t glyphBytes = 0;
+};
+
+void GetDefaultCachePolicies(std::vector<CachePolicy>& policies);
+void SimulateGlyphCache(const CachePolicy& policy, const std::vector<GlyphRequest>& requests, CacheSimResult& result);
+
+// Writes one CSV row per policy
+bool WriteCacheSimulation(const char* reportPath, const std::vector<CachePolicy>& policies, const std::vector<GlyphRequest>& requests);
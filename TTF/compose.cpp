@@ -0,0 +1,119 @@
+#include "compose.h"
+
+#include <algorithm>
+
+struct CompositionPair
+{
+    uint16_t first;
+    uint16_t second;
+    uint16_t composite;
+};
+
+struct CombiningRange
+{
+    uint16_t first;
+    uint16_t last;
+    uint8_t combiningClass;
+};
+
+#include "composition.h"
+
+uint8_t GetCombiningClass(uint32_t utf32)
+{
+    if(utf32 < g_combiningRanges[0].first || utf32 > 0xFFFF)
+        return 0;
+
+    const CombiningRange* end = g_combiningRanges + sizeof(g_combiningRanges) / sizeof(g_combiningRanges[0]);
+    const CombiningRange* it = std::upper_bound(g_combiningRanges, end, utf32, [](uint32_t value, const CombiningRange& range)
+    {
+        return value < range.first;
+    });
+    if(utf32 <= (it - 1)->last)
+        return (it - 1)->combiningClass;
+    return 0;
+}
+
+uint32_t ComposePair(uint32_t first, uint32_t second)
+{
+    if(first > 0xFFFF || second > 0xFFFF)
+        return 0;
+
+    const CompositionPair* end = g_compositionPairs + sizeof(g_compositionPairs) / sizeof(g_compositionPairs[0]);
+    const CompositionPair* it = std::lower_bound(g_compositionPairs, end, std::make_pair(first, second), [](const CompositionPair& pair, const std::pair<uint32_t, uint32_t>& value)
+    {
+        return (pair.first != value.first ? pair.first < value.first : pair.second < value.second);
+    });
+    return ((it != end && it->first == first && it->second == second) ? it->composite : 0);
+}
+
+void DecomposeCharacter(uint32_t utf32, std::vector<uint32_t>& characters)
+{
+    if(utf32 <= 0xFFFF)
+    {
+        const uint16_t* end = g_compositesByValue + sizeof(g_compositesByValue) / sizeof(g_compositesByValue[0]);
+        const uint16_t* it = std::lower_bound(g_compositesByValue, end, utf32, [](uint16_t index, uint32_t value)
+        {
+            return g_compositionPairs[index].composite < value;
+        });
+        if(it != end && g_compositionPairs[*it].composite == utf32)
+        {
+            // Only the first character of a pair can be a composite itself
+            DecomposeCharacter(g_compositionPairs[*it].first, characters);
+            characters.push_back(g_compositionPairs[*it].second);
+            return;
+        }
+    }
+    characters.push_back(utf32);
+}
+
+void SortMarks(uint32_t* characters, size_t count)
+{
+    // Insertion sort, runs of marks are a few characters long
+    for(size_t i = 1; i < count; ++i)
+    {
+        uint32_t utf32 = characters[i];
+        uint8_t combiningClass = GetCombiningClass(utf32);
+        if(combiningClass == 0)
+            continue;
+
+        size_t j = i;
+        while(j > 0 && GetCombiningClass(characters[j - 1]) > combiningClass)
+        {
+            characters[j] = characters[j - 1];
+            --j;
+        }
+        characters[j] = utf32;
+    }
+}
+
+bool MayNeedComposition(int encoding, const char* text, int len)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(text);
+    // Windows-1258 stores the Vietnamese tone marks as combining grave, hook above, tilde, acute and dot below
+    if(encoding == 1258)
+    {
+        for(int i = 0; i < len; ++i)
+        {
+            if(bytes[i] == 0xCC || bytes[i] == 0xD2 || bytes[i] == 0xDE || bytes[i] == 0xEC || bytes[i] == 0xF2)
+                return true;
+        }
+        return false;
+    }
+    if(encoding >= 1250 && encoding <= 1257)
+        return false;
+
+    // UTF-8 lead bytes of the combining diacritical marks, the Arabic madda and hamza marks and the kana voicing marks
+    for(int i = 0; i < len; ++i)
+    {
+        unsigned char lead = bytes[i];
+        if(lead < 0xCC)
+            continue;
+        if(lead <= 0xCD)
+            return true;
+        if(i + 1 < len && lead == 0xD9 && bytes[i + 1] >= 0x93 && bytes[i + 1] <= 0x95)
+            return true;
+        if(i + 2 < len && lead == 0xE3 && bytes[i + 1] == 0x82 && (bytes[i + 2] == 0x99 || bytes[i + 2] == 0x9A))
+            return true;
+    }
+    return false;
+}
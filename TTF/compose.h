@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+uint8_t GetCombiningClass(uint32_t utf32);
+// Precomposed character of a base and a following character, 0 when the pair has no canonical composition
+uint32_t ComposePair(uint32_t first, uint32_t second);
+// Appends the canonical decomposition of a primary composite, anything else is appended unchanged
+void DecomposeCharacter(uint32_t utf32, std::vector<uint32_t>& characters);
+// Canonical ordering, every run of marks is sorted by combining class keeping marks of the same class in order
+void SortMarks(uint32_t* characters, size_t count);
+// Looks at the encoded bytes only, false means the text holds no mark ComposeCharacters would fold into a letter
+bool MayNeedComposition(int encoding, const char* text, int len);
+
+// NFC of a decoded line for drawing. Only letters followed by a mark get decomposed, so Windows-1258 letters like
+// U+00E2 still pick up a dot below they have to be composed with before their circumflex. A mark joins the last
+// base before it unless a mark in between has the same or a higher combining class. Composites hasCharacter(utf32)
+// turns down stay decomposed so fonts without the precomposed letters keep drawing the base and the mark.
+template<typename HasCharacter>
+void ComposeCharacters(const uint32_t* characters, size_t count, std::vector<uint32_t>& composed, HasCharacter hasCharacter)
+{
+    composed.clear();
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(i + 1 < count && GetCombiningClass(characters[i + 1]) != 0)
+            DecomposeCharacter(characters[i], composed);
+        else
+            composed.push_back(characters[i]);
+    }
+    SortMarks(composed.data(), composed.size());
+
+    // Composes in place, a character never moves behind where it was read from
+    size_t starter = SIZE_MAX, length = 0;
+    uint8_t lastClass = 0;
+    for(size_t i = 0; i < composed.size(); ++i)
+    {
+        uint32_t utf32 = composed[i];
+        uint8_t combiningClass = GetCombiningClass(utf32);
+        if(starter != SIZE_MAX && (starter + 1 == length || (lastClass != 0 && lastClass < combiningClass)))
+        {
+            uint32_t composite = ComposePair(composed[starter], utf32);
+            if(composite && hasCharacter(composite))
+            {
+                composed[starter] = composite;
+                continue;
+            }
+        }
+        if(combiningClass == 0)
+            starter = length;
+        lastClass = combiningClass;
+        composed[length++] = utf32;
+    }
+    composed.resize(length);
+}
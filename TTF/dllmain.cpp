@@ -2,869 +2,584 @@
 // Project (www.freetype.org).  All rights reserved.
 
 #include "hook.h"
+#include "log.h"
+#include "ftmemory.h"
+#include "glyphconvert.h"
+#include "facecache.h"
+#include "textcore.h"
+#include "textstats.h"
+#include "texturetracker.h"
+#include "texttrace.h"
+#include "profiler.h"
+#include "hitchreport.h"
+#include "alloctracker.h"
+#include "glyphusage.h"
+#include "telemetry.h"
+#include "renderbackend.h"
+#include "textbatch.h"
+#include "ttfapi.h"
+#include "glyphcache.h"
+#include "enginetext.h"
+#include "textapi.h"
 #include "detours.h"
 #include "zSTRING.h"
-#include "codepages.h"
+#include "gametraits.h"
 
 #include <stdint.h>
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
 #include <string>
+#include <vector>
 #include <tuple>
 
 #include <shlwapi.h>
+#include <psapi.h>
 #include <ddraw.h>
 #include <d3d.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_MODULE_H
+
+#define FT_USE_MODULE(type, x) extern "C" const FT_Module_Class x;
+#include FT_CONFIG_MODULES_H
+#undef FT_USE_MODULE
 
 #pragma comment(lib, "freetype")
 #pragma comment(lib, "shlwapi.lib")
+#pragma comment(lib, "psapi.lib")
 
-std::unordered_map<std::string, std::string> g_fontsWrapper;
-
-struct TTFont
+struct FTModule
 {
-    FT_Face fontFace = {};
-    std::unordered_map<uint32_t, std::tuple<unsigned int, unsigned int, int, int, LPDIRECTDRAWSURFACE7, float, float, float, float, int>> cachedGlyphs;
-    int r, g, b, a;
+    const char* name;
+    const FT_Module_Class* clazz;
+};
+
+static const FTModule g_ftAvailableModules[] = {
+    {"TRUETYPE", &tt_driver_class},
+    {"CFF", &cff_driver_class},
+    {"TYPE1", &t1_driver_class},
+    {"T1CID", &t1cid_driver_class},
+    {"PFR", &pfr_driver_class},
+    {"TYPE42", &t42_driver_class},
+    {"WINFONTS", &winfnt_driver_class},
+    {"PCF", &pcf_driver_class},
+    {"BDF", &bdf_driver_class},
+    {"SFNT", &sfnt_module_class},
+    {"PSAUX", &psaux_module_class},
+    {"PSNAMES", &psnames_module_class},
+    {"PSHINTER", &pshinter_module_class},
+    {"AUTOFIT", &autofit_module_class},
+    {"SMOOTH", &ft_smooth_renderer_class},
+    {"RASTER1", &ft_raster1_renderer_class},
+    {"SDF", &ft_sdf_renderer_class},
+    {"BSDF", &ft_bitmap_sdf_renderer_class},
+    {"SVG", &ft_svg_renderer_class},
 };
 
+// CFF driver can't open faces without psaux so it is part of the default set
+std::vector<std::string> g_ftModules = {"TRUETYPE", "CFF", "SFNT", "PSNAMES", "PSAUX", "AUTOFIT", "SMOOTH"};
+
 bool g_GD3D11 = false;
 bool g_initialized = false;
-bool g_useBGRA = true;
 bool g_useScaling = true;
-int g_useEncoding = 0;
-std::unordered_set<TTFont*> g_fonts;
-FT_Library g_ft;
-
-typedef void(__thiscall* _Org_G1_zCFont_Destructor)(DWORD);
-typedef void(__thiscall* _Org_G1_zCRenderer_ClearDevice)(DWORD);
-typedef void(__thiscall* _Org_G2_zCFont_Destructor)(DWORD);
-typedef void(__thiscall* _Org_G2_zCRenderer_ClearDevice)(DWORD);
-_Org_G1_zCFont_Destructor Org_G1_zCFont_Destructor;
-_Org_G1_zCRenderer_ClearDevice Org_G1_zCRenderer_ClearDevice;
-_Org_G2_zCFont_Destructor Org_G2_zCFont_Destructor;
-_Org_G2_zCRenderer_ClearDevice Org_G2_zCRenderer_ClearDevice;
-
-static void ReadFontDetail(const std::string& lhLine, const std::string& rhLine, int& fontSize, int& fontRed, int& fontGreen, int& fontBlue, int& fontAlpha)
+bool g_captureTrace = false;
+std::string g_atlasDumpPath;
+std::string g_usagePath;
+std::string g_prewarmPath;
+std::string g_profilePath;
+bool g_publishTelemetry = false;
+TelemetryWriter g_telemetry;
+DWORD g_statsFont = 0;
+void(*g_drawStatsOverlay)() = nullptr;
+
+// Code the plugin overwrote in another module, kept so the patch can be undone
+struct CodePatch
 {
-    if(lhLine == "SIZE")
-    {
-        try {fontSize = std::stol(rhLine);}
-        catch(const std::exception&) {fontSize = 20;}
-    }
-    else if(lhLine == "R" || lhLine == "RED")
-    {
-        try {fontRed = std::stol(rhLine);}
-        catch(const std::exception&) {fontRed = 255;}
-    }
-    else if(lhLine == "G" || lhLine == "GREEN")
-    {
-        try {fontGreen = std::stol(rhLine);}
-        catch(const std::exception&) {fontGreen = 255;}
-    }
-    else if(lhLine == "B" || lhLine == "BLUE")
-    {
-        try {fontBlue = std::stol(rhLine);}
-        catch(const std::exception&) {fontBlue = 255;}
-    }
-    else if(lhLine == "A" || lhLine == "ALPHA")
+    DWORD address;
+    DWORD length;
+    char original[8];
+};
+std::vector<CodePatch> g_rendererTextPatches;
+
+typedef void(__thiscall* _Org_zCFont_Destructor)(DWORD);
+typedef void(__thiscall* _Org_zCRenderer_ClearDevice)(DWORD);
+typedef void(__thiscall* _Org_zCView_Printwin)(DWORD, const zSTRING_G2&);
+template<typename Game> _Org_zCFont_Destructor Org_zCFont_Destructor;
+template<typename Game> _Org_zCRenderer_ClearDevice Org_zCRenderer_ClearDevice;
+template<typename Game> _Org_zCView_Printwin Org_zCView_Printwin;
+
+static void AddFreeTypeModules(FT_Library library)
+{
+    if(std::find(g_ftModules.begin(), g_ftModules.end(), "ALL") != g_ftModules.end())
     {
-        try {fontAlpha = std::stol(rhLine);}
-        catch(const std::exception&) {fontAlpha = 255;}
+        FT_Add_Default_Modules(library);
+        return;
     }
-}
 
-static void ReadFontDetails(const std::string& fontStr, std::string& fontName, int& fontSize, int& fontRed, int& fontGreen, int& fontBlue, int& fontAlpha)
-{
-    size_t pos = 0, start = 0;
-    while((pos = fontStr.find(':', pos)) != std::string::npos)
+    for(const std::string& moduleName : g_ftModules)
     {
-        std::size_t eqpos;
-        std::string elem = fontStr.substr(start, pos - start);
-        if((eqpos = elem.find("=")) != std::string::npos)
+        const FTModule* module = std::find_if(std::begin(g_ftAvailableModules), std::end(g_ftAvailableModules), [&moduleName](const FTModule& m) {return moduleName == m.name;});
+        if(module == std::end(g_ftAvailableModules))
         {
-            std::transform(elem.begin(), elem.end(), elem.begin(), toupper);
-
-            std::string lhLine = elem.substr(0, eqpos);
-            std::string rhLine = elem.substr(eqpos + 1);
-            lhLine.erase(lhLine.find_last_not_of(' ') + 1);
-            lhLine.erase(0, lhLine.find_first_not_of(' '));
-            rhLine.erase(rhLine.find_last_not_of(' ') + 1);
-            rhLine.erase(0, rhLine.find_first_not_of(' '));
-            ReadFontDetail(lhLine, rhLine, fontSize, fontRed, fontGreen, fontBlue, fontAlpha);
+            LogMessage("Unknown FreeType module \"%s\"", moduleName.c_str());
+            continue;
         }
-        else
-            fontName = elem;
-
-        start = ++pos;
+        if(FT_Add_Module(library, module->clazz))
+            LogMessage("Failed to add FreeType module \"%s\"", moduleName.c_str());
     }
+}
 
-    pos = fontStr.length();
-    if(start >= pos)
-        return;
-
-    std::size_t eqpos;
-    std::string elem = fontStr.substr(start, pos - start);
-    if((eqpos = elem.find("=")) != std::string::npos)
-    {
-        std::transform(elem.begin(), elem.end(), elem.begin(), toupper);
-
-        std::string lhLine = elem.substr(0, eqpos);
-        std::string rhLine = elem.substr(eqpos + 1);
-        lhLine.erase(lhLine.find_last_not_of(' ') + 1);
-        lhLine.erase(0, lhLine.find_first_not_of(' '));
-        rhLine.erase(rhLine.find_last_not_of(' ') + 1);
-        rhLine.erase(0, rhLine.find_first_not_of(' '));
-        ReadFontDetail(lhLine, rhLine, fontSize, fontRed, fontGreen, fontBlue, fontAlpha);
-    }
-    else
-        fontName = elem;
+static void ShowFatalError(const char* message)
+{
+    MessageBoxA(nullptr, message, "Gothic TTF", MB_ICONHAND);
 }
 
-__forceinline DWORD UTIL_power_of_2(DWORD input)
+static SIZE_T GetPrivateBytes()
 {
-    DWORD value = 1;
-    while(value < input) value <<= 1;
-    return value;
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    ZeroMemory(&pmc, sizeof(pmc));
+    pmc.cb = sizeof(pmc);
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc)))
+        return 0;
+    return pmc.PrivateUsage;
 }
 
-#define UNKNOWN_UNICODE 0xFFFD
-static uint32_t UTF8toUTF32(const char* text, int textlen, int& utf8size)
+static void PublishTelemetry()
 {
-    switch(g_useEncoding)
-    {
-        case 1258: utf8size = 1; return static_cast<uint32_t>(CodePage1258[static_cast<unsigned char>(text[0])]);
-        case 1257: utf8size = 1; return static_cast<uint32_t>(CodePage1257[static_cast<unsigned char>(text[0])]);
-        case 1256: utf8size = 1; return static_cast<uint32_t>(CodePage1256[static_cast<unsigned char>(text[0])]);
-        case 1255: utf8size = 1; return static_cast<uint32_t>(CodePage1255[static_cast<unsigned char>(text[0])]);
-        case 1254: utf8size = 1; return static_cast<uint32_t>(CodePage1254[static_cast<unsigned char>(text[0])]);
-        case 1253: utf8size = 1; return static_cast<uint32_t>(CodePage1253[static_cast<unsigned char>(text[0])]);
-        case 1252: utf8size = 1; return static_cast<uint32_t>(CodePage1252[static_cast<unsigned char>(text[0])]);
-        case 1251: utf8size = 1; return static_cast<uint32_t>(CodePage1251[static_cast<unsigned char>(text[0])]);
-        case 1250: utf8size = 1; return static_cast<uint32_t>(CodePage1250[static_cast<unsigned char>(text[0])]);
-        default: break;
-    }
+    const TextFrameCounters& counters = GetLastFrameCounters();
+    const TextureUsage& textures = g_textureTracker.GetTotal();
+
+    TelemetryStats stats = {};
+    stats.frame = g_textFrame;
+    stats.fonts = static_cast<uint32_t>(g_fonts.size());
+    for(TTFont* fnt : g_fonts)
+        stats.cachedGlyphs += static_cast<uint32_t>(fnt->cachedGlyphs.size());
+    stats.atlasPages = static_cast<uint32_t>(g_glyphAtlas.GetPageCount());
+    stats.drawCalls = counters.drawCalls;
+    stats.glyphsDrawn = counters.glyphsDrawn;
+    stats.measureCalls = counters.measureCalls;
+    stats.cacheMisses = counters.cacheMisses;
+    stats.textureSurfaces = static_cast<uint32_t>(textures.surfaces);
+    stats.textureBytes = textures.bytes;
+    stats.texturePeakBytes = textures.peakBytes;
+    for(int i = 0; i < FTArena_Count; ++i)
+        stats.freeTypeBytes += g_ftAllocator.GetStats(static_cast<FTArenaType>(i)).liveBytes;
+    g_telemetry.Publish(stats, TextStatsTicksToMs(counters.rasterTicks));
+}
 
-    const uint8_t* p = reinterpret_cast<const uint8_t*>(text);
-    size_t left = 0;
-    int save_textlen = textlen;
-    bool underflow = false;
-    uint32_t ch = UNKNOWN_UNICODE;
-    if(p[0] >= 0xFC)
-    {
-        if((p[0] & 0xFE) == 0xFC)
-        {
-            ch = static_cast<uint32_t>(p[0] & 0x01);
-            left = 5;
-        }
-    }
-    else if(p[0] >= 0xF8)
-    {
-        if((p[0] & 0xFC) == 0xF8)
-        {
-            ch = static_cast<uint32_t>(p[0] & 0x03);
-            left = 4;
-        }
-    }
-    else if(p[0] >= 0xF0)
-    {
-        if((p[0] & 0xF8) == 0xF0)
-        {
-            ch = static_cast<uint32_t>(p[0] & 0x07);
-            left = 3;
-        }
-    }
-    else if(p[0] >= 0xE0)
-    {
-        if((p[0] & 0xF0) == 0xE0)
-        {
-            ch = static_cast<uint32_t>(p[0] & 0x0F);
-            left = 2;
-        }
-    }
-    else if(p[0] >= 0xC0)
-    {
-        if((p[0] & 0xE0) == 0xC0)
-        {
-            ch = static_cast<uint32_t>(p[0] & 0x1F);
-            left = 1;
-        }
-    }
-    else
-    {
-        if((p[0] & 0x80) == 0x00)
-            ch = static_cast<uint32_t>(p[0]);
-    }
+#ifdef TTF_ALLOC_TRACKING
+// Steady-state frames that allocated over the whole session, the total goes to TTF.log on exit
+static uint32_t g_allocatingFrames = 0;
 
-    --textlen;
-    while(left > 0 && textlen > 0)
-    {
-        ++p;
-        if((p[0] & 0xC0) != 0x80)
-        {
-            ch = UNKNOWN_UNICODE;
-            break;
-        }
-        ch <<= 6;
-        ch |= (p[0] & 0x3F);
-        --textlen;
-        --left;
-    }
+static void CountFrameAllocations()
+{
+    static uint64_t lastHeap = 0, lastFreeType = 0;
+    uint64_t heap = GetHeapAllocations();
+    uint64_t freeType = g_ftAllocator.GetStats(FTArena_Face).allocations + g_ftAllocator.GetStats(FTArena_Transient).allocations;
+    g_textCounters.heapAllocations = static_cast<uint32_t>(heap - lastHeap);
+    g_textCounters.freeTypeAllocations = static_cast<uint32_t>(freeType - lastFreeType);
+    lastHeap = heap;
+    lastFreeType = freeType;
 
-    if(left > 0) underflow = true;
-    if(underflow ||
-        (ch >= 0xD800 && ch <= 0xDFFF) ||
-        (ch == 0xFFFE || ch == 0xFFFF) || ch > 0x10FFFF)
+    // Frames that only hit the glyph cache must not allocate, the first offenders get logged
+    bool allocated = (g_textCounters.heapAllocations != 0 || g_textCounters.freeTypeAllocations != 0);
+    if(allocated && g_textCounters.cacheMisses == 0 && g_textCounters.glyphsDrawn != 0 && ++g_allocatingFrames <= 16)
     {
-        ch = UNKNOWN_UNICODE;
+        LogMessage("Steady-state frame %u allocated: %u heap, %u FreeType, %u draw calls, %u measures", g_textFrame, g_textCounters.heapAllocations,
+            g_textCounters.freeTypeAllocations, g_textCounters.drawCalls, g_textCounters.measureCalls);
     }
-
-    utf8size = (save_textlen - textlen);
-    return ch;
 }
+#endif
 
-void LoadGlyph(TTFont* fnt, LPDIRECTDRAW7 device, LPDIRECTDRAWSURFACE7& texture, float& u0, float& u1, float& v0, float& v1)
-{
-    FT_Face& font = fnt->fontFace;
-    if(!texture)
-    {
-        DDSURFACEDESC2 ddsd;
-        ZeroMemory(&ddsd, sizeof(ddsd));
-        ddsd.dwSize = sizeof(ddsd);
-        ddsd.dwFlags = DDSD_CAPS | DDSD_WIDTH | DDSD_HEIGHT | DDSD_PIXELFORMAT;
-        ddsd.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_VIDEOMEMORY;
-        ddsd.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC;
-        ddsd.dwWidth = UTIL_power_of_2(font->glyph->bitmap.width);
-        ddsd.dwHeight = UTIL_power_of_2(font->glyph->bitmap.rows);
-        ddsd.ddpfPixelFormat.dwSize = sizeof(ddsd.ddpfPixelFormat);
-        ddsd.ddpfPixelFormat.dwFlags = DDPF_RGB | DDPF_ALPHAPIXELS;
-        ddsd.ddpfPixelFormat.dwRGBBitCount = 32;
-        ddsd.ddpfPixelFormat.dwRBitMask = 0x00FF0000;
-        ddsd.ddpfPixelFormat.dwGBitMask = 0x0000FF00;
-        ddsd.ddpfPixelFormat.dwBBitMask = 0x000000FF;
-        ddsd.ddpfPixelFormat.dwRGBAlphaBitMask = 0xFF000000;
-        HRESULT hr = device->CreateSurface(&ddsd, &texture, nullptr);
-        if(FAILED(hr))
-        {
-            MessageBoxW(nullptr, L"Failed to create glyph texture", L"Gothic TTF", MB_ICONHAND);
-            exit(-1);
-        }
+typedef HRESULT(__stdcall* _Org_D3D7_EndScene)(LPDIRECT3DDEVICE7);
+_Org_D3D7_EndScene Org_D3D7_EndScene;
 
-        u0 = 0.f;
-        u1 = static_cast<float>(font->glyph->bitmap.width) / ddsd.dwWidth;
-        v0 = 0.f;
-        v1 = static_cast<float>(font->glyph->bitmap.rows) / ddsd.dwHeight;
-    }
+HRESULT __stdcall D3D7_EndScene(LPDIRECT3DDEVICE7 d3d7Device)
+{
+#ifdef TTF_ALLOC_TRACKING
+    // Allocations are counted from one frame end to the next
+    CountFrameAllocations();
+#endif
+
+#ifdef TTF_PROFILE
+    // F11 dumps the timeline without having to quit the game
+    static bool dumpKeyDown = false;
+    bool keyDown = ((GetAsyncKeyState(VK_F11) & 0x8000) != 0);
+    if(keyDown && !dumpKeyDown)
+        ProfileDump(g_profilePath.c_str());
+    dumpKeyDown = keyDown;
+#endif
+
+    // F12 writes every atlas page and a description of its glyphs next to TTF.ini
+    if(g_glyphAtlas.IsEnabled())
+    {
+        static bool atlasKeyDown = false;
+        bool atlasKey = ((GetAsyncKeyState(VK_F12) & 0x8000) != 0);
+        if(atlasKey && !atlasKeyDown)
+            DumpGlyphAtlas(g_atlasDumpPath.c_str());
+        atlasKeyDown = atlasKey;
+    }
+
+    if(HasQueuedText())
+        DrawQueuedText();
+
+    ++g_textFrame;
+    g_textTrace.Frame();
+    g_hitchReport.EndFrame();
+    TextStatsEndFrame();
+    if(g_telemetry.IsOpen())
+        PublishTelemetry();
+    if(g_useStatsOverlay && g_drawStatsOverlay)
+    {
+        g_drawStatsOverlay();
+        // The overlay's own text doesn't count towards the next frame
+        g_textCounters = TextFrameCounters();
+    }
+    return Org_D3D7_EndScene(d3d7Device);
+}
 
-    DDSURFACEDESC2 ddsd;
-    ZeroMemory(&ddsd, sizeof(ddsd));
-    ddsd.dwSize = sizeof(ddsd);
-    HRESULT hr = texture->Lock(nullptr, &ddsd, DDLOCK_NOSYSLOCK | DDLOCK_WAIT | DDLOCK_WRITEONLY, nullptr);
-    if(FAILED(hr))
+void HookFrameEnd(LPDIRECT3DDEVICE7 d3d7Device)
+{
+#if !defined(TTF_PROFILE) && !defined(TTF_ALLOC_TRACKING)
+    if(!g_useStatsOverlay && g_statsLogInterval <= 0 && !g_textTrace.IsOpen() && !g_hitchReport.IsEnabled() && !g_glyphAtlas.IsEnabled()
+        && !g_telemetry.IsOpen() && !HasQueuedText())
         return;
+#endif
 
-    memset(ddsd.lpSurface, 0x00, ddsd.lPitch * ddsd.dwHeight);
-    if(font->glyph->bitmap.pixel_mode == FT_PIXEL_MODE_GRAY)
-    {
-        int srcPitch = font->glyph->bitmap.pitch;
-        int srcWidth = font->glyph->bitmap.width;
-        int srcHeight = font->glyph->bitmap.rows;
-        unsigned char* srcData = font->glyph->bitmap.buffer;
-        unsigned char* dstData = reinterpret_cast<unsigned char*>(ddsd.lpSurface);
-        for(int h = 0; h < srcHeight; ++h)
-        {
-            for(int w = 0; w < srcWidth; ++w)
-            {
-                unsigned char gray = srcData[w];
-                unsigned char* bgra = dstData + w * 4;
-                bgra[0] = fnt->r;
-                bgra[1] = fnt->g;
-                bgra[2] = fnt->b;
-                bgra[3] = gray * fnt->a / 255;
-            }
-            dstData += ddsd.lPitch;
-            srcData += srcPitch;
-        }
-    }
+    // EndScene is the 7th entry of the IDirect3DDevice7 vtable, every device of the same class shares it
+    DWORD* vtable = *reinterpret_cast<DWORD**>(d3d7Device);
+    if(vtable[6] == reinterpret_cast<DWORD>(&D3D7_EndScene))
+        return;
 
-    texture->Unlock(nullptr);
+    Org_D3D7_EndScene = reinterpret_cast<_Org_D3D7_EndScene>(vtable[6]);
+    OverWrite(reinterpret_cast<DWORD>(&vtable[6]), reinterpret_cast<DWORD>(&D3D7_EndScene));
 }
 
-int __fastcall G1_zCFont_LoadFontTexture(DWORD zCFont, DWORD _EDX, zSTRING_G2& fName)
+// Turns the font file of a descriptor into a path below the game's font directory and scales the size with the UI
+template<typename Game>
+void ResolveFontFile(std::string& fntName, int& size)
 {
-    int size = 20, r = 0xFF, g = 0xFF, b = 0xFF, a = 0xFF;
-    std::string fontName(fName.ToChar(), fName.Length());
-    std::transform(fontName.begin(), fontName.end(), fontName.begin(), toupper);
-    if(fontName.find(':') == std::string::npos)
-    {
-        auto it = g_fontsWrapper.find(fontName);
-        if(it == g_fontsWrapper.end())
-        {
-            it = g_fontsWrapper.find("DEFAULT");
-            if(it == g_fontsWrapper.end())
-                return 0;
-        }
-        fontName.assign(it->second);
-    }
-
-    std::string fntName;
-    ReadFontDetails(fontName, fntName, size, r, g, b, a);
-    if(g_useBGRA) std::swap(r, b);
-
-    if(g_useScaling && *reinterpret_cast<BYTE*>(0x6E0238) == 0xE9)
+    if(g_useScaling && *reinterpret_cast<BYTE*>(Game::UIScalePatch) == 0xE9)
     {
-        float UIscale = *reinterpret_cast<float*>(*reinterpret_cast<DWORD*>(0x5A88E1));
+        float UIscale = *reinterpret_cast<float*>(*reinterpret_cast<DWORD*>(Game::UIScale));
         size = static_cast<int>(size * UIscale);
     }
-    *reinterpret_cast<int*>(zCFont + 0x14) = size;
 
-    zSTRING_G2& path = reinterpret_cast<zSTRING_G2&(__thiscall*)(DWORD, int)>(0x45FC00)(*reinterpret_cast<DWORD*>(0x869694), 23);
-    fntName.insert(0, "\\_WORK\\FONTS\\G1_");
+    zSTRING_G2& path = reinterpret_cast<zSTRING_G2&(__thiscall*)(DWORD, int)>(Game::zCOption_GetDirString)(*reinterpret_cast<DWORD*>(Game::Options), Game::FontDirectory);
+    fntName.insert(0, Game::FontPrefix);
     fntName.insert(0, path.ToChar(), path.Length());
+}
 
-    TTFont* ttFont = new TTFont;
-    ttFont->r = r; ttFont->g = g; ttFont->b = b; ttFont->a = a;
-    *reinterpret_cast<TTFont**>(zCFont + 0x20) = ttFont;
-    if(FT_New_Face(g_ft, fntName.c_str(), 0, &ttFont->fontFace))
+template<typename Game>
+int __fastcall zCFont_LoadFontTexture(DWORD zCFont, DWORD _EDX, zSTRING_G2& fName)
+{
+    TTF_PROFILE_SCOPE_DETAIL("LoadFontTexture", fName.ToChar());
+    std::string fontName(fName.ToChar(), fName.Length());
+    if(!ResolveFontDescriptor(fontName))
+        return 0;
+
+    TTFont* ttFont = LoadFont(fontName, &ResolveFontFile<Game>);
+    if(!ttFont)
     {
         MessageBoxW(nullptr, L"Failed to load font", L"Gothic TTF", MB_ICONHAND);
         exit(-1);
     }
-    for(int i = 0; i < ttFont->fontFace->num_charmaps; ++i)
-    {
-        FT_CharMap charmap = ttFont->fontFace->charmaps[i];
-        if((charmap->platform_id == 3 && charmap->encoding_id == 1) /* Windows Unicode */
-            || (charmap->platform_id == 3 && charmap->encoding_id == 0) /* Windows Symbol */
-            || (charmap->platform_id == 2 && charmap->encoding_id == 1) /* ISO Unicode */
-            || (charmap->platform_id == 0)) /* Apple Unicode */
-        {
-            FT_Set_Charmap(ttFont->fontFace, charmap);
-            break;
-        }
-    }
-
-    FT_Set_Pixel_Sizes(ttFont->fontFace, 0, size);
-    if(FT_IS_SCALABLE(ttFont->fontFace))
-    {
-        FT_Fixed scale = ttFont->fontFace->size->metrics.y_scale;
-        int height = FT_MulFix(ttFont->fontFace->height, scale);
-        int ascent = FT_MulFix(ttFont->fontFace->ascender, scale);
-        int descent = FT_MulFix(ttFont->fontFace->descender, scale);
-        *reinterpret_cast<int*>(zCFont + 0x24) = static_cast<int>(((height + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x28) = static_cast<int>(((ascent + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x2C) = static_cast<int>(((descent + 63) & -64) / 64);
-    }
-    else
-    {
-        *reinterpret_cast<int*>(zCFont + 0x24) = static_cast<int>(((ttFont->fontFace->size->metrics.height + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x28) = static_cast<int>(((ttFont->fontFace->size->metrics.ascender + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x2C) = static_cast<int>(((ttFont->fontFace->size->metrics.descender + 63) & -64) / 64);
-    }
 
-    g_fonts.emplace(ttFont);
+    SetEngineFont<Game>(zCFont, ttFont);
     return 1;
 }
 
-void __fastcall G1_zCFont_Destructor(DWORD zCFont)
+template<typename Game>
+void __fastcall zCFont_Destructor(DWORD zCFont)
 {
-    TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
+    if(zCFont == g_statsFont)
+        g_statsFont = 0;
+
+    TTFont* ttFont = GetEngineFont<Game>(zCFont);
     if(ttFont)
-    {
-        for(auto& it : ttFont->cachedGlyphs)
-        {
-            LPDIRECTDRAWSURFACE7 texture = std::get<4>(it.second);
-            texture->Release();
-        }
-        FT_Done_Face(ttFont->fontFace);
-        ttFont->cachedGlyphs.clear();
-        g_fonts.erase(ttFont);
-        delete ttFont;
-    }
+        UnloadFont(ttFont);
 
-    Org_G1_zCFont_Destructor(zCFont);
+    Org_zCFont_Destructor<Game>(zCFont);
 }
 
-void __fastcall G1_zCView_RecalcChildsPos(DWORD zCView)
+template<typename Game>
+void __fastcall zCView_RecalcChildsPos(DWORD zCView)
 {
-    reinterpret_cast<void(__thiscall*)(DWORD)>(0x6FD9A0)(zCView);
+    TTF_PROFILE_SCOPE("RecalcChildsPos");
+    reinterpret_cast<void(__thiscall*)(DWORD)>(Game::zCView_RecalcChildsPos)(zCView);
 
-    DWORD zCFontMan = *reinterpret_cast<DWORD*>(0x8DC71C);
+    DWORD zCFontMan = *reinterpret_cast<DWORD*>(Game::FontManager);
     if(zCFontMan)
     {
         int fonts = *reinterpret_cast<int*>(zCFontMan + 0x08);
         for(int i = 0; i < fonts; ++i)
         {
-            DWORD zCFont = reinterpret_cast<DWORD(__thiscall*)(DWORD, int)>(0x6DF220)(zCFontMan, i);
+            DWORD zCFont = reinterpret_cast<DWORD(__thiscall*)(DWORD, int)>(Game::zCFontMan_GetFont)(zCFontMan, i);
             if(zCFont)
             {
                 // Delete current loaded font
-                TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
+                TTFont* ttFont = GetEngineFont<Game>(zCFont);
                 if(ttFont)
                 {
-                    for(auto& it : ttFont->cachedGlyphs)
-                    {
-                        LPDIRECTDRAWSURFACE7 texture = std::get<4>(it.second);
-                        texture->Release();
-                    }
-                    FT_Done_Face(ttFont->fontFace);
-                    ttFont->cachedGlyphs.clear();
-                    g_fonts.erase(ttFont);
-                    delete ttFont;
-                    *reinterpret_cast<DWORD*>(zCFont + 0x20) = 0;
+                    UnloadFont(ttFont);
+                    EngineMember<TTFont*>(zCFont, Game::FontTTF) = nullptr;
                 }
 
                 // Reload font using LoadFontTexture
-                reinterpret_cast<int(__thiscall*)(DWORD, DWORD)>(0x6DF280)(zCFont, zCFont);
+                reinterpret_cast<int(__thiscall*)(DWORD, DWORD)>(Game::zCFont_LoadFontTexture)(zCFont, zCFont);
             }
         }
+        LogFontCacheStats();
+        g_textureTracker.LogReport();
     }
 }
 
-int __fastcall G1_zCFont_GetFontY(DWORD zCFont)
+template<typename Game>
+int __fastcall zCFont_GetFontY(DWORD zCFont)
 {
-    return *reinterpret_cast<int*>(zCFont + 0x24) - *reinterpret_cast<int*>(zCFont + 0x2C);
+    return GetFontY<Game>(zCFont);
 }
 
-int __fastcall G1_zCFont_GetFontX(DWORD zCFont, DWORD _EDX, zSTRING_G2& text)
+template<typename Game>
+int __fastcall zCFont_GetFontX(DWORD zCFont, DWORD _EDX, zSTRING_G2& text)
 {
-    int fontHeight = *reinterpret_cast<int*>(zCFont + 0x14);
-    int width = 0;
-    const char* ctext = text.ToChar();
-    for(int i = 0, len = text.Length(); i < len;)
-    {
-        int utf8size;
-        uint32_t utf32 = UTF8toUTF32(ctext + i, len - i, utf8size);
-        i += utf8size;
-        if(utf32 <= 32)
-            width += fontHeight / 4;
-        else
-        {
-            TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-            auto it = ttFont->cachedGlyphs.find(utf32);
-            if(it == ttFont->cachedGlyphs.end())
-            {
-                if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                {
-                    MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                    exit(-1);
-                }
-                LPDIRECTDRAWSURFACE7 texture = nullptr;
-                float uv[4] = {};
-                LPDIRECTDRAW7 device = *reinterpret_cast<LPDIRECTDRAW7*>(0x929D54);
-                LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                it = ttFont->cachedGlyphs.emplace(std::piecewise_construct, std::forward_as_tuple(utf32), std::forward_as_tuple(ttFont->fontFace->glyph->bitmap.width,
-                    ttFont->fontFace->glyph->bitmap.rows, ttFont->fontFace->glyph->bitmap_left, ttFont->fontFace->glyph->bitmap_top, texture, uv[0], uv[1], uv[2], uv[3],
-                    ttFont->fontFace->glyph->advance.x >> 6)).first;
-            }
-            width += std::get<9>(it->second);
-        }
-    }
-    return width;
+    return GetFontX<Game>(zCFont, text);
 }
 
-void __fastcall G1_zCView_PrintChars(DWORD zCView, DWORD _EDX, int x, int y, zSTRING_G2& text)
+// Pages are DirectDraw surfaces drawn through the engine's renderer so it keeps track of the states and textures text changes
+template<typename Game>
+class D3D7RenderBackend : public GlyphRenderBackend
 {
-    LPDIRECTDRAW7 device = *reinterpret_cast<LPDIRECTDRAW7*>(0x929D54);
-    LPDIRECT3DDEVICE7 d3d7Device = *reinterpret_cast<LPDIRECT3DDEVICE7*>(0x929D5C);
-    DWORD zRenderer = *reinterpret_cast<DWORD*>(0x8C5ED0);
-    DWORD zCFont = *reinterpret_cast<DWORD*>(zCView + 0x60);
-    DWORD zCOLOR = *reinterpret_cast<DWORD*>(zCView + 0x64);
-    int fontHeight = *reinterpret_cast<int*>(zCFont + 0x14);
-    int fontAscent = *reinterpret_cast<int*>(zCFont + 0x28);
-
-    int oldZWrite = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x68))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x6C))(zRenderer, 0); // No depth-writes
-    int oldZCompare = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x70))(zRenderer);
-    int newZCompare = 0; // Compare always
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x74))(zRenderer, newZCompare);
-    int oldFilter = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x54))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x50))(zRenderer, 0); // Non-Bilinear filter
-    int oldAlphaFunc = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x8C))(zRenderer);
-    // Enable alpha blending
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 26, 0);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 27, 1);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 19, 5);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 20, 6);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 15, 0);
-    // Disable clipping
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 136, 0);
-    // Disable culling
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 22, 1);
-    // Set texture clamping
-    DWORD SetTextureStageState = *reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x148);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 12, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 13, 3);
-    // 0 stage AlphaOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 3, 3);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage AlphaOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 3, 0);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage ColorOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 0, 0);
-    // 0 stage AlphaArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 4, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 5, 1);
-    // 0 stage ColorArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 1, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 2, 1);
-    // 0 stage TextureTransformFlags disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 23, 0);
-    // 0 stage TexCoordIndex 0
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 10, 0);
-
-    float clipRect = static_cast<float>(*reinterpret_cast<int*>(zCView + 0x50)) + (*reinterpret_cast<int*>(zCView + 0x58));
-    const char* ctext = text.ToChar();
-    for(int i = 0, len = text.Length(); i < len;)
-    {
-        int utf8size;
-        uint32_t utf32 = UTF8toUTF32(ctext + i, len - i, utf8size);
-        i += utf8size;
-        if(utf32 <= 32)
-            x += fontHeight / 4;
-        else
-        {
-            LPDIRECTDRAWSURFACE7 texture = nullptr;
-            TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-            auto it = ttFont->cachedGlyphs.find(utf32);
-            if(it == ttFont->cachedGlyphs.end())
+    public:
+        bool IsReady() const override {return *reinterpret_cast<LPDIRECTDRAW7*>(Game::DirectDraw) != nullptr;}
+
+        GlyphPage CreatePage(unsigned int width, unsigned int height, GlyphTextureFormat format) override
+        {
+            DDSURFACEDESC2 ddsd;
+            ZeroMemory(&ddsd, sizeof(ddsd));
+            ddsd.dwSize = sizeof(ddsd);
+            ddsd.dwFlags = DDSD_CAPS | DDSD_WIDTH | DDSD_HEIGHT | DDSD_PIXELFORMAT;
+            ddsd.ddsCaps.dwCaps = DDSCAPS_TEXTURE | DDSCAPS_VIDEOMEMORY;
+            ddsd.ddsCaps.dwCaps2 = DDSCAPS2_HINTSTATIC;
+            ddsd.dwWidth = width;
+            ddsd.dwHeight = height;
+            ddsd.ddpfPixelFormat.dwSize = sizeof(ddsd.ddpfPixelFormat);
+            if(format == GlyphFormat_A8L8)
             {
-                if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                {
-                    MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                    exit(-1);
-                }
-                float uv[4] = {};
-                LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                it = ttFont->cachedGlyphs.emplace(std::piecewise_construct, std::forward_as_tuple(utf32), std::forward_as_tuple(ttFont->fontFace->glyph->bitmap.width,
-                    ttFont->fontFace->glyph->bitmap.rows, ttFont->fontFace->glyph->bitmap_left, ttFont->fontFace->glyph->bitmap_top, texture, uv[0], uv[1], uv[2], uv[3],
-                    ttFont->fontFace->glyph->advance.x >> 6)).first;
+                ddsd.ddpfPixelFormat.dwFlags = DDPF_LUMINANCE | DDPF_ALPHAPIXELS;
+                ddsd.ddpfPixelFormat.dwLuminanceBitCount = 16;
+                ddsd.ddpfPixelFormat.dwLuminanceBitMask = 0x000000FF;
+                ddsd.ddpfPixelFormat.dwLuminanceAlphaBitMask = 0x0000FF00;
             }
             else
             {
-                texture = std::get<4>(it->second);
-                if(texture->IsLost() == DDERR_SURFACELOST)
-                {
-                    texture->Restore();
-
-                    if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                    {
-                        MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                        exit(-1);
-                    }
-                    float uv[4] = {};
-                    LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                }
+                ddsd.ddpfPixelFormat.dwFlags = DDPF_RGB | DDPF_ALPHAPIXELS;
+                ddsd.ddpfPixelFormat.dwRGBBitCount = 32;
+                ddsd.ddpfPixelFormat.dwRBitMask = 0x00FF0000;
+                ddsd.ddpfPixelFormat.dwGBitMask = 0x0000FF00;
+                ddsd.ddpfPixelFormat.dwBBitMask = 0x000000FF;
+                ddsd.ddpfPixelFormat.dwRGBAlphaBitMask = 0xFF000000;
             }
 
-            unsigned int glyphWidth = std::get<0>(it->second);
-            unsigned int glyphHeight = std::get<1>(it->second);
-            int glyphLeft = std::get<2>(it->second);
-            int glyphTop = std::get<3>(it->second);
-            int glyphAdvance = std::get<9>(it->second);
+            LPDIRECTDRAWSURFACE7 texture;
+            LPDIRECTDRAW7 device = *reinterpret_cast<LPDIRECTDRAW7*>(Game::DirectDraw);
+            if(FAILED(device->CreateSurface(&ddsd, &texture, nullptr)))
+                return nullptr;
+            return texture;
+        }
 
-            float minx = static_cast<float>(x) + glyphLeft;
-            float miny = static_cast<float>(y) + fontAscent - glyphTop;
-            if(!g_GD3D11)
-            {
-                minx -= 0.5f;
-                miny -= 0.5f;
-            }
-            float maxx = minx + glyphWidth;
-            float maxy = miny + glyphHeight;
+        bool LockPage(GlyphPage page, const AtlasRect* rect, bool readOnly, GlyphPageLock& lock) override
+        {
+            RECT lockRect;
+            DDSURFACEDESC2 ddsd;
+            ZeroMemory(&ddsd, sizeof(ddsd));
+            ddsd.dwSize = sizeof(ddsd);
+            DWORD flags = DDLOCK_NOSYSLOCK | DDLOCK_WAIT | (readOnly ? DDLOCK_READONLY : DDLOCK_WRITEONLY);
+            if(FAILED(static_cast<LPDIRECTDRAWSURFACE7>(page)->Lock(GetLockArea(rect, lockRect), &ddsd, flags, nullptr)))
+                return false;
+
+            lock.texels = reinterpret_cast<unsigned char*>(ddsd.lpSurface);
+            lock.pitch = static_cast<int>(ddsd.lPitch);
+            lock.width = (rect ? rect->width : ddsd.dwWidth);
+            lock.rows = (rect ? rect->height : ddsd.dwHeight);
+            return true;
+        }
 
-            float minu = std::get<5>(it->second);
-            float maxu = std::get<6>(it->second);
-            float minv = std::get<7>(it->second);
-            float maxv = std::get<8>(it->second);
+        void UnlockPage(GlyphPage page, const AtlasRect* rect) override
+        {
+            RECT lockRect;
+            static_cast<LPDIRECTDRAWSURFACE7>(page)->Unlock(GetLockArea(rect, lockRect));
+        }
 
-            if(minx > clipRect) break;
-            {
-                struct D3DTLVERTEX
-                {
-                    float sx;
-                    float sy;
-                    float sz;
-                    float rhw;
-                    DWORD color;
-                    DWORD specular;
-                    float tu;
-                    float tv;
-                };
-                D3DTLVERTEX vertices[4];
-                vertices[0].sx = minx;
-                vertices[0].sy = miny;
-                vertices[0].sz = 1.f;
-                vertices[0].rhw = 1.f;
-                vertices[0].color = zCOLOR;
-                vertices[0].specular = 0xFFFFFFFF;
-                vertices[0].tu = minu;
-                vertices[0].tv = minv;
-
-                vertices[1].sx = maxx;
-                vertices[1].sy = miny;
-                vertices[1].sz = 1.f;
-                vertices[1].rhw = 1.f;
-                vertices[1].color = zCOLOR;
-                vertices[1].specular = 0xFFFFFFFF;
-                vertices[1].tu = maxu;
-                vertices[1].tv = minv;
-
-                vertices[2].sx = maxx;
-                vertices[2].sy = maxy;
-                vertices[2].sz = 1.f;
-                vertices[2].rhw = 1.f;
-                vertices[2].color = zCOLOR;
-                vertices[2].specular = 0xFFFFFFFF;
-                vertices[2].tu = maxu;
-                vertices[2].tv = maxv;
-
-                vertices[3].sx = minx;
-                vertices[3].sy = maxy;
-                vertices[3].sz = 1.f;
-                vertices[3].rhw = 1.f;
-                vertices[3].color = zCOLOR;
-                vertices[3].specular = 0xFFFFFFFF;
-                vertices[3].tu = minu;
-                vertices[3].tv = maxv;
-                reinterpret_cast<void(__thiscall*)(DWORD, int, LPDIRECTDRAWSURFACE7)>(0x718150)(zRenderer, 0, texture);
-                d3d7Device->DrawPrimitive(D3DPT_TRIANGLEFAN, D3DFVF_TLVERTEX, reinterpret_cast<LPVOID>(vertices), 4, 0);
-            }
+        void ReleasePage(GlyphPage page) override {static_cast<LPDIRECTDRAWSURFACE7>(page)->Release();}
+        bool IsPageLost(GlyphPage page) override {return static_cast<LPDIRECTDRAWSURFACE7>(page)->IsLost() == DDERR_SURFACELOST;}
+        void RestorePage(GlyphPage page) override {static_cast<LPDIRECTDRAWSURFACE7>(page)->Restore();}
+
+        void BeginText() override
+        {
+            DWORD zRenderer = *reinterpret_cast<DWORD*>(Game::Renderer);
+            m_oldZWrite = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::GetZBufferWrite))(zRenderer);
+            reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetZBufferWrite))(zRenderer, 0); // No depth-writes
+            m_oldZCompare = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::GetZBufferCompare))(zRenderer);
+            int newZCompare = 0; // Compare always
+            reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetZBufferCompare))(zRenderer, newZCompare);
+            m_oldFilter = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::GetBilerpFilter))(zRenderer);
+            reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetBilerpFilter))(zRenderer, 0); // Non-Bilinear filter
+            m_oldAlphaFunc = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::GetAlphaFunc))(zRenderer);
+            // Enable alpha blending
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(Game::zCRnd_D3D_SetRenderState)(zRenderer, 26, 0);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(Game::zCRnd_D3D_SetRenderState)(zRenderer, 27, 1);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(Game::zCRnd_D3D_SetRenderState)(zRenderer, 19, 5);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(Game::zCRnd_D3D_SetRenderState)(zRenderer, 20, 6);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(Game::zCRnd_D3D_SetRenderState)(zRenderer, 15, 0);
+            // Disable clipping
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(Game::zCRnd_D3D_SetRenderState)(zRenderer, 136, 0);
+            // Disable culling
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(Game::zCRnd_D3D_SetRenderState)(zRenderer, 22, 1);
+            // Set texture clamping
+            DWORD SetTextureStageState = *reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetTextureStageState);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 12, 3);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 13, 3);
+            // 0 stage AlphaOp modulate
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 3, 3);
+            // 0 stage ColorOp modulate
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
+            // 1 stage AlphaOp disable
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 3, 0);
+            // 0 stage ColorOp modulate
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
+            // 1 stage ColorOp disable
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 0, 0);
+            // 0 stage AlphaArg1/2 texure/diffuse
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 4, 3);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 5, 1);
+            // 0 stage ColorArg1/2 texure/diffuse
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 1, 3);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 2, 1);
+            // 0 stage TextureTransformFlags disable
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 23, 0);
+            // 0 stage TexCoordIndex 0
+            reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 10, 0);
+        }
 
-            x += glyphAdvance;
+        // The texture is set once per batch but every quad stays a fan of its own like the engine draws them
+        void DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads) override
+        {
+            DWORD zRenderer = *reinterpret_cast<DWORD*>(Game::Renderer);
+            LPDIRECT3DDEVICE7 d3d7Device = *reinterpret_cast<LPDIRECT3DDEVICE7*>(Game::Direct3DDevice);
+            reinterpret_cast<void(__thiscall*)(DWORD, int, LPDIRECTDRAWSURFACE7)>(Game::zCRnd_D3D_SetTexture)(zRenderer, 0, static_cast<LPDIRECTDRAWSURFACE7>(page));
+            for(size_t quad = 0; quad < quads; ++quad)
+                d3d7Device->DrawPrimitive(D3DPT_TRIANGLEFAN, D3DFVF_TLVERTEX, const_cast<TextVertex*>(vertices + quad * 4), 4, 0);
         }
-    }
 
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x88))(zRenderer, oldAlphaFunc);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x50))(zRenderer, oldFilter);
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x74))(zRenderer, oldZCompare);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x6C))(zRenderer, oldZWrite);
-}
+        void EndText() override
+        {
+            DWORD zRenderer = *reinterpret_cast<DWORD*>(Game::Renderer);
+            reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetAlphaFunc))(zRenderer, m_oldAlphaFunc);
+            reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetBilerpFilter))(zRenderer, m_oldFilter);
+            reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetZBufferCompare))(zRenderer, m_oldZCompare);
+            reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + Game::SetZBufferWrite))(zRenderer, m_oldZWrite);
+        }
 
-void __fastcall G1_zCViewPrint_BlitTextCharacters(DWORD zCViewPrint, DWORD zCViewText2, DWORD zCFont, DWORD& zCOLOR)
-{
-    LPDIRECTDRAW7 device = *reinterpret_cast<LPDIRECTDRAW7*>(0x929D54);
-    LPDIRECT3DDEVICE7 d3d7Device = *reinterpret_cast<LPDIRECT3DDEVICE7*>(0x929D5C);
-    DWORD zRenderer = *reinterpret_cast<DWORD*>(0x8C5ED0);
-
-    zSTRING_G2* text = reinterpret_cast<zSTRING_G2*>(zCViewText2 + 0x14);
-    int position0 = *reinterpret_cast<int*>(zCViewText2 + 0x08);
-    int position1 = *reinterpret_cast<int*>(zCViewText2 + 0x0C);
-    position0 += *reinterpret_cast<int*>(zCViewPrint + 0x38);
-    position1 += *reinterpret_cast<int*>(zCViewPrint + 0x3C);
-    position0 += *reinterpret_cast<int*>(zCViewPrint + 0xD4);
-    position1 += *reinterpret_cast<int*>(zCViewPrint + 0xD8);
-
-    int oldZWrite = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x68))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x6C))(zRenderer, 0); // No depth-writes
-    int oldZCompare = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x70))(zRenderer);
-    int newZCompare = 0; // Compare always
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x74))(zRenderer, newZCompare);
-    int oldFilter = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x54))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x50))(zRenderer, 0); // Non-Bilinear filter
-    int oldAlphaFunc = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x8C))(zRenderer);
-    // Enable alpha blending
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 26, 0);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 27, 1);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 19, 5);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 20, 6);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 15, 0);
-    // Disable clipping
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 136, 0);
-    // Disable culling
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x7185C0)(zRenderer, 22, 1);
-    // Set texture clamping
-    DWORD SetTextureStageState = *reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x148);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 12, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 13, 3);
-    // 0 stage AlphaOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 3, 3);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage AlphaOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 3, 0);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage ColorOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 0, 0);
-    // 0 stage AlphaArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 4, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 5, 1);
-    // 0 stage ColorArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 1, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 2, 1);
-    // 0 stage TextureTransformFlags disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 23, 0);
-    // 0 stage TexCoordIndex 0
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 10, 0);
-
-    float clipRect = static_cast<float>(*reinterpret_cast<int*>(zCViewPrint + 0x40) + *reinterpret_cast<int*>(zCViewPrint + 0x38));
-    int fontHeight = *reinterpret_cast<int*>(zCFont + 0x14);
-    int fontAscent = *reinterpret_cast<int*>(zCFont + 0x28);
-    const char* ctext = text->ToChar();
-    for(int i = 0, len = text->Length(); i < len;)
-    {
-        int utf8size;
-        uint32_t utf32 = UTF8toUTF32(ctext + i, len - i, utf8size);
-        i += utf8size;
-        if(utf32 <= 32)
-            position0 += fontHeight / 4;
-        else
+    private:
+        static LPRECT GetLockArea(const AtlasRect* rect, RECT& lockRect)
         {
-            LPDIRECTDRAWSURFACE7 texture = nullptr;
-            TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-            auto it = ttFont->cachedGlyphs.find(utf32);
-            if(it == ttFont->cachedGlyphs.end())
-            {
-                if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                {
-                    MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                    exit(-1);
-                }
-                float uv[4] = {};
-                LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                it = ttFont->cachedGlyphs.emplace(std::piecewise_construct, std::forward_as_tuple(utf32), std::forward_as_tuple(ttFont->fontFace->glyph->bitmap.width,
-                    ttFont->fontFace->glyph->bitmap.rows, ttFont->fontFace->glyph->bitmap_left, ttFont->fontFace->glyph->bitmap_top, texture, uv[0], uv[1], uv[2], uv[3],
-                    ttFont->fontFace->glyph->advance.x >> 6)).first;
-            }
-            else
-            {
-                texture = std::get<4>(it->second);
-                if(texture->IsLost() == DDERR_SURFACELOST)
-                {
-                    texture->Restore();
+            if(!rect)
+                return nullptr;
 
-                    if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                    {
-                        MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                        exit(-1);
-                    }
-                    float uv[4] = {};
-                    LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                }
-            }
+            lockRect.left = static_cast<LONG>(rect->x);
+            lockRect.top = static_cast<LONG>(rect->y);
+            lockRect.right = static_cast<LONG>(rect->x + rect->width);
+            lockRect.bottom = static_cast<LONG>(rect->y + rect->height);
+            return &lockRect;
+        }
 
-            unsigned int glyphWidth = std::get<0>(it->second);
-            unsigned int glyphHeight = std::get<1>(it->second);
-            int glyphLeft = std::get<2>(it->second);
-            int glyphTop = std::get<3>(it->second);
-            int glyphAdvance = std::get<9>(it->second);
+        int m_oldZWrite = 0;
+        int m_oldZCompare = 0;
+        int m_oldFilter = 0;
+        int m_oldAlphaFunc = 0;
+};
 
-            float minx = static_cast<float>(position0) + glyphLeft;
-            float miny = static_cast<float>(position1) + fontAscent - glyphTop;
-            if(!g_GD3D11)
-            {
-                minx -= 0.5f;
-                miny -= 0.5f;
-            }
-            float maxx = minx + glyphWidth;
-            float maxy = miny + glyphHeight;
+template<typename Game>
+void __fastcall zCView_PrintChars(DWORD zCView, DWORD _EDX, int x, int y, zSTRING_G2& text)
+{
+    HookFrameEnd(*reinterpret_cast<LPDIRECT3DDEVICE7*>(Game::Direct3DDevice));
+    g_statsFont = EngineMember<DWORD>(zCView, Game::ViewFont);
+    PrintChars<Game>(zCView, x, y, text);
+}
+
+// The engine wraps the text it gets here to the view's width itself, it only has to follow the line feeds put in where UAX #14 breaks
+template<typename Game>
+void __fastcall zCView_Printwin(DWORD zCView, DWORD _EDX, const zSTRING_G2& text)
+{
+    static std::string broken;
+    if(!BreakViewText<Game>(zCView, text, broken))
+    {
+        Org_zCView_Printwin<Game>(zCView, text);
+        return;
+    }
 
-            float minu = std::get<5>(it->second);
-            float maxu = std::get<6>(it->second);
-            float minv = std::get<7>(it->second);
-            float maxv = std::get<8>(it->second);
+    typename Game::VdfsString lines(broken.c_str());
+    Org_zCView_Printwin<Game>(zCView, reinterpret_cast<const zSTRING_G2&>(lines));
+    lines.Delete();
+}
 
-            if(minx > clipRect) break;
-            {
-                struct D3DTLVERTEX
-                {
-                    float sx;
-                    float sy;
-                    float sz;
-                    float rhw;
-                    DWORD color;
-                    DWORD specular;
-                    float tu;
-                    float tv;
-                };
-                D3DTLVERTEX vertices[4];
-                vertices[0].sx = minx;
-                vertices[0].sy = miny;
-                vertices[0].sz = 1.f;
-                vertices[0].rhw = 1.f;
-                vertices[0].color = zCOLOR;
-                vertices[0].specular = 0xFFFFFFFF;
-                vertices[0].tu = minu;
-                vertices[0].tv = minv;
-
-                vertices[1].sx = maxx;
-                vertices[1].sy = miny;
-                vertices[1].sz = 1.f;
-                vertices[1].rhw = 1.f;
-                vertices[1].color = zCOLOR;
-                vertices[1].specular = 0xFFFFFFFF;
-                vertices[1].tu = maxu;
-                vertices[1].tv = minv;
-
-                vertices[2].sx = maxx;
-                vertices[2].sy = maxy;
-                vertices[2].sz = 1.f;
-                vertices[2].rhw = 1.f;
-                vertices[2].color = zCOLOR;
-                vertices[2].specular = 0xFFFFFFFF;
-                vertices[2].tu = maxu;
-                vertices[2].tv = maxv;
-
-                vertices[3].sx = minx;
-                vertices[3].sy = maxy;
-                vertices[3].sz = 1.f;
-                vertices[3].rhw = 1.f;
-                vertices[3].color = zCOLOR;
-                vertices[3].specular = 0xFFFFFFFF;
-                vertices[3].tu = minu;
-                vertices[3].tv = maxv;
-                reinterpret_cast<void(__thiscall*)(DWORD, int, LPDIRECTDRAWSURFACE7)>(0x718150)(*reinterpret_cast<DWORD*>(0x8C5ED0), 0, texture);
-                d3d7Device->DrawPrimitive(D3DPT_TRIANGLEFAN, D3DFVF_TLVERTEX, reinterpret_cast<LPVOID>(vertices), 4, 0);
-            }
+template<typename Game>
+void DrawStatsOverlay()
+{
+    if(!g_statsFont || !GetEngineFont<Game>(g_statsFont))
+        return;
 
-            position0 += glyphAdvance;
-        }
+    char stats[512];
+    FormatFrameCounters(GetLastFrameCounters(), stats, sizeof(stats));
+
+    int lineHeight = EngineMember<int>(g_statsFont, Game::FontHeight);
+    int y = 0;
+    for(const char* line = stats; *line;)
+    {
+        const char* lineEnd = strchr(line, '\n');
+        int len = static_cast<int>(lineEnd ? lineEnd - line : strlen(line));
+        DrawString<Game>(g_statsFont, 0xFFFFFF00, 4, y, 1000000.f, line, len);
+        y += lineHeight;
+        line += (lineEnd ? len + 1 : len);
     }
+}
 
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x88))(zRenderer, oldAlphaFunc);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x50))(zRenderer, oldFilter);
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x74))(zRenderer, oldZCompare);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x6C))(zRenderer, oldZWrite);
+template<typename Game>
+void __fastcall zCViewPrint_BlitTextCharacters(DWORD zCViewPrint, DWORD zCViewText2, DWORD zCFont, DWORD& zCOLOR)
+{
+    HookFrameEnd(*reinterpret_cast<LPDIRECT3DDEVICE7*>(Game::Direct3DDevice));
+    BlitTextCharacters<Game>(zCViewPrint, zCViewText2, zCFont, zCOLOR);
 }
 
-void __fastcall G1_zCRenderer_ClearDevice(DWORD zCRnd_D3D)
+template<typename Game>
+void __fastcall zCRenderer_ClearDevice(DWORD zCRnd_D3D)
 {
     for(TTFont* ttFont : g_fonts)
-    {
-        for(auto& it : ttFont->cachedGlyphs)
-        {
-            LPDIRECTDRAWSURFACE7 texture = std::get<4>(it.second);
-            texture->Release();
-        }
-        ttFont->cachedGlyphs.clear();
-    }
+        ReleaseGlyphs(ttFont);
 
-    Org_G1_zCRenderer_ClearDevice(zCRnd_D3D);
+    Org_zCRenderer_ClearDevice<Game>(zCRnd_D3D);
 }
 
-int __fastcall G1_zFILE_VDFS_ReadString(DWORD zDisk_VDFS, DWORD _EDX, zSTRING_G1& str)
+template<typename Game>
+int __fastcall zFILE_VDFS_ReadString(DWORD zDisk_VDFS, DWORD _EDX, typename Game::VdfsString& str)
 {
-    if(!reinterpret_cast<BYTE*>(0x85F2CC))
-        return reinterpret_cast<int(__thiscall*)(DWORD, zSTRING_G1&)>(0x440790)(zDisk_VDFS, str);
+    if(!reinterpret_cast<BYTE*>(Game::VdfsActive))
+        return reinterpret_cast<int(__thiscall*)(DWORD, typename Game::VdfsString&)>(Game::zFILE_FILE_ReadString)(zDisk_VDFS, str);
 
     static std::string readedString; readedString.clear();
     if(readedString.capacity() < 10240)
         readedString.reserve(10240);
 
-    DWORD criticalSection = *reinterpret_cast<DWORD*>(0x85F2D0);
+    DWORD criticalSection = *reinterpret_cast<DWORD*>(Game::VdfsCriticalSection);
     if(criticalSection) reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(criticalSection) + 0x04))(criticalSection, -1);
     {
         char character = '\n';
         do
         {
-            int readVal = reinterpret_cast<int(__cdecl*)(DWORD, char*, int)>(*reinterpret_cast<DWORD*>(0x7D0498))(*reinterpret_cast<DWORD*>(zDisk_VDFS + 0x29FC), &character, 1);
+            int readVal = reinterpret_cast<int(__cdecl*)(DWORD, char*, int)>(*reinterpret_cast<DWORD*>(Game::VdfsRead))(*reinterpret_cast<DWORD*>(zDisk_VDFS + 0x29FC), &character, 1);
             if(readVal < 1)
                 *reinterpret_cast<BYTE*>(zDisk_VDFS + 0x2A04) = 1;
             else
@@ -877,603 +592,85 @@ int __fastcall G1_zFILE_VDFS_ReadString(DWORD zDisk_VDFS, DWORD _EDX, zSTRING_G1
         while(!readedString.empty() && (readedString.back() == '\n' || readedString.back() == '\r'))
             readedString.pop_back();
 
-        reinterpret_cast<void(__fastcall*)(zSTRING_G1&)>(0x401260)(str);
-        reinterpret_cast<void(__thiscall*)(zSTRING_G1&, const char*)>(0x4013A0)(str, readedString.c_str());
+        reinterpret_cast<void(__fastcall*)(typename Game::VdfsString&)>(Game::zSTRING_Clear)(str);
+        reinterpret_cast<void(__thiscall*)(typename Game::VdfsString&, const char*)>(Game::zSTRING_Assign)(str, readedString.c_str());
     }
     return 0;
 }
 
-int __fastcall G2_zCFont_LoadFontTexture(DWORD zCFont, DWORD _EDX, zSTRING_G2& fName)
+// The D3D device only exists once the game's renderer is up
+template<typename Game>
+bool HookGameFrameEnd()
 {
-    int size = 20, r = 0xFF, g = 0xFF, b = 0xFF, a = 0xFF;
-    std::string fontName(fName.ToChar(), fName.Length());
-    std::transform(fontName.begin(), fontName.end(), fontName.begin(), toupper);
-    if(fontName.find(':') == std::string::npos)
-    {
-        auto it = g_fontsWrapper.find(fontName);
-        if(it == g_fontsWrapper.end())
-        {
-            it = g_fontsWrapper.find("DEFAULT");
-            if(it == g_fontsWrapper.end())
-                return 0;
-        }
-        fontName.assign(it->second);
-    }
+    LPDIRECT3DDEVICE7 d3d7Device = *reinterpret_cast<LPDIRECT3DDEVICE7*>(Game::Direct3DDevice);
+    if(!d3d7Device)
+        return false;
 
-    std::string fntName;
-    ReadFontDetails(fontName, fntName, size, r, g, b, a);
-    if(g_useBGRA) std::swap(r, b);
-
-    if(g_useScaling && *reinterpret_cast<BYTE*>(0x789518) == 0xE9)
-    {
-        float UIscale = *reinterpret_cast<float*>(*reinterpret_cast<DWORD*>(0x66714F));
-        size = static_cast<int>(size * UIscale);
-    }
-    *reinterpret_cast<int*>(zCFont + 0x14) = size;
-
-    zSTRING_G2& path = reinterpret_cast<zSTRING_G2&(__thiscall*)(DWORD, int)>(0x465260)(*reinterpret_cast<DWORD*>(0x8CD988), 24);
-    fntName.insert(0, "\\_WORK\\FONTS\\G2_");
-    fntName.insert(0, path.ToChar(), path.Length());
-
-    TTFont* ttFont = new TTFont;
-    ttFont->r = r; ttFont->g = g; ttFont->b = b; ttFont->a = a;
-    *reinterpret_cast<TTFont**>(zCFont + 0x20) = ttFont;
-    if(FT_New_Face(g_ft, fntName.c_str(), 0, &ttFont->fontFace))
-    {
-        MessageBoxW(nullptr, L"Failed to load font", L"Gothic TTF", MB_ICONHAND);
-        exit(-1);
-    }
-    for(int i = 0; i < ttFont->fontFace->num_charmaps; ++i)
-    {
-        FT_CharMap charmap = ttFont->fontFace->charmaps[i];
-        if((charmap->platform_id == 3 && charmap->encoding_id == 1) /* Windows Unicode */
-            || (charmap->platform_id == 3 && charmap->encoding_id == 0) /* Windows Symbol */
-            || (charmap->platform_id == 2 && charmap->encoding_id == 1) /* ISO Unicode */
-            || (charmap->platform_id == 0)) /* Apple Unicode */
-        {
-            FT_Set_Charmap(ttFont->fontFace, charmap);
-            break;
-        }
-    }
-
-    FT_Set_Pixel_Sizes(ttFont->fontFace, 0, size);
-    if(FT_IS_SCALABLE(ttFont->fontFace))
-    {
-        FT_Fixed scale = ttFont->fontFace->size->metrics.y_scale;
-        int height = FT_MulFix(ttFont->fontFace->height, scale);
-        int ascent = FT_MulFix(ttFont->fontFace->ascender, scale);
-        int descent = FT_MulFix(ttFont->fontFace->descender, scale);
-        *reinterpret_cast<int*>(zCFont + 0x24) = static_cast<int>(((height + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x28) = static_cast<int>(((ascent + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x2C) = static_cast<int>(((descent + 63) & -64) / 64);
-    }
-    else
-    {
-        *reinterpret_cast<int*>(zCFont + 0x24) = static_cast<int>(((ttFont->fontFace->size->metrics.height + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x28) = static_cast<int>(((ttFont->fontFace->size->metrics.ascender + 63) & -64) / 64);
-        *reinterpret_cast<int*>(zCFont + 0x2C) = static_cast<int>(((ttFont->fontFace->size->metrics.descender + 63) & -64) / 64);
-    }
-
-    g_fonts.emplace(ttFont);
-    return 1;
+    HookFrameEnd(d3d7Device);
+    return true;
 }
 
-void __fastcall G2_zCFont_Destructor(DWORD zCFont)
+// The renderer draws the text itself once it batches so its own BlitText and Print hooks can come back
+static void RestoreRendererText()
 {
-    TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-    if(ttFont)
-    {
-        for(auto& it : ttFont->cachedGlyphs)
-        {
-            LPDIRECTDRAWSURFACE7 texture = std::get<4>(it.second);
-            texture->Release();
-        }
-        FT_Done_Face(ttFont->fontFace);
-        ttFont->cachedGlyphs.clear();
-        g_fonts.erase(ttFont);
-        delete ttFont;
-    }
-
-    Org_G2_zCFont_Destructor(zCFont);
+    for(auto it = g_rendererTextPatches.rbegin(); it != g_rendererTextPatches.rend(); ++it)
+        WriteStack(it->address, it->original, it->length);
+    g_rendererTextPatches.clear();
 }
 
-void __fastcall G2_zCView_RecalcChildsPos(DWORD zCView)
+template<size_t len>
+static void PatchRendererText(DWORD address, const char(&stack)[len])
 {
-    reinterpret_cast<void(__thiscall*)(DWORD)>(0x7A7540)(zCView);
-
-    DWORD zCFontMan = *reinterpret_cast<DWORD*>(0xAB39D4);
-    if(zCFontMan)
-    {
-        int fonts = *reinterpret_cast<int*>(zCFontMan + 0x08);
-        for(int i = 0; i < fonts; ++i)
-        {
-            DWORD zCFont = reinterpret_cast<DWORD(__thiscall*)(DWORD, int)>(0x7884B0)(zCFontMan, i);
-            if(zCFont)
-            {
-                // Delete current loaded font
-                TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-                if(ttFont)
-                {
-                    for(auto& it : ttFont->cachedGlyphs)
-                    {
-                        LPDIRECTDRAWSURFACE7 texture = std::get<4>(it.second);
-                        texture->Release();
-                    }
-                    FT_Done_Face(ttFont->fontFace);
-                    ttFont->cachedGlyphs.clear();
-                    g_fonts.erase(ttFont);
-                    delete ttFont;
-                    *reinterpret_cast<DWORD*>(zCFont + 0x20) = 0;
-                }
-
-                // Reload font using LoadFontTexture
-                reinterpret_cast<int(__thiscall*)(DWORD, DWORD)>(0x788510)(zCFont, zCFont);
-            }
-        }
-    }
+    CodePatch patch;
+    patch.address = address;
+    patch.length = static_cast<DWORD>(len - 1);
+    memcpy(patch.original, reinterpret_cast<const void*>(address), patch.length);
+    g_rendererTextPatches.push_back(patch);
+    WriteStack(address, stack);
 }
 
-int __fastcall G2_zCFont_GetFontY(DWORD zCFont)
+template<typename Game>
+void InstallGameHooks()
 {
-    return *reinterpret_cast<int*>(zCFont + 0x24) - *reinterpret_cast<int*>(zCFont + 0x2C);
-}
+    static D3D7RenderBackend<Game> renderBackend;
+    g_renderBackend = &renderBackend;
 
-int __fastcall G2_zCFont_GetFontX(DWORD zCFont, DWORD _EDX, zSTRING_G2& text)
-{
-    int fontHeight = *reinterpret_cast<int*>(zCFont + 0x14);
-    int width = 0;
-    const char* ctext = text.ToChar();
-    for(int i = 0, len = text.Length(); i < len;)
-    {
-        int utf8size;
-        uint32_t utf32 = UTF8toUTF32(ctext + i, len - i, utf8size);
-        i += utf8size;
-        if(utf32 <= 32)
-            width += fontHeight / 4;
-        else
-        {
-            TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-            auto it = ttFont->cachedGlyphs.find(utf32);
-            if(it == ttFont->cachedGlyphs.end())
-            {
-                if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                {
-                    MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                    exit(-1);
-                }
-                LPDIRECTDRAWSURFACE7 texture = nullptr;
-                float uv[4] = {};
-                LPDIRECTDRAW7 device = *reinterpret_cast<LPDIRECTDRAW7*>(0x9FC9EC);
-                LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                it = ttFont->cachedGlyphs.emplace(std::piecewise_construct, std::forward_as_tuple(utf32), std::forward_as_tuple(ttFont->fontFace->glyph->bitmap.width,
-                    ttFont->fontFace->glyph->bitmap.rows, ttFont->fontFace->glyph->bitmap_left, ttFont->fontFace->glyph->bitmap_top, texture, uv[0], uv[1], uv[2], uv[3],
-                    ttFont->fontFace->glyph->advance.x >> 6)).first;
-            }
-            width += std::get<9>(it->second);
-        }
-    }
-    return width;
-}
+    HookJMP(Game::zCFont_LoadFontTextureJump, reinterpret_cast<DWORD>(&zCFont_LoadFontTexture<Game>));
+    HookJMP(Game::zCFont_LoadFontTexture, reinterpret_cast<DWORD>(&zCFont_LoadFontTexture<Game>));
+    HookJMP(Game::zCFont_GetFontY, reinterpret_cast<DWORD>(&zCFont_GetFontY<Game>));
+    HookJMP(Game::zCFont_GetFontX, reinterpret_cast<DWORD>(&zCFont_GetFontX<Game>));
+    HookJMP(Game::zCView_PrintChars, reinterpret_cast<DWORD>(&zCView_PrintChars<Game>));
+    HookJMP(Game::zCViewPrint_BlitTextCharacters, reinterpret_cast<DWORD>(&zCViewPrint_BlitTextCharacters<Game>));
+    if(g_useEncoding == 0)
+        HookJMP(Game::zFILE_VDFS_ReadString, reinterpret_cast<DWORD>(&zFILE_VDFS_ReadString<Game>));
 
-void __fastcall G2_zCView_PrintChars(DWORD zCView, DWORD _EDX, int x, int y, zSTRING_G2& text)
-{
-    LPDIRECTDRAW7 device = *reinterpret_cast<LPDIRECTDRAW7*>(0x9FC9EC);
-    LPDIRECT3DDEVICE7 d3d7Device = *reinterpret_cast<LPDIRECT3DDEVICE7*>(0x9FC9F4);
-    DWORD zRenderer = *reinterpret_cast<DWORD*>(0x982F08);
-    DWORD zCFont = *reinterpret_cast<DWORD*>(zCView + 0x64);
-    DWORD zCOLOR = *reinterpret_cast<DWORD*>(zCView + 0x68);
-    int fontHeight = *reinterpret_cast<int*>(zCFont + 0x14);
-    int fontAscent = *reinterpret_cast<int*>(zCFont + 0x28);
-
-    int oldZWrite = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x80))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x84))(zRenderer, 0); // No depth-writes
-    int oldZCompare = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x90))(zRenderer);
-    int newZCompare = 0; // Compare always
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x94))(zRenderer, newZCompare);
-    int oldFilter = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x6C))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x68))(zRenderer, 0); // Non-Bilinear filter
-    int oldAlphaFunc = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0xAC))(zRenderer);
-    // Enable alpha blending
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 26, 0);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 27, 1);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 19, 5);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 20, 6);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 15, 0);
-    // Disable clipping
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 136, 0);
-    // Disable culling
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 22, 1);
-    // Set texture clamping
-    DWORD SetTextureStageState = *reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x17C);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 12, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 13, 3);
-    // 0 stage AlphaOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 3, 3);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage AlphaOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 3, 0);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage ColorOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 0, 0);
-    // 0 stage AlphaArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 4, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 5, 1);
-    // 0 stage ColorArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 1, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 2, 1);
-    // 0 stage TextureTransformFlags disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 23, 0);
-    // 0 stage TexCoordIndex 0
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 10, 0);
-
-    float clipRect = static_cast<float>(*reinterpret_cast<int*>(zCView + 0x54)) + (*reinterpret_cast<int*>(zCView + 0x5C));
-    const char* ctext = text.ToChar();
-    for(int i = 0, len = text.Length(); i < len;)
-    {
-        int utf8size;
-        uint32_t utf32 = UTF8toUTF32(ctext + i, len - i, utf8size);
-        i += utf8size;
-        if(utf32 <= 32)
-            x += fontHeight / 4;
-        else
-        {
-            LPDIRECTDRAWSURFACE7 texture = nullptr;
-            TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-            auto it = ttFont->cachedGlyphs.find(utf32);
-            if(it == ttFont->cachedGlyphs.end())
-            {
-                if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                {
-                    MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                    exit(-1);
-                }
-                float uv[4] = {};
-                LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                it = ttFont->cachedGlyphs.emplace(std::piecewise_construct, std::forward_as_tuple(utf32), std::forward_as_tuple(ttFont->fontFace->glyph->bitmap.width,
-                    ttFont->fontFace->glyph->bitmap.rows, ttFont->fontFace->glyph->bitmap_left, ttFont->fontFace->glyph->bitmap_top, texture, uv[0], uv[1], uv[2], uv[3],
-                    ttFont->fontFace->glyph->advance.x >> 6)).first;
-            }
-            else
-            {
-                texture = std::get<4>(it->second);
-                if(texture->IsLost() == DDERR_SURFACELOST)
-                {
-                    texture->Restore();
-
-                    if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                    {
-                        MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                        exit(-1);
-                    }
-                    float uv[4] = {};
-                    LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                }
-            }
-
-            unsigned int glyphWidth = std::get<0>(it->second);
-            unsigned int glyphHeight = std::get<1>(it->second);
-            int glyphLeft = std::get<2>(it->second);
-            int glyphTop = std::get<3>(it->second);
-            int glyphAdvance = std::get<9>(it->second);
-
-            float minx = static_cast<float>(x) + glyphLeft;
-            float miny = static_cast<float>(y) + fontAscent - glyphTop;
-            if(!g_GD3D11)
-            {
-                minx -= 0.5f;
-                miny -= 0.5f;
-            }
-            float maxx = minx + glyphWidth;
-            float maxy = miny + glyphHeight;
-
-            float minu = std::get<5>(it->second);
-            float maxu = std::get<6>(it->second);
-            float minv = std::get<7>(it->second);
-            float maxv = std::get<8>(it->second);
-
-            if(minx > clipRect) break;
-            {
-                struct D3DTLVERTEX
-                {
-                    float sx;
-                    float sy;
-                    float sz;
-                    float rhw;
-                    DWORD color;
-                    DWORD specular;
-                    float tu;
-                    float tv;
-                };
-                D3DTLVERTEX vertices[4];
-                vertices[0].sx = minx;
-                vertices[0].sy = miny;
-                vertices[0].sz = 1.f;
-                vertices[0].rhw = 1.f;
-                vertices[0].color = zCOLOR;
-                vertices[0].specular = 0xFFFFFFFF;
-                vertices[0].tu = minu;
-                vertices[0].tv = minv;
-
-                vertices[1].sx = maxx;
-                vertices[1].sy = miny;
-                vertices[1].sz = 1.f;
-                vertices[1].rhw = 1.f;
-                vertices[1].color = zCOLOR;
-                vertices[1].specular = 0xFFFFFFFF;
-                vertices[1].tu = maxu;
-                vertices[1].tv = minv;
-
-                vertices[2].sx = maxx;
-                vertices[2].sy = maxy;
-                vertices[2].sz = 1.f;
-                vertices[2].rhw = 1.f;
-                vertices[2].color = zCOLOR;
-                vertices[2].specular = 0xFFFFFFFF;
-                vertices[2].tu = maxu;
-                vertices[2].tv = maxv;
-
-                vertices[3].sx = minx;
-                vertices[3].sy = maxy;
-                vertices[3].sz = 1.f;
-                vertices[3].rhw = 1.f;
-                vertices[3].color = zCOLOR;
-                vertices[3].specular = 0xFFFFFFFF;
-                vertices[3].tu = minu;
-                vertices[3].tv = maxv;
-                reinterpret_cast<void(__thiscall*)(DWORD, int, LPDIRECTDRAWSURFACE7)>(0x650500)(zRenderer, 0, texture);
-                d3d7Device->DrawPrimitive(D3DPT_TRIANGLEFAN, D3DFVF_TLVERTEX, reinterpret_cast<LPVOID>(vertices), 4, 0);
-            }
+    WriteStack(Game::Separators, "\x20\x2D\x5F\x23\x2B\x2A\x7E\x60\x3D\x2F\x26\x25\x24\x22\x7B\x5B\x5D\x7D\x29\x5C\x0A\x00\x00");
+    WriteStack(Game::WordSeparators, "\x20\x23\x2B\x2A\x7E\x60\x3D\x2F\x26\x5C\x0A\x09\x00");
 
-            x += glyphAdvance;
-        }
-    }
-
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0xA8))(zRenderer, oldAlphaFunc);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x68))(zRenderer, oldFilter);
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x94))(zRenderer, oldZCompare);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x84))(zRenderer, oldZWrite);
-}
-
-void __fastcall G2_zCViewPrint_BlitTextCharacters(DWORD zCViewPrint, DWORD zCViewText2, DWORD zCFont, DWORD& zCOLOR)
-{
-    LPDIRECTDRAW7 device = *reinterpret_cast<LPDIRECTDRAW7*>(0x9FC9EC);
-    LPDIRECT3DDEVICE7 d3d7Device = *reinterpret_cast<LPDIRECT3DDEVICE7*>(0x9FC9F4);
-    DWORD zRenderer = *reinterpret_cast<DWORD*>(0x982F08);
-
-    zSTRING_G2* text = reinterpret_cast<zSTRING_G2*>(zCViewText2 + 0x14);
-    int position0 = *reinterpret_cast<int*>(zCViewText2 + 0x08);
-    int position1 = *reinterpret_cast<int*>(zCViewText2 + 0x0C);
-    position0 += *reinterpret_cast<int*>(zCViewPrint + 0x38);
-    position1 += *reinterpret_cast<int*>(zCViewPrint + 0x3C);
-    position0 += *reinterpret_cast<int*>(zCViewPrint + 0xD4);
-    position1 += *reinterpret_cast<int*>(zCViewPrint + 0xD8);
-
-    int oldZWrite = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x80))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x84))(zRenderer, 0); // No depth-writes
-    int oldZCompare = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x90))(zRenderer);
-    int newZCompare = 0; // Compare always
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x94))(zRenderer, newZCompare);
-    int oldFilter = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x6C))(zRenderer);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x68))(zRenderer, 0); // Non-Bilinear filter
-    int oldAlphaFunc = reinterpret_cast<int(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0xAC))(zRenderer);
-    // Enable alpha blending
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 26, 0);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 27, 1);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 19, 5);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 20, 6);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 15, 0);
-    // Disable clipping
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 136, 0);
-    // Disable culling
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int)>(0x644EF0)(zRenderer, 22, 1);
-    // Set texture clamping
-    DWORD SetTextureStageState = *reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x17C);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 12, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 13, 3);
-    // 0 stage AlphaOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 3, 3);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage AlphaOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 3, 0);
-    // 0 stage ColorOp modulate
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 0, 3);
-    // 1 stage ColorOp disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 1, 0, 0);
-    // 0 stage AlphaArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 4, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 5, 1);
-    // 0 stage ColorArg1/2 texure/diffuse
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 1, 3);
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 2, 1);
-    // 0 stage TextureTransformFlags disable
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 23, 0);
-    // 0 stage TexCoordIndex 0
-    reinterpret_cast<void(__thiscall*)(DWORD, int, int, int)>(SetTextureStageState)(zRenderer, 0, 10, 0);
-
-    float clipRect = static_cast<float>(*reinterpret_cast<int*>(zCViewPrint + 0x40) + *reinterpret_cast<int*>(zCViewPrint + 0x38));
-    int fontHeight = *reinterpret_cast<int*>(zCFont + 0x14);
-    int fontAscent = *reinterpret_cast<int*>(zCFont + 0x28);
-    const char* ctext = text->ToChar();
-    for(int i = 0, len = text->Length(); i < len;)
+    // Patch GD3D11 zCView::BlitText and zCView::Print functions to avoid incompatibility with GD3D11 text rendering optimization
+    if(g_GD3D11)
     {
-        int utf8size;
-        uint32_t utf32 = UTF8toUTF32(ctext + i, len - i, utf8size);
-        i += utf8size;
-        if(utf32 <= 32)
-            position0 += fontHeight / 4;
-        else
-        {
-            LPDIRECTDRAWSURFACE7 texture = nullptr;
-            TTFont* ttFont = *reinterpret_cast<TTFont**>(zCFont + 0x20);
-            auto it = ttFont->cachedGlyphs.find(utf32);
-            if(it == ttFont->cachedGlyphs.end())
-            {
-                if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                {
-                    MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                    exit(-1);
-                }
-                float uv[4] = {};
-                LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                it = ttFont->cachedGlyphs.emplace(std::piecewise_construct, std::forward_as_tuple(utf32), std::forward_as_tuple(ttFont->fontFace->glyph->bitmap.width,
-                    ttFont->fontFace->glyph->bitmap.rows, ttFont->fontFace->glyph->bitmap_left, ttFont->fontFace->glyph->bitmap_top, texture, uv[0], uv[1], uv[2], uv[3],
-                    ttFont->fontFace->glyph->advance.x >> 6)).first;
-            }
-            else
-            {
-                texture = std::get<4>(it->second);
-                if(texture->IsLost() == DDERR_SURFACELOST)
-                {
-                    texture->Restore();
-
-                    if(FT_Load_Char(ttFont->fontFace, utf32, FT_LOAD_RENDER))
-                    {
-                        MessageBoxW(nullptr, L"Failed to load Glyph", L"Gothic TTF", MB_ICONHAND);
-                        exit(-1);
-                    }
-                    float uv[4] = {};
-                    LoadGlyph(ttFont, device, texture, uv[0], uv[1], uv[2], uv[3]);
-                }
-            }
-
-            unsigned int glyphWidth = std::get<0>(it->second);
-            unsigned int glyphHeight = std::get<1>(it->second);
-            int glyphLeft = std::get<2>(it->second);
-            int glyphTop = std::get<3>(it->second);
-            int glyphAdvance = std::get<9>(it->second);
-
-            float minx = static_cast<float>(position0) + glyphLeft;
-            float miny = static_cast<float>(position1) + fontAscent - glyphTop;
-            if(!g_GD3D11)
-            {
-                minx -= 0.5f;
-                miny -= 0.5f;
-            }
-            float maxx = minx + glyphWidth;
-            float maxy = miny + glyphHeight;
-
-            float minu = std::get<5>(it->second);
-            float maxu = std::get<6>(it->second);
-            float minv = std::get<7>(it->second);
-            float maxv = std::get<8>(it->second);
-
-            if(minx > clipRect) break;
-            {
-                struct D3DTLVERTEX
-                {
-                    float sx;
-                    float sy;
-                    float sz;
-                    float rhw;
-                    DWORD color;
-                    DWORD specular;
-                    float tu;
-                    float tv;
-                };
-                D3DTLVERTEX vertices[4];
-                vertices[0].sx = minx;
-                vertices[0].sy = miny;
-                vertices[0].sz = 1.f;
-                vertices[0].rhw = 1.f;
-                vertices[0].color = zCOLOR;
-                vertices[0].specular = 0xFFFFFFFF;
-                vertices[0].tu = minu;
-                vertices[0].tv = minv;
-
-                vertices[1].sx = maxx;
-                vertices[1].sy = miny;
-                vertices[1].sz = 1.f;
-                vertices[1].rhw = 1.f;
-                vertices[1].color = zCOLOR;
-                vertices[1].specular = 0xFFFFFFFF;
-                vertices[1].tu = maxu;
-                vertices[1].tv = minv;
-
-                vertices[2].sx = maxx;
-                vertices[2].sy = maxy;
-                vertices[2].sz = 1.f;
-                vertices[2].rhw = 1.f;
-                vertices[2].color = zCOLOR;
-                vertices[2].specular = 0xFFFFFFFF;
-                vertices[2].tu = maxu;
-                vertices[2].tv = maxv;
-
-                vertices[3].sx = minx;
-                vertices[3].sy = maxy;
-                vertices[3].sz = 1.f;
-                vertices[3].rhw = 1.f;
-                vertices[3].color = zCOLOR;
-                vertices[3].specular = 0xFFFFFFFF;
-                vertices[3].tu = minu;
-                vertices[3].tv = maxv;
-                reinterpret_cast<void(__thiscall*)(DWORD, int, LPDIRECTDRAWSURFACE7)>(0x650500)(*reinterpret_cast<DWORD*>(0x982F08), 0, texture);
-                d3d7Device->DrawPrimitive(D3DPT_TRIANGLEFAN, D3DFVF_TLVERTEX, reinterpret_cast<LPVOID>(vertices), 4, 0);
-            }
-
-            position0 += glyphAdvance;
-        }
-    }
-
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0xA8))(zRenderer, oldAlphaFunc);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x68))(zRenderer, oldFilter);
-    reinterpret_cast<void(__thiscall*)(DWORD, int&)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x94))(zRenderer, oldZCompare);
-    reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(zRenderer) + 0x84))(zRenderer, oldZWrite);
-}
-
-void __fastcall G2_zCRenderer_ClearDevice(DWORD zCRnd_D3D)
-{
-    for(TTFont* ttFont : g_fonts)
-    {
-        for(auto& it : ttFont->cachedGlyphs)
-        {
-            LPDIRECTDRAWSURFACE7 texture = std::get<4>(it.second);
-            texture->Release();
-        }
-        ttFont->cachedGlyphs.clear();
+        if(*reinterpret_cast<BYTE*>(Game::zCView_BlitText) == 0xE9) PatchRendererText(Game::zCView_BlitText, "\x83\xEC\x08\x53\x55");
+        if(*reinterpret_cast<BYTE*>(Game::zCView_Print) == 0xE9) PatchRendererText(Game::zCView_Print, "\x83\xEC\x08\x56\x8B\xF1");
     }
 
-    Org_G2_zCRenderer_ClearDevice(zCRnd_D3D);
-}
-
-int __fastcall G2_zFILE_VDFS_ReadString(DWORD zDisk_VDFS, DWORD _EDX, zSTRING_G2& str)
-{
-    if(!reinterpret_cast<BYTE*>(0x8C34C4))
-        return reinterpret_cast<int(__thiscall*)(DWORD, zSTRING_G2&)>(0x4446B0)(zDisk_VDFS, str);
-
-    static std::string readedString; readedString.clear();
-    if(readedString.capacity() < 10240)
-        readedString.reserve(10240);
-
-    DWORD criticalSection = *reinterpret_cast<DWORD*>(0x8C34C8);
-    if(criticalSection) reinterpret_cast<void(__thiscall*)(DWORD, int)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(criticalSection) + 0x04))(criticalSection, -1);
-    {
-        char character;
-        do
-        {
-            int readVal = reinterpret_cast<int(__cdecl*)(DWORD, char*, int)>(*reinterpret_cast<DWORD*>(0x82E638))(*reinterpret_cast<DWORD*>(zDisk_VDFS + 0x29FC), &character, 1);
-            if(readVal < 1)
-                *reinterpret_cast<BYTE*>(zDisk_VDFS + 0x2A04) = 1;
-            else
-                readedString.append(1, character);
-        } while(!(*reinterpret_cast<BYTE*>(zDisk_VDFS + 0x2A04)) && character != '\n');
-    }
-    if(criticalSection) reinterpret_cast<void(__thiscall*)(DWORD)>(*reinterpret_cast<DWORD*>(*reinterpret_cast<DWORD*>(criticalSection) + 0x08))(criticalSection);
-    {
-        // erase any carriage return and newline
-        while(!readedString.empty() && (readedString.back() == '\n' || readedString.back() == '\r'))
-            readedString.pop_back();
-
-        reinterpret_cast<void(__fastcall*)(zSTRING_G2&)>(0x401160)(str);
-        reinterpret_cast<void(__thiscall*)(zSTRING_G2&, const char*)>(0x4010C0)(str, readedString.c_str());
-    }
-    return 0;
+    HookCall(Game::zCView_RecalcChildsPosCall, reinterpret_cast<DWORD>(&zCView_RecalcChildsPos<Game>));
+    Org_zCFont_Destructor<Game> = reinterpret_cast<_Org_zCFont_Destructor>(DetourFunction(reinterpret_cast<BYTE*>(Game::zCFont_Destructor), reinterpret_cast<BYTE*>(&zCFont_Destructor<Game>)));
+    Org_zCRenderer_ClearDevice<Game> = reinterpret_cast<_Org_zCRenderer_ClearDevice>(DetourFunction(reinterpret_cast<BYTE*>(Game::zCRnd_D3D_ClearDevice), reinterpret_cast<BYTE*>(&zCRenderer_ClearDevice<Game>)));
+    if(Game::zCView_Printwin)
+        Org_zCView_Printwin<Game> = reinterpret_cast<_Org_zCView_Printwin>(DetourFunction(reinterpret_cast<BYTE*>(Game::zCView_Printwin), reinterpret_cast<BYTE*>(&zCView_Printwin<Game>)));
+    else
+        LogMessage("zCView::Printwin isn't known for this executable, the engine's word wrap keeps breaking at the separators");
+    g_drawStatsOverlay = &DrawStatsOverlay<Game>;
+    g_resolveFontFile = &ResolveFontFile<Game>;
+    g_hookFrameEnd = &HookGameFrameEnd<Game>;
+    g_restoreRendererText = &RestoreRendererText;
 }
 
 static void ReadConfigurationFile()
 {
+    TTF_PROFILE_SCOPE("ReadConfigurationFile");
+
     char cfgPath[MAX_PATH];
     GetModuleFileNameA(GetModuleHandleA(nullptr), cfgPath, sizeof(cfgPath));
     PathRemoveFileSpecA(cfgPath);
@@ -1524,6 +721,96 @@ static void ReadConfigurationFile()
                     {
                         if(lhLine == "SCALEFONTS")
                             g_useScaling = (rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "BIDI")
+                            g_bidiCache.SetReordering(rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "COMPOSEMARKS")
+                            g_bidiCache.SetComposition(rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "ARABICSHAPING")
+                            g_bidiCache.SetShaping(rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "DIRECTRASTERIZATION")
+                            g_useDirectRaster = (rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "TEXTUREFORMAT")
+                            g_textureFormat = ((rhLine == "A8L8" || rhLine == "LUMINANCE") ? GlyphFormat_A8L8 : GlyphFormat_BGRA8888);
+                        else if(lhLine == "GAMMA")
+                        {
+                            try {g_textGamma = std::stof(rhLine);}
+                            catch(const std::exception&) {g_textGamma = 1.f;}
+                        }
+                        else if(lhLine == "MAXFACES")
+                        {
+                            try {g_maxFaces = static_cast<FT_UInt>(std::stoul(rhLine));}
+                            catch(const std::exception&) {g_maxFaces = 8;}
+                        }
+                        else if(lhLine == "MAXSIZES")
+                        {
+                            try {g_maxSizes = static_cast<FT_UInt>(std::stoul(rhLine));}
+                            catch(const std::exception&) {g_maxSizes = 16;}
+                        }
+                        else if(lhLine == "MAXCACHEKB")
+                        {
+                            try {g_maxBytes = static_cast<FT_ULong>(std::stoul(rhLine)) * 1024;}
+                            catch(const std::exception&) {g_maxBytes = 4 * 1024 * 1024;}
+                        }
+                        else if(lhLine == "SMALLBITMAPSIZE")
+                        {
+                            try {g_sbitMaxSize = std::stoi(rhLine);}
+                            catch(const std::exception&) {g_sbitMaxSize = 32;}
+                        }
+                        else if(lhLine == "VRAMBUDGETKB")
+                        {
+                            try {g_textureTracker.SetBudget(static_cast<size_t>(std::stoul(rhLine)) * 1024);}
+                            catch(const std::exception&) {g_textureTracker.SetBudget(0);}
+                        }
+                        else if(lhLine == "ATLASPAGESIZE")
+                        {
+                            try {g_glyphAtlas.SetPageSize(static_cast<unsigned int>(std::stoul(rhLine)));}
+                            catch(const std::exception&) {g_glyphAtlas.SetPageSize(0);}
+                        }
+                        else if(lhLine == "HITCHTHRESHOLDMS")
+                        {
+                            try {g_hitchReport.SetThreshold(std::stod(rhLine));}
+                            catch(const std::exception&) {g_hitchReport.SetThreshold(0.0);}
+                        }
+                        else if(lhLine == "TELEMETRY")
+                            g_publishTelemetry = (rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "STATSOVERLAY")
+                            g_useStatsOverlay = (rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "STATSLOGINTERVAL")
+                        {
+                            try {g_statsLogInterval = std::stoi(rhLine);}
+                            catch(const std::exception&) {g_statsLogInterval = 0;}
+                        }
+                        else if(lhLine == "CAPTURETRACE")
+                            g_captureTrace = (rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "GLYPHUSAGE")
+                            g_recordUsage = (rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "PREWARMGLYPHS")
+                        {
+                            try {g_prewarmGlyphs = std::stoi(rhLine);}
+                            catch(const std::exception&) {g_prewarmGlyphs = 0;}
+                        }
+                        else if(lhLine == "PREWARMBUDGETMS")
+                        {
+                            try {g_prewarmBudgetMs = std::stod(rhLine);}
+                            catch(const std::exception&) {g_prewarmBudgetMs = 2.0;}
+                        }
+                        else if(lhLine == "DEBUGLOG")
+                            g_useLog = (rhLine == "TRUE" || rhLine == "1");
+                        else if(lhLine == "FREETYPEMODULES")
+                        {
+                            g_ftModules.clear();
+                            size_t pos = 0, start = 0;
+                            do
+                            {
+                                pos = rhLine.find(',', start);
+                                std::string moduleName = rhLine.substr(start, (pos == std::string::npos ? rhLine.length() : pos) - start);
+                                moduleName.erase(moduleName.find_last_not_of(' ') + 1);
+                                moduleName.erase(0, moduleName.find_first_not_of(' '));
+                                if(!moduleName.empty())
+                                    g_ftModules.emplace_back(std::move(moduleName));
+                                start = pos + 1;
+                            } while(pos != std::string::npos);
+                        }
                         else if(lhLine == "CODEPAGE")
                         {
                             if(rhLine == "WINDOWS-1250" || rhLine == "WINDOWS1250" || rhLine == "WINDOWS 1250" || rhLine == "1250")
@@ -1553,18 +840,67 @@ static void ReadConfigurationFile()
                 }
             }
         }
+        fclose(f);
     }
+
+    // Periodic text statistics, hitch reports and video memory budget warnings go to the same log
+    if(g_statsLogInterval > 0 || g_hitchReport.IsEnabled() || g_textureTracker.GetBudget() > 0)
+        g_useLog = true;
+
+    PathRemoveFileSpecA(cfgPath);
+    g_profilePath = std::string(cfgPath) + "\\TTFProfile.json";
+    g_atlasDumpPath = std::string(cfgPath) + "\\TTFAtlas";
+    if(g_captureTrace)
+        g_textTrace.Open((std::string(cfgPath) + "\\TTF.trace").c_str(), g_useEncoding);
+    if(g_recordUsage)
+    {
+        // Every session gets its own histogram so they can be merged later
+        SYSTEMTIME now;
+        GetLocalTime(&now);
+        char usageName[64];
+        sprintf_s(usageName, "\\TTFUsage_%04u%02u%02u_%02u%02u%02u.txt", now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond);
+        g_usagePath = std::string(cfgPath) + usageName;
+    }
+    if(g_prewarmGlyphs > 0)
+        g_prewarmPath = std::string(cfgPath) + "\\TTFPrewarm.txt";
+
+    if(g_useLog)
+    {
+        strcat_s(cfgPath, "\\TTF.log");
+        LogOpen(cfgPath);
+    }
+    if(g_publishTelemetry && !g_telemetry.Open(TTF_TELEMETRY_NAME))
+        LogMessage("Could not publish telemetry as %s, another game may be publishing it already", TTF_TELEMETRY_NAME);
 }
 
 BOOL WINAPI DllMain(HINSTANCE hInst, DWORD reason, LPVOID)
 {
     if(reason == DLL_PROCESS_ATTACH)
     {
-        if(FT_Init_FreeType(&g_ft))
+        LARGE_INTEGER attachStart, attachEnd, frequency;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&attachStart);
+        TTF_PROFILE_SCOPE("DllAttach");
+
+        // Configuration have to be read first because it selects the FreeType modules
+        ReadConfigurationFile();
+        g_showFatalError = &ShowFatalError;
+
+        LARGE_INTEGER freeTypeStart, freeTypeEnd;
+        SIZE_T privateBytes = GetPrivateBytes();
+        QueryPerformanceCounter(&freeTypeStart);
+        if(!InitializeFreeType(&AddFreeTypeModules))
         {
             MessageBoxW(nullptr, L"Could not initialize FreeType Library", L"Gothic TTF", MB_ICONHAND);
             return FALSE;
         }
+        QueryPerformanceCounter(&freeTypeEnd);
+        LogMessage("FreeType initialized in %.3f ms, private bytes grew by %d KiB", static_cast<double>(freeTypeEnd.QuadPart - freeTypeStart.QuadPart) * 1000.0 / frequency.QuadPart,
+            static_cast<int>((static_cast<LONGLONG>(GetPrivateBytes()) - static_cast<LONGLONG>(privateBytes)) / 1024));
+        LogFreeTypeMemory();
+
+        if(g_prewarmGlyphs > 0 && !g_prewarmManifest.Load(g_prewarmPath.c_str()))
+            LogMessage("Could not read prewarm manifest %s", g_prewarmPath.c_str());
 
         HMODULE ddrawdll = GetModuleHandleA("ddraw.dll");
         if(ddrawdll && GetProcAddress(ddrawdll, "GDX_AddPointLocator"))
@@ -1572,68 +908,40 @@ BOOL WINAPI DllMain(HINSTANCE hInst, DWORD reason, LPVOID)
             g_GD3D11 = true;
             if(!GetProcAddress(ddrawdll, "IsUsingBGRATextures"))
                 g_useBGRA = false;
-        }
 
-        ReadConfigurationFile();
+            // GD3D11 only expects 32-bit glyph textures
+            g_textureFormat = GlyphFormat_BGRA8888;
+            g_halfPixelOffset = false;
+        }
 
         DWORD baseAddr = reinterpret_cast<DWORD>(GetModuleHandleA(nullptr));
         // G1_08k
         if(*reinterpret_cast<DWORD*>(baseAddr + 0x160) == 0x37A8D8 && *reinterpret_cast<DWORD*>(baseAddr + 0x37A960) == 0x7D01E4 && *reinterpret_cast<DWORD*>(baseAddr + 0x37A98B) == 0x7D01E8)
-        {
-            HookJMP(0x6DF871, reinterpret_cast<DWORD>(&G1_zCFont_LoadFontTexture));
-            HookJMP(0x6DF280, reinterpret_cast<DWORD>(&G1_zCFont_LoadFontTexture));
-            HookJMP(0x6E0200, reinterpret_cast<DWORD>(&G1_zCFont_GetFontY));
-            HookJMP(0x6E0210, reinterpret_cast<DWORD>(&G1_zCFont_GetFontX));
-            HookJMP(0x6FFF80, reinterpret_cast<DWORD>(&G1_zCView_PrintChars));
-            HookJMP(0x756B20, reinterpret_cast<DWORD>(&G1_zCViewPrint_BlitTextCharacters));
-            if(g_useEncoding == 0)
-                HookJMP(0x446750, reinterpret_cast<DWORD>(&G1_zFILE_VDFS_ReadString));
-
-            WriteStack(0x858D70, "\x20\x2D\x5F\x23\x2B\x2A\x7E\x60\x3D\x2F\x26\x25\x24\x22\x7B\x5B\x5D\x7D\x29\x5C\x0A\x00\x00");
-            WriteStack(0x852E38, "\x20\x23\x2B\x2A\x7E\x60\x3D\x2F\x26\x5C\x0A\x09\x00");
-            
-            // Patch GD3D11 zCView::BlitText and zCView::Print functions to avoid incompatibility with GD3D11 text rendering optimization
-            if(g_GD3D11)
-            {
-                if(*reinterpret_cast<BYTE*>(0x6FC7B0) == 0xE9) WriteStack(0x6FC7B0, "\x83\xEC\x08\x53\x55");
-                if(*reinterpret_cast<BYTE*>(0x6FFEB0) == 0xE9) WriteStack(0x6FFEB0, "\x83\xEC\x08\x56\x8B\xF1");
-            }
-
-            HookCall(0x70232A, reinterpret_cast<DWORD>(&G1_zCView_RecalcChildsPos));
-            Org_G1_zCFont_Destructor = reinterpret_cast<_Org_G1_zCFont_Destructor>(DetourFunction(reinterpret_cast<BYTE*>(0x6DF6A0), reinterpret_cast<BYTE*>(&G1_zCFont_Destructor)));
-            Org_G1_zCRenderer_ClearDevice = reinterpret_cast<_Org_G1_zCRenderer_ClearDevice>(DetourFunction(reinterpret_cast<BYTE*>(0x7123F0), reinterpret_cast<BYTE*>(&G1_zCRenderer_ClearDevice)));
-        }
+            InstallGameHooks<G1Traits>();
         // G2.6fix
         if(*reinterpret_cast<DWORD*>(baseAddr + 0x168) == 0x3D4318 && *reinterpret_cast<DWORD*>(baseAddr + 0x3D43A0) == 0x82E108 && *reinterpret_cast<DWORD*>(baseAddr + 0x3D43CB) == 0x82E10C)
-        {
-            HookJMP(0x788AF1, reinterpret_cast<DWORD>(&G2_zCFont_LoadFontTexture));
-            HookJMP(0x788510, reinterpret_cast<DWORD>(&G2_zCFont_LoadFontTexture));
-            HookJMP(0x7894E0, reinterpret_cast<DWORD>(&G2_zCFont_GetFontY));
-            HookJMP(0x7894F0, reinterpret_cast<DWORD>(&G2_zCFont_GetFontX));
-            HookJMP(0x7A9B10, reinterpret_cast<DWORD>(&G2_zCView_PrintChars));
-            HookJMP(0x693650, reinterpret_cast<DWORD>(&G2_zCViewPrint_BlitTextCharacters));
-            if(g_useEncoding == 0)
-                HookJMP(0x44AA80, reinterpret_cast<DWORD>(&G2_zFILE_VDFS_ReadString));
-
-            WriteStack(0x8B0E20, "\x20\x2D\x5F\x23\x2B\x2A\x7E\x60\x3D\x2F\x26\x25\x24\x22\x7B\x5B\x5D\x7D\x29\x5C\x0A\x00\x00");
-            WriteStack(0x8BC8F4, "\x20\x23\x2B\x2A\x7E\x60\x3D\x2F\x26\x5C\x0A\x09\x00");
-
-            // Patch GD3D11 zCView::BlitText and zCView::Print functions to avoid incompatibility with GD3D11 text rendering optimization
-            if(g_GD3D11)
-            {
-                if(*reinterpret_cast<BYTE*>(0x7A62A0) == 0xE9) WriteStack(0x7A62A0, "\x83\xEC\x08\x53\x55");
-                if(*reinterpret_cast<BYTE*>(0x7A9A40) == 0xE9) WriteStack(0x7A9A40, "\x83\xEC\x08\x56\x8B\xF1");
-            }
-
-            HookCall(0x7ABF4A, reinterpret_cast<DWORD>(&G2_zCView_RecalcChildsPos));
-            Org_G2_zCFont_Destructor = reinterpret_cast<_Org_G2_zCFont_Destructor>(DetourFunction(reinterpret_cast<BYTE*>(0x788920), reinterpret_cast<BYTE*>(&G2_zCFont_Destructor)));
-            Org_G2_zCRenderer_ClearDevice = reinterpret_cast<_Org_G2_zCRenderer_ClearDevice>(DetourFunction(reinterpret_cast<BYTE*>(0x648820), reinterpret_cast<BYTE*>(&G2_zCRenderer_ClearDevice)));
-        }
+            InstallGameHooks<G2Traits>();
         g_initialized = true;
+
+        QueryPerformanceCounter(&attachEnd);
+        LogMessage("DLL attach took %.3f ms", static_cast<double>(attachEnd.QuadPart - attachStart.QuadPart) * 1000.0 / frequency.QuadPart);
     }
     else if(reason == DLL_PROCESS_DETACH && g_initialized)
     {
-        FT_Done_FreeType(g_ft);
+        LogFontCacheStats();
+        g_textureTracker.LogReport();
+#ifdef TTF_ALLOC_TRACKING
+        if(g_allocatingFrames != 0)
+            LogMessage("%u steady-state frames allocated this session", g_allocatingFrames);
+#endif
+        LogFreeTypeMemory();
+        ShutdownFreeType();
+        g_textTrace.Close();
+        g_telemetry.Close();
+        if(g_recordUsage && g_glyphUsage.Save(g_usagePath.c_str()))
+            LogMessage("Glyph usage written to %s", g_usagePath.c_str());
+        TTF_PROFILE_DUMP(g_profilePath.c_str());
+        LogClose();
     }
     return TRUE;
 }
@@ -0,0 +1,52 @@
+#include "enginetext.h"
+
+int g_useEncoding = 0;
+PrefixMeasure g_lineMeasure;
+
+struct EngineLineText
+{
+    TTFont* font;
+    int spaceWidth;
+    const char* text;
+};
+
+static int MeasureEngineLine(const void* context, int start, int end)
+{
+    const EngineLineText& layout = *static_cast<const EngineLineText*>(context);
+    return MeasureGlyphs(layout.font, layout.spaceWidth, g_useEncoding, layout.text + start, end - start);
+}
+
+bool BreakEngineText(TTFont* ttFont, int spaceWidth, int maxWidth, const char* text, int len, std::string& broken)
+{
+    static TextParagraph paragraph;
+    static std::vector<TextLine> lines;
+    // Lines get the widths GetFontX gives them, measured as drawn when the bidi cache changes the text
+    EngineLineText layout = {ttFont, spaceWidth, text};
+    bool measureLines = g_bidiCache.IsNeeded(g_useEncoding, text, len);
+    WrapText(g_useEncoding, text, len, spaceWidth, maxWidth, [ttFont](uint32_t utf32)
+    {
+        return GetGlyphAdvance(ttFont, utf32);
+    }, paragraph, lines, measureLines ? &MeasureEngineLine : nullptr, &layout);
+
+    bool inserted = false;
+    broken.clear();
+    for(size_t i = 0; i + 1 < lines.size(); ++i)
+    {
+        // Everything up to the next line stays, the spaces a break falls on become its line feed
+        int start = lines[i].start;
+        int end = lines[i + 1].start;
+        if(end > start && text[end - 1] == '\n')
+        {
+            broken.append(text + start, static_cast<size_t>(end - start));
+            continue;
+        }
+        while(end > start + 1 && (text[end - 1] == ' ' || text[end - 1] == '\t'))
+            --end;
+        broken.append(text + start, static_cast<size_t>(end - start));
+        broken.push_back('\n');
+        inserted = true;
+    }
+    if(!lines.empty())
+        broken.append(text + lines.back().start, static_cast<size_t>(len - lines.back().start));
+    return inserted;
+}
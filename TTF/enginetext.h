@@ -0,0 +1,111 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+#include "glyphcache.h"
+#include "textcore.h"
+#include "textstats.h"
+#include "texttrace.h"
+
+// What the engine hooks do with the engine's objects, templates over the game traits like the hooks themselves
+// Objects are plain addresses read at the traits' member offsets so nothing in here needs Win32 or the engine,
+// the hooks add the frame end and the renderer and the tests instantiate them against a fake engine
+
+extern int g_useEncoding;
+// The engine's word wrap measures the line it builds again after every word
+extern PrefixMeasure g_lineMeasure;
+
+// Copies text to broken with a line feed at every UAX #14 break that wraps it to maxWidth and isn't a line feed already,
+// the spaces a break falls on are dropped, false when the text fits without new breaks
+bool BreakEngineText(TTFont* ttFont, int spaceWidth, int maxWidth, const char* text, int len, std::string& broken);
+
+template<typename T>
+T& EngineMember(uintptr_t object, uintptr_t offset)
+{
+    return *reinterpret_cast<T*>(object + offset);
+}
+
+template<typename Game>
+TTFont* GetEngineFont(uintptr_t zCFont)
+{
+    return EngineMember<TTFont*>(zCFont, Game::FontTTF);
+}
+
+// What zCFont::LoadFontTexture would have filled in from the font's texture
+template<typename Game>
+void SetEngineFont(uintptr_t zCFont, TTFont* ttFont)
+{
+    EngineMember<int>(zCFont, Game::FontSize) = static_cast<int>(ttFont->scaler.height);
+    EngineMember<TTFont*>(zCFont, Game::FontTTF) = ttFont;
+    EngineMember<int>(zCFont, Game::FontHeight) = ttFont->height;
+    EngineMember<int>(zCFont, Game::FontAscent) = ttFont->ascent;
+    EngineMember<int>(zCFont, Game::FontDescent) = ttFont->descent;
+}
+
+template<typename Game>
+int GetFontY(uintptr_t zCFont)
+{
+    return EngineMember<int>(zCFont, Game::FontHeight) - EngineMember<int>(zCFont, Game::FontDescent);
+}
+
+template<typename Game>
+int GetFontX(uintptr_t zCFont, const typename Game::ViewString& text)
+{
+    int fontHeight = EngineMember<int>(zCFont, Game::FontSize);
+    ++g_textCounters.measureCalls;
+    TTFont* ttFont = GetEngineFont<Game>(zCFont);
+    g_textTrace.Measure(ttFont->traceId, text.ToChar(), text.Length());
+    return MeasurePrefix(g_lineMeasure, ttFont, fontHeight / 4, g_useEncoding, text.ToChar(), text.Length());
+}
+
+template<typename Game>
+void DrawString(uintptr_t zCFont, uint32_t zCOLOR, int x, int y, float clipRect, const char* ctext, int len)
+{
+    ++g_textCounters.drawCalls;
+    g_textCounters.stateChanges += TEXT_SETUP_STATE_CHANGES;
+    int fontHeight = EngineMember<int>(zCFont, Game::FontSize);
+    int fontAscent = EngineMember<int>(zCFont, Game::FontAscent);
+    TTFont* ttFont = GetEngineFont<Game>(zCFont);
+
+    g_renderBackend->BeginText();
+    DrawGlyphs(ttFont, x, y + fontAscent, fontHeight / 4, clipRect, GetGlyphColor(ttFont, zCOLOR), g_useEncoding, ctext, len);
+    g_renderBackend->EndText();
+}
+
+// zCView::PrintChars in the view's font and color, clipped to the view's right edge
+template<typename Game>
+void PrintChars(uintptr_t zCView, int x, int y, const typename Game::ViewString& text)
+{
+    uintptr_t zCFont = EngineMember<uintptr_t>(zCView, Game::ViewFont);
+    uint32_t zCOLOR = EngineMember<uint32_t>(zCView, Game::ViewColor);
+    float clipRect = static_cast<float>(EngineMember<int>(zCView, Game::ViewPixelX)) + EngineMember<int>(zCView, Game::ViewPixelWidth);
+    g_textTrace.Text(TextTrace_Print, GetEngineFont<Game>(zCFont)->traceId, x, y, zCOLOR, text.ToChar(), text.Length());
+    DrawString<Game>(zCFont, zCOLOR, x, y, clipRect, text.ToChar(), text.Length());
+}
+
+// zCViewPrint::BlitTextCharacters, the text's position is relative to the view and the view's text offset
+template<typename Game>
+void BlitTextCharacters(uintptr_t zCViewPrint, uintptr_t zCViewText2, uintptr_t zCFont, uint32_t zCOLOR)
+{
+    const typename Game::ViewString& text = EngineMember<typename Game::ViewString>(zCViewText2, Game::ViewTextString);
+    int position0 = EngineMember<int>(zCViewText2, Game::ViewTextX);
+    int position1 = EngineMember<int>(zCViewText2, Game::ViewTextY);
+    position0 += EngineMember<int>(zCViewPrint, Game::ViewPrintPixelX);
+    position1 += EngineMember<int>(zCViewPrint, Game::ViewPrintPixelY);
+    position0 += EngineMember<int>(zCViewPrint, Game::ViewPrintTextOffsetX);
+    position1 += EngineMember<int>(zCViewPrint, Game::ViewPrintTextOffsetY);
+    g_textTrace.Text(TextTrace_Blit, GetEngineFont<Game>(zCFont)->traceId, position0, position1, zCOLOR, text.ToChar(), text.Length());
+
+    float clipRect = static_cast<float>(EngineMember<int>(zCViewPrint, Game::ViewPrintPixelWidth) + EngineMember<int>(zCViewPrint, Game::ViewPrintPixelX));
+    DrawString<Game>(zCFont, zCOLOR, position0, position1, clipRect, text.ToChar(), text.Length());
+}
+
+// zCView::Printwin wraps text to the view's width word by word at the separators, the text it gets instead
+// has a line feed at every break the one-pass line breaking picks so the engine never has to break a line itself
+template<typename Game>
+bool BreakViewText(uintptr_t zCView, const typename Game::ViewString& text, std::string& broken)
+{
+    uintptr_t zCFont = EngineMember<uintptr_t>(zCView, Game::ViewFont);
+    int spaceWidth = EngineMember<int>(zCFont, Game::FontSize) / 4;
+    return BreakEngineText(GetEngineFont<Game>(zCFont), spaceWidth, EngineMember<int>(zCView, Game::ViewPixelWidth), text.ToChar(), text.Length(), broken);
+}
@@ -0,0 +1,125 @@
+#include "facecache.h"
+#include "profiler.h"
+
+// Marks sizes that were already seen so re-created ones can be counted as misses
+static char g_sizeSeen;
+
+FT_Error FaceCache::RequestFace(FTC_FaceID faceID, FT_Library library, FT_Pointer requestData, FT_Face* aface)
+{
+    FaceCache* cache = reinterpret_cast<FaceCache*>(requestData);
+    const std::string* path = reinterpret_cast<const std::string*>(faceID);
+    ++cache->m_stats.faceMisses;
+
+    FTArenaScope arenaScope(*cache->m_allocator, FTArena_Face);
+    FT_Error error;
+    {
+        TTF_PROFILE_SCOPE_DETAIL("FT_New_Face", path->c_str());
+        error = FT_New_Face(library, path->c_str(), 0, aface);
+    }
+    if(error)
+        return error;
+
+    TTF_PROFILE_SCOPE("SelectCharmap");
+    FT_Face face = *aface;
+    for(int i = 0; i < face->num_charmaps; ++i)
+    {
+        FT_CharMap charmap = face->charmaps[i];
+        if((charmap->platform_id == 3 && charmap->encoding_id == 1) /* Windows Unicode */
+            || (charmap->platform_id == 3 && charmap->encoding_id == 0) /* Windows Symbol */
+            || (charmap->platform_id == 2 && charmap->encoding_id == 1) /* ISO Unicode */
+            || (charmap->platform_id == 0)) /* Apple Unicode */
+        {
+            FT_Set_Charmap(face, charmap);
+            break;
+        }
+    }
+    return 0;
+}
+
+bool FaceCache::Init(FT_Library library, FTPoolAllocator& allocator, FT_UInt maxFaces, FT_UInt maxSizes, FT_ULong maxBytes)
+{
+    m_allocator = &allocator;
+
+    FTArenaScope arenaScope(allocator, FTArena_Face);
+    if(FTC_Manager_New(library, maxFaces, maxSizes, maxBytes, RequestFace, this, &m_manager))
+        return false;
+    if(FTC_CMapCache_New(m_manager, &m_cmapCache) || FTC_SBitCache_New(m_manager, &m_sbitCache))
+    {
+        Done();
+        return false;
+    }
+    return true;
+}
+
+void FaceCache::Done()
+{
+    if(m_manager)
+    {
+        FTC_Manager_Done(m_manager);
+        m_manager = nullptr;
+        m_cmapCache = nullptr;
+        m_sbitCache = nullptr;
+    }
+}
+
+FTC_FaceID FaceCache::GetFaceID(const std::string& path)
+{
+    // Keys of node based containers never move so their address can serve as the face ID
+    const std::string& faceID = *m_faceIDs.emplace(path).first;
+    return reinterpret_cast<FTC_FaceID>(const_cast<std::string*>(&faceID));
+}
+
+FT_Face FaceCache::LookupFace(FTC_FaceID faceID)
+{
+    ++m_stats.faceLookups;
+
+    FT_Face face;
+    FTArenaScope arenaScope(*m_allocator, FTArena_Face);
+    if(FTC_Manager_LookupFace(m_manager, faceID, &face))
+        return nullptr;
+    return face;
+}
+
+FT_Size FaceCache::LookupSize(FTC_Scaler scaler)
+{
+    TTF_PROFILE_SCOPE("LookupSize");
+    ++m_stats.faceLookups;
+    ++m_stats.sizeLookups;
+
+    FT_Size size;
+    FTArenaScope arenaScope(*m_allocator, FTArena_Face);
+    if(FTC_Manager_LookupSize(m_manager, scaler, &size))
+        return nullptr;
+
+    if(size->generic.data != &g_sizeSeen)
+    {
+        size->generic.data = &g_sizeSeen;
+        ++m_stats.sizeMisses;
+    }
+    return size;
+}
+
+FT_UInt FaceCache::LookupGlyphIndex(FTC_FaceID faceID, uint32_t charCode)
+{
+    FTArenaScope arenaScope(*m_allocator, FTArena_Face);
+    return FTC_CMapCache_Lookup(m_cmapCache, faceID, -1, charCode);
+}
+
+FTC_SBit FaceCache::LookupSBit(FTC_Scaler scaler, FT_UInt glyphIndex)
+{
+    ++m_stats.sbitLookups;
+
+    // Rendering happens inside the lookup so it runs in the caller's transient arena
+    FTC_SBit sbit;
+    if(FTC_SBitCache_LookupScaler(m_sbitCache, scaler, FT_LOAD_DEFAULT | FT_LOAD_RENDER, glyphIndex, &sbit, nullptr))
+        return nullptr;
+
+    // Glyphs that don't fit the compact sbit record come back without a buffer
+    if(!sbit->buffer && sbit->width != 0)
+        return nullptr;
+    if(sbit->buffer && sbit->format != FT_PIXEL_MODE_GRAY)
+        return nullptr;
+
+    ++m_stats.sbitServed;
+    return sbit;
+}
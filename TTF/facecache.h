@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <unordered_set>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_CACHE_H
+
+#include "ftmemory.h"
+
+struct FaceCacheStats
+{
+    size_t faceLookups = 0;
+    size_t faceMisses = 0;
+    size_t sizeLookups = 0;
+    size_t sizeMisses = 0;
+    size_t sbitLookups = 0;
+    size_t sbitServed = 0;
+};
+
+// Keeps faces and sizes behind FreeType's FTC_Manager so rarely used fonts get closed and reopened on demand
+// Face IDs are font file paths, fonts using the same file share one FT_Face
+class FaceCache
+{
+    public:
+        FaceCache() = default;
+        FaceCache(const FaceCache&) = delete;
+        FaceCache& operator=(const FaceCache&) = delete;
+
+        bool Init(FT_Library library, FTPoolAllocator& allocator, FT_UInt maxFaces, FT_UInt maxSizes, FT_ULong maxBytes);
+        void Done();
+
+        FTC_FaceID GetFaceID(const std::string& path);
+        FT_Face LookupFace(FTC_FaceID faceID);
+        FT_Size LookupSize(FTC_Scaler scaler);
+        FT_UInt LookupGlyphIndex(FTC_FaceID faceID, uint32_t charCode);
+        FTC_SBit LookupSBit(FTC_Scaler scaler, FT_UInt glyphIndex);
+
+        const FaceCacheStats& GetStats() const {return m_stats;}
+
+    private:
+        static FT_Error RequestFace(FTC_FaceID faceID, FT_Library library, FT_Pointer requestData, FT_Face* aface);
+
+        FTPoolAllocator* m_allocator = nullptr;
+        FTC_Manager m_manager = nullptr;
+        FTC_CMapCache m_cmapCache = nullptr;
+        FTC_SBitCache m_sbitCache = nullptr;
+        std::unordered_set<std::string> m_faceIDs;
+        FaceCacheStats m_stats;
+};
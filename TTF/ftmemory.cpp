@@ -0,0 +1,195 @@
+#include "ftmemory.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    const size_t g_sizeClasses[] = {16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+    const size_t g_slabSize = 64 * 1024;
+    const uint8_t g_largeBlock = 0xFF;
+
+    // Keeps user blocks 8-byte aligned so FreeType can store FT_Int64 and doubles in them
+    struct ChunkHeader
+    {
+        uint32_t size;
+        uint8_t arena;
+        uint8_t sizeClass;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(ChunkHeader) == 8, "ChunkHeader must stay 8 bytes");
+
+    ChunkHeader* GetHeader(void* block)
+    {
+        return reinterpret_cast<ChunkHeader*>(reinterpret_cast<unsigned char*>(block) - sizeof(ChunkHeader));
+    }
+
+    size_t FindSizeClass(size_t size)
+    {
+        size_t sizeClass = 0;
+        while(sizeClass < sizeof(g_sizeClasses) / sizeof(g_sizeClasses[0]) && g_sizeClasses[sizeClass] < size) ++sizeClass;
+        return sizeClass;
+    }
+
+    void* FT_Pool_Alloc(FT_Memory memory, long size)
+    {
+        return reinterpret_cast<FTPoolAllocator*>(memory->user)->Allocate(static_cast<size_t>(size));
+    }
+
+    void* FT_Pool_Realloc(FT_Memory memory, long, long newSize, void* block)
+    {
+        return reinterpret_cast<FTPoolAllocator*>(memory->user)->Reallocate(block, static_cast<size_t>(newSize));
+    }
+
+    void FT_Pool_Free(FT_Memory memory, void* block)
+    {
+        reinterpret_cast<FTPoolAllocator*>(memory->user)->Free(block);
+    }
+}
+
+FTPoolAllocator::FTPoolAllocator()
+{
+    static_assert(SizeClasses == sizeof(g_sizeClasses) / sizeof(g_sizeClasses[0]), "SizeClasses doesn't match the size class table");
+    m_memory.user = this;
+    m_memory.alloc = FT_Pool_Alloc;
+    m_memory.free = FT_Pool_Free;
+    m_memory.realloc = FT_Pool_Realloc;
+}
+
+FTPoolAllocator::~FTPoolAllocator()
+{
+    for(Arena& arena : m_arenas)
+    {
+        void* slab = arena.slabs;
+        while(slab)
+        {
+            void* next = *reinterpret_cast<void**>(slab);
+            free(slab);
+            slab = next;
+        }
+    }
+}
+
+void* FTPoolAllocator::AllocateChunk(Arena& arena, size_t sizeClass)
+{
+    void* chunk = arena.freeLists[sizeClass];
+    if(!chunk)
+    {
+        // First 8 bytes of every slab link it into the arena's slab list
+        unsigned char* slab = reinterpret_cast<unsigned char*>(malloc(g_slabSize));
+        if(!slab)
+            return nullptr;
+
+        *reinterpret_cast<void**>(slab) = arena.slabs;
+        arena.slabs = slab;
+        arena.stats.reservedBytes += g_slabSize;
+
+        size_t stride = sizeof(ChunkHeader) + g_sizeClasses[sizeClass];
+        for(size_t offset = 8; offset + stride <= g_slabSize; offset += stride)
+        {
+            *reinterpret_cast<void**>(slab + offset) = chunk;
+            chunk = slab + offset;
+        }
+    }
+    arena.freeLists[sizeClass] = *reinterpret_cast<void**>(chunk);
+    return chunk;
+}
+
+void* FTPoolAllocator::Allocate(size_t size)
+{
+    Arena& arena = m_arenas[m_currentArena];
+    size_t sizeClass = FindSizeClass(size);
+
+    ChunkHeader* header;
+    if(sizeClass < SizeClasses)
+        header = reinterpret_cast<ChunkHeader*>(AllocateChunk(arena, sizeClass));
+    else
+    {
+        header = reinterpret_cast<ChunkHeader*>(malloc(sizeof(ChunkHeader) + size));
+        if(header)
+            arena.stats.reservedBytes += sizeof(ChunkHeader) + size;
+    }
+    if(!header)
+        return nullptr;
+
+    header->size = static_cast<uint32_t>(size);
+    header->arena = static_cast<uint8_t>(m_currentArena);
+    header->sizeClass = (sizeClass < SizeClasses ? static_cast<uint8_t>(sizeClass) : g_largeBlock);
+    header->reserved = 0;
+
+    arena.stats.liveBytes += size;
+    if(arena.stats.liveBytes > arena.stats.peakBytes)
+        arena.stats.peakBytes = arena.stats.liveBytes;
+    ++arena.stats.allocations;
+    return header + 1;
+}
+
+void* FTPoolAllocator::Reallocate(void* block, size_t size)
+{
+    if(!block)
+        return Allocate(size);
+
+    ChunkHeader* header = GetHeader(block);
+    if(header->sizeClass != g_largeBlock && size <= g_sizeClasses[header->sizeClass])
+    {
+        Arena& arena = m_arenas[header->arena];
+        arena.stats.liveBytes = arena.stats.liveBytes - header->size + size;
+        if(arena.stats.liveBytes > arena.stats.peakBytes)
+            arena.stats.peakBytes = arena.stats.liveBytes;
+        header->size = static_cast<uint32_t>(size);
+        return block;
+    }
+
+    if(header->sizeClass == g_largeBlock && FindSizeClass(size) >= SizeClasses)
+    {
+        Arena& arena = m_arenas[header->arena];
+        size_t oldSize = header->size;
+        header = reinterpret_cast<ChunkHeader*>(realloc(header, sizeof(ChunkHeader) + size));
+        if(!header)
+            return nullptr;
+
+        header->size = static_cast<uint32_t>(size);
+        arena.stats.reservedBytes = arena.stats.reservedBytes - oldSize + size;
+        arena.stats.liveBytes = arena.stats.liveBytes - oldSize + size;
+        if(arena.stats.liveBytes > arena.stats.peakBytes)
+            arena.stats.peakBytes = arena.stats.liveBytes;
+        return header + 1;
+    }
+
+    void* newBlock = Allocate(size);
+    if(!newBlock)
+        return nullptr;
+
+    memcpy(newBlock, block, (header->size < size ? header->size : size));
+    Free(block);
+    return newBlock;
+}
+
+void FTPoolAllocator::Free(void* block)
+{
+    if(!block)
+        return;
+
+    ChunkHeader* header = GetHeader(block);
+    Arena& arena = m_arenas[header->arena];
+    arena.stats.liveBytes -= header->size;
+    ++arena.stats.frees;
+    if(header->sizeClass == g_largeBlock)
+    {
+        arena.stats.reservedBytes -= sizeof(ChunkHeader) + header->size;
+        free(header);
+        return;
+    }
+
+    // The free list link overwrites the header, all of it in 64-bit builds
+    size_t sizeClass = header->sizeClass;
+    *reinterpret_cast<void**>(header) = arena.freeLists[sizeClass];
+    arena.freeLists[sizeClass] = header;
+}
+
+double FTPoolAllocator::GetAllocationsPerGlyphLoad() const
+{
+    if(m_glyphLoads == 0)
+        return 0.0;
+    return static_cast<double>(m_arenas[FTArena_Transient].stats.allocations) / m_glyphLoads;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ft2build.h>
+#include FT_SYSTEM_H
+
+// Pool allocator handed to FreeType as FT_Memory
+// Small blocks are served from size-class free lists carved out of 64KiB slabs so glyph churn
+// doesn't fragment the game's address space, bigger blocks go straight to the CRT heap
+// Face and size objects live in their own arena, glyph loading and rasterization use the transient arena
+// FreeType is only ever used from the game's main thread so the allocator isn't synchronized
+enum FTArenaType
+{
+    FTArena_Face = 0,
+    FTArena_Transient,
+    FTArena_Count
+};
+
+struct FTArenaStats
+{
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+    size_t reservedBytes = 0;
+    size_t allocations = 0;
+    size_t frees = 0;
+};
+
+class FTPoolAllocator
+{
+    public:
+        FTPoolAllocator();
+        ~FTPoolAllocator();
+
+        FTPoolAllocator(const FTPoolAllocator&) = delete;
+        FTPoolAllocator& operator=(const FTPoolAllocator&) = delete;
+
+        FT_Memory GetMemory() {return &m_memory;}
+
+        FTArenaType GetArena() const {return m_currentArena;}
+        void SetArena(FTArenaType arena) {m_currentArena = arena;}
+
+        void* Allocate(size_t size);
+        void* Reallocate(void* block, size_t size);
+        void Free(void* block);
+
+        void CountGlyphLoad() {++m_glyphLoads;}
+        size_t GetGlyphLoads() const {return m_glyphLoads;}
+        const FTArenaStats& GetStats(FTArenaType arena) const {return m_arenas[arena].stats;}
+        double GetAllocationsPerGlyphLoad() const;
+
+    private:
+        static constexpr size_t SizeClasses = 9;
+
+        struct Arena
+        {
+            void* freeLists[SizeClasses] = {};
+            void* slabs = nullptr;
+            FTArenaStats stats;
+        };
+
+        void* AllocateChunk(Arena& arena, size_t sizeClass);
+
+        FT_MemoryRec_ m_memory;
+        Arena m_arenas[FTArena_Count];
+        FTArenaType m_currentArena = FTArena_Face;
+        size_t m_glyphLoads = 0;
+};
+
+// Routes FreeType allocations made in the current scope to the given arena
+class FTArenaScope
+{
+    public:
+        FTArenaScope(FTPoolAllocator& allocator, FTArenaType arena) : m_allocator(allocator), m_previous(allocator.GetArena()) {allocator.SetArena(arena);}
+        ~FTArenaScope() {m_allocator.SetArena(m_previous);}
+
+        FTArenaScope(const FTArenaScope&) = delete;
+        FTArenaScope& operator=(const FTArenaScope&) = delete;
+
+    private:
+        FTPoolAllocator& m_allocator;
+        FTArenaType m_previous;
+};
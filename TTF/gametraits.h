@@ -0,0 +1,168 @@
+#pragma once
+#include <windows.h>
+
+#include "zSTRING.h"
+
+// Everything that differs between the supported executables, the engine hooks are templates over these
+// so each game gets its own instantiation with every address folded in as a constant
+// The text hooks' bodies are in enginetext.h, the tests instantiate them against traits of a fake engine
+struct G1Traits
+{
+    // Fonts are looked up as <font directory>\_WORK\FONTS\G1_<name>
+    static constexpr const char* FontPrefix = "\\_WORK\\FONTS\\G1_";
+    static constexpr int FontDirectory = 23;
+    typedef zSTRING_G1 VdfsString;
+    // Strings handed to the text hooks, both games share the layout
+    typedef zSTRING_G2 ViewString;
+
+    // Engine globals
+    static constexpr DWORD DirectDraw = 0x929D54;
+    static constexpr DWORD Direct3DDevice = 0x929D5C;
+    static constexpr DWORD Renderer = 0x8C5ED0;
+    static constexpr DWORD FontManager = 0x8DC71C;
+    static constexpr DWORD Options = 0x869694;
+    static constexpr DWORD UIScale = 0x5A88E1;
+    static constexpr DWORD UIScalePatch = 0x6E0238;
+    static constexpr DWORD VdfsActive = 0x85F2CC;
+    static constexpr DWORD VdfsCriticalSection = 0x85F2D0;
+    static constexpr DWORD VdfsRead = 0x7D0498;
+    // Characters the engine's own word wrap breaks after, with zCView_Printwin hooked it also gets line feeds where UAX #14 breaks
+    static constexpr DWORD Separators = 0x858D70;
+    static constexpr DWORD WordSeparators = 0x852E38;
+
+    // Engine functions, the hooked ones included
+    static constexpr DWORD zCOption_GetDirString = 0x45FC00;
+    static constexpr DWORD zCFontMan_GetFont = 0x6DF220;
+    static constexpr DWORD zCFont_LoadFontTexture = 0x6DF280;
+    static constexpr DWORD zCFont_LoadFontTextureJump = 0x6DF871;
+    static constexpr DWORD zCFont_GetFontY = 0x6E0200;
+    static constexpr DWORD zCFont_GetFontX = 0x6E0210;
+    static constexpr DWORD zCFont_Destructor = 0x6DF6A0;
+    static constexpr DWORD zCView_RecalcChildsPos = 0x6FD9A0;
+    static constexpr DWORD zCView_RecalcChildsPosCall = 0x70232A;
+    static constexpr DWORD zCView_PrintChars = 0x6FFF80;
+    static constexpr DWORD zCView_BlitText = 0x6FC7B0;
+    static constexpr DWORD zCView_Print = 0x6FFEB0;
+    // The engine's word wrap, 0 leaves it unhooked until its address is checked against the executable
+    static constexpr DWORD zCView_Printwin = 0;
+    static constexpr DWORD zCViewPrint_BlitTextCharacters = 0x756B20;
+    static constexpr DWORD zCRnd_D3D_ClearDevice = 0x7123F0;
+    static constexpr DWORD zCRnd_D3D_SetRenderState = 0x7185C0;
+    static constexpr DWORD zCRnd_D3D_SetTexture = 0x718150;
+    static constexpr DWORD zFILE_VDFS_ReadString = 0x446750;
+    static constexpr DWORD zFILE_FILE_ReadString = 0x440790;
+    static constexpr DWORD zSTRING_Clear = 0x401260;
+    static constexpr DWORD zSTRING_Assign = 0x4013A0;
+
+    // zCRenderer vtable offsets
+    static constexpr DWORD SetBilerpFilter = 0x50;
+    static constexpr DWORD GetBilerpFilter = 0x54;
+    static constexpr DWORD GetZBufferWrite = 0x68;
+    static constexpr DWORD SetZBufferWrite = 0x6C;
+    static constexpr DWORD GetZBufferCompare = 0x70;
+    static constexpr DWORD SetZBufferCompare = 0x74;
+    static constexpr DWORD SetAlphaFunc = 0x88;
+    static constexpr DWORD GetAlphaFunc = 0x8C;
+    static constexpr DWORD SetTextureStageState = 0x148;
+
+    // zCView members
+    static constexpr DWORD ViewPixelX = 0x50;
+    static constexpr DWORD ViewPixelWidth = 0x58;
+    static constexpr DWORD ViewFont = 0x60;
+    static constexpr DWORD ViewColor = 0x64;
+    // zCFont members, LoadFontTexture fills them in from the TTFont
+    static constexpr DWORD FontSize = 0x14;
+    static constexpr DWORD FontTTF = 0x20;
+    static constexpr DWORD FontHeight = 0x24;
+    static constexpr DWORD FontAscent = 0x28;
+    static constexpr DWORD FontDescent = 0x2C;
+
+    // zCViewText2 and zCViewPrint members
+    static constexpr DWORD ViewTextX = 0x08;
+    static constexpr DWORD ViewTextY = 0x0C;
+    static constexpr DWORD ViewTextString = 0x14;
+    static constexpr DWORD ViewPrintPixelX = 0x38;
+    static constexpr DWORD ViewPrintPixelY = 0x3C;
+    static constexpr DWORD ViewPrintPixelWidth = 0x40;
+    static constexpr DWORD ViewPrintTextOffsetX = 0xD4;
+    static constexpr DWORD ViewPrintTextOffsetY = 0xD8;
+};
+
+struct G2Traits
+{
+    // Fonts are looked up as <font directory>\_WORK\FONTS\G2_<name>
+    static constexpr const char* FontPrefix = "\\_WORK\\FONTS\\G2_";
+    static constexpr int FontDirectory = 24;
+    typedef zSTRING_G2 VdfsString;
+    typedef zSTRING_G2 ViewString;
+
+    // Engine globals
+    static constexpr DWORD DirectDraw = 0x9FC9EC;
+    static constexpr DWORD Direct3DDevice = 0x9FC9F4;
+    static constexpr DWORD Renderer = 0x982F08;
+    static constexpr DWORD FontManager = 0xAB39D4;
+    static constexpr DWORD Options = 0x8CD988;
+    static constexpr DWORD UIScale = 0x66714F;
+    static constexpr DWORD UIScalePatch = 0x789518;
+    static constexpr DWORD VdfsActive = 0x8C34C4;
+    static constexpr DWORD VdfsCriticalSection = 0x8C34C8;
+    static constexpr DWORD VdfsRead = 0x82E638;
+    static constexpr DWORD Separators = 0x8B0E20;
+    static constexpr DWORD WordSeparators = 0x8BC8F4;
+
+    // Engine functions, the hooked ones included
+    static constexpr DWORD zCOption_GetDirString = 0x465260;
+    static constexpr DWORD zCFontMan_GetFont = 0x7884B0;
+    static constexpr DWORD zCFont_LoadFontTexture = 0x788510;
+    static constexpr DWORD zCFont_LoadFontTextureJump = 0x788AF1;
+    static constexpr DWORD zCFont_GetFontY = 0x7894E0;
+    static constexpr DWORD zCFont_GetFontX = 0x7894F0;
+    static constexpr DWORD zCFont_Destructor = 0x788920;
+    static constexpr DWORD zCView_RecalcChildsPos = 0x7A7540;
+    static constexpr DWORD zCView_RecalcChildsPosCall = 0x7ABF4A;
+    static constexpr DWORD zCView_PrintChars = 0x7A9B10;
+    static constexpr DWORD zCView_BlitText = 0x7A62A0;
+    static constexpr DWORD zCView_Print = 0x7A9A40;
+    static constexpr DWORD zCView_Printwin = 0;
+    static constexpr DWORD zCViewPrint_BlitTextCharacters = 0x693650;
+    static constexpr DWORD zCRnd_D3D_ClearDevice = 0x648820;
+    static constexpr DWORD zCRnd_D3D_SetRenderState = 0x644EF0;
+    static constexpr DWORD zCRnd_D3D_SetTexture = 0x650500;
+    static constexpr DWORD zFILE_VDFS_ReadString = 0x44AA80;
+    static constexpr DWORD zFILE_FILE_ReadString = 0x4446B0;
+    static constexpr DWORD zSTRING_Clear = 0x401160;
+    static constexpr DWORD zSTRING_Assign = 0x4010C0;
+
+    // zCRenderer vtable offsets
+    static constexpr DWORD SetBilerpFilter = 0x68;
+    static constexpr DWORD GetBilerpFilter = 0x6C;
+    static constexpr DWORD GetZBufferWrite = 0x80;
+    static constexpr DWORD SetZBufferWrite = 0x84;
+    static constexpr DWORD GetZBufferCompare = 0x90;
+    static constexpr DWORD SetZBufferCompare = 0x94;
+    static constexpr DWORD SetAlphaFunc = 0xA8;
+    static constexpr DWORD GetAlphaFunc = 0xAC;
+    static constexpr DWORD SetTextureStageState = 0x17C;
+
+    // zCView members
+    static constexpr DWORD ViewPixelX = 0x54;
+    static constexpr DWORD ViewPixelWidth = 0x5C;
+    static constexpr DWORD ViewFont = 0x64;
+    static constexpr DWORD ViewColor = 0x68;
+    // zCFont members, LoadFontTexture fills them in from the TTFont
+    static constexpr DWORD FontSize = 0x14;
+    static constexpr DWORD FontTTF = 0x20;
+    static constexpr DWORD FontHeight = 0x24;
+    static constexpr DWORD FontAscent = 0x28;
+    static constexpr DWORD FontDescent = 0x2C;
+
+    // zCViewText2 and zCViewPrint members
+    static constexpr DWORD ViewTextX = 0x08;
+    static constexpr DWORD ViewTextY = 0x0C;
+    static constexpr DWORD ViewTextString = 0x14;
+    static constexpr DWORD ViewPrintPixelX = 0x38;
+    static constexpr DWORD ViewPrintPixelY = 0x3C;
+    static constexpr DWORD ViewPrintPixelWidth = 0x40;
+    static constexpr DWORD ViewPrintTextOffsetX = 0xD4;
+    static constexpr DWORD ViewPrintTextOffsetY = 0xD8;
+};
@@ -0,0 +1,171 @@
+#include "glyphatlas.h"
+
+#include <algorithm>
+
+void AtlasPacker::Reset(unsigned int width, unsigned int height, unsigned int padding)
+{
+    m_shelves.clear();
+    m_width = width;
+    m_height = height;
+    m_padding = padding;
+    m_nextY = 0;
+    m_allocations = 0;
+    m_usedArea = 0;
+}
+
+bool AtlasPacker::AllocateOnShelf(Shelf& shelf, unsigned int width, AtlasRect& rect)
+{
+    for(auto it = shelf.freeSlots.begin(); it != shelf.freeSlots.end(); ++it)
+    {
+        if(it->width < width)
+            continue;
+
+        rect.x = it->x;
+        it->x += width;
+        it->width -= width;
+        if(it->width == 0)
+            shelf.freeSlots.erase(it);
+        return true;
+    }
+
+    if(m_width - shelf.end < width)
+        return false;
+
+    rect.x = shelf.end;
+    shelf.end += width;
+    return true;
+}
+
+bool AtlasPacker::Allocate(unsigned int width, unsigned int height, AtlasRect& rect)
+{
+    unsigned int paddedWidth = width + m_padding;
+    unsigned int paddedHeight = height + m_padding;
+    if(paddedWidth > m_width || paddedHeight > m_height)
+        return false;
+
+    // Best fit shelf, glyphs much smaller than the shelf only go there when no new shelf can be opened
+    Shelf* best = nullptr;
+    for(Shelf& shelf : m_shelves)
+    {
+        if(shelf.height < paddedHeight || (best && shelf.height >= best->height))
+            continue;
+
+        bool fits = (m_width - shelf.end >= paddedWidth);
+        for(size_t i = 0; !fits && i < shelf.freeSlots.size(); ++i)
+            fits = (shelf.freeSlots[i].width >= paddedWidth);
+        if(fits)
+            best = &shelf;
+    }
+
+    bool canOpenShelf = (m_height - m_nextY >= paddedHeight);
+    if(best && (!canOpenShelf || best->height - paddedHeight <= paddedHeight / 2))
+        AllocateOnShelf(*best, paddedWidth, rect);
+    else if(canOpenShelf)
+    {
+        m_shelves.push_back({m_nextY, paddedHeight, 0, {}});
+        m_nextY += paddedHeight;
+        best = &m_shelves.back();
+        AllocateOnShelf(*best, paddedWidth, rect);
+    }
+    else
+        return false;
+
+    rect.y = best->y;
+    rect.width = width;
+    rect.height = height;
+    ++m_allocations;
+    m_usedArea += static_cast<size_t>(width) * height;
+    return true;
+}
+
+void AtlasPacker::Free(const AtlasRect& rect)
+{
+    auto shelf = std::find_if(m_shelves.begin(), m_shelves.end(), [&rect](const Shelf& s) {return s.y == rect.y;});
+    if(shelf == m_shelves.end())
+        return;
+
+    --m_allocations;
+    m_usedArea -= static_cast<size_t>(rect.width) * rect.height;
+
+    // Slots are kept sorted and merged so neighbouring holes can take wider glyphs
+    FreeSlot slot = {rect.x, rect.width + m_padding};
+    auto it = std::lower_bound(shelf->freeSlots.begin(), shelf->freeSlots.end(), slot.x, [](const FreeSlot& s, unsigned int x) {return s.x < x;});
+    it = shelf->freeSlots.insert(it, slot);
+    if(it + 1 != shelf->freeSlots.end() && it->x + it->width == (it + 1)->x)
+    {
+        it->width += (it + 1)->width;
+        shelf->freeSlots.erase(it + 1);
+    }
+    if(it != shelf->freeSlots.begin() && (it - 1)->x + (it - 1)->width == it->x)
+    {
+        (it - 1)->width += it->width;
+        it = shelf->freeSlots.erase(it) - 1;
+    }
+    if(it->x + it->width == shelf->end)
+    {
+        shelf->end = it->x;
+        shelf->freeSlots.erase(it);
+    }
+
+    // Empty shelves at the bottom give their height back to the page
+    while(!m_shelves.empty() && m_shelves.back().end == 0)
+    {
+        m_nextY = m_shelves.back().y;
+        m_shelves.pop_back();
+    }
+}
+
+#define ATLAS_MAX_PAGE_SIZE 2048
+
+void GlyphAtlas::SetPageSize(unsigned int size)
+{
+    m_pageSize = 0;
+    if(size == 0)
+        return;
+
+    m_pageSize = 64;
+    while(m_pageSize < size && m_pageSize < ATLAS_MAX_PAGE_SIZE)
+        m_pageSize <<= 1;
+}
+
+bool GlyphAtlas::Fits(unsigned int width, unsigned int height) const
+{
+    return (m_pageSize != 0 && width + m_padding <= m_pageSize && height + m_padding <= m_pageSize);
+}
+
+int GlyphAtlas::Allocate(unsigned int width, unsigned int height, AtlasRect& rect)
+{
+    for(size_t i = 0; i < m_pages.size(); ++i)
+    {
+        if(m_pages[i].used && m_pages[i].packer.Allocate(width, height, rect))
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int GlyphAtlas::AddPage(void* surface)
+{
+    size_t index = 0;
+    while(index < m_pages.size() && m_pages[index].used)
+        ++index;
+    if(index == m_pages.size())
+        m_pages.emplace_back();
+
+    m_pages[index].surface = surface;
+    m_pages[index].used = true;
+    m_pages[index].packer.Reset(m_pageSize, m_pageSize, m_padding);
+    return static_cast<int>(index);
+}
+
+void* GlyphAtlas::Free(int page, const AtlasRect& rect)
+{
+    Page& atlasPage = m_pages[page];
+    atlasPage.packer.Free(rect);
+    if(atlasPage.packer.GetAllocations() != 0)
+        return nullptr;
+
+    void* surface = atlasPage.surface;
+    atlasPage.surface = nullptr;
+    atlasPage.used = false;
+    return surface;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+struct AtlasRect
+{
+    unsigned int x, y;
+    unsigned int width, height;
+};
+
+// Shelf packer for one atlas page, glyphs are placed left to right on rows of similar height
+// Freed rectangles go to a per-shelf free list and get reused by glyphs that fit the shelf
+class AtlasPacker
+{
+    public:
+        struct FreeSlot
+        {
+            unsigned int x, width;
+        };
+
+        struct Shelf
+        {
+            unsigned int y, height;
+            unsigned int end;
+            std::vector<FreeSlot> freeSlots;
+        };
+
+        AtlasPacker() = default;
+
+        // padding is kept free right and below every glyph so filtering doesn't bleed into the neighbours
+        void Reset(unsigned int width, unsigned int height, unsigned int padding);
+
+        bool Allocate(unsigned int width, unsigned int height, AtlasRect& rect);
+        void Free(const AtlasRect& rect);
+
+        unsigned int GetWidth() const {return m_width;}
+        unsigned int GetHeight() const {return m_height;}
+        size_t GetAllocations() const {return m_allocations;}
+        size_t GetUsedArea() const {return m_usedArea;}
+        const std::vector<Shelf>& GetShelves() const {return m_shelves;}
+
+    private:
+        bool AllocateOnShelf(Shelf& shelf, unsigned int width, AtlasRect& rect);
+
+        std::vector<Shelf> m_shelves;
+        unsigned int m_width = 0;
+        unsigned int m_height = 0;
+        unsigned int m_padding = 0;
+        unsigned int m_nextY = 0;
+        size_t m_allocations = 0;
+        size_t m_usedArea = 0;
+};
+
+// Atlas pages shared by all fonts, surfaces are opaque to the atlas and owned by the renderer
+class GlyphAtlas
+{
+    public:
+        GlyphAtlas() = default;
+        GlyphAtlas(const GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+        // Page size gets rounded up to a power of two, 0 keeps glyphs in surfaces of their own
+        void SetPageSize(unsigned int size);
+        unsigned int GetPageSize() const {return m_pageSize;}
+        unsigned int GetPadding() const {return m_padding;}
+        bool IsEnabled() const {return m_pageSize != 0;}
+        bool Fits(unsigned int width, unsigned int height) const;
+
+        // Returns the page the glyph went to or -1 when every page is full
+        int Allocate(unsigned int width, unsigned int height, AtlasRect& rect);
+        int AddPage(void* surface);
+        // Opens a page without a surface for simulations and dumps that keep the texels somewhere else
+        int ReservePage() {return AddPage(nullptr);}
+
+        // Returns the page surface once its last glyph is gone so the caller can release it
+        void* Free(int page, const AtlasRect& rect);
+
+        size_t GetPageCount() const {return m_pages.size();}
+        // Pages stay unused from their last glyph being freed until AddPage opens them again
+        bool IsPageUsed(int page) const {return m_pages[page].used;}
+        void* GetSurface(int page) const {return m_pages[page].surface;}
+        const AtlasPacker& GetPacker(int page) const {return m_pages[page].packer;}
+
+    private:
+        struct Page
+        {
+            void* surface;
+            bool used;
+            AtlasPacker packer;
+        };
+
+        std::vector<Page> m_pages;
+        unsigned int m_pageSize = 0;
+        unsigned int m_padding = 1;
+};
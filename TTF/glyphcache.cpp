@@ -0,0 +1,730 @@
+#include "glyphcache.h"
+#include "atlasdump.h"
+#include "log.h"
+#include "profiler.h"
+#include "textcore.h"
+#include "textstats.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include FT_MODULE_H
+#include FT_OUTLINE_H
+
+bool g_useBGRA = true;
+bool g_useDirectRaster = false;
+bool g_halfPixelOffset = true;
+GlyphTextureFormat g_textureFormat = GlyphFormat_BGRA8888;
+float g_textGamma = 1.f;
+int g_sbitMaxSize = 32;
+FT_UInt g_maxFaces = 8;
+FT_UInt g_maxSizes = 16;
+FT_ULong g_maxBytes = 4 * 1024 * 1024;
+BidiCache g_bidiCache;
+std::unordered_set<TTFont*> g_fonts;
+FTPoolAllocator g_ftAllocator;
+FT_Library g_ft;
+FaceCache g_faceCache;
+TextureTracker g_textureTracker;
+HitchReport g_hitchReport;
+GlyphAtlas g_glyphAtlas;
+GlyphRenderBackend* g_renderBackend = nullptr;
+uint32_t g_textFrame = 0;
+uint32_t g_traceFonts = 0;
+TextTraceWriter g_textTrace;
+bool g_recordUsage = false;
+GlyphUsage g_glyphUsage;
+int g_prewarmGlyphs = 0;
+double g_prewarmBudgetMs = 2.0;
+GlyphUsage g_prewarmManifest;
+std::unordered_map<std::string, std::string> g_fontsWrapper;
+void(*g_showFatalError)(const char*) = nullptr;
+
+static void FatalError(const char* message)
+{
+    LogMessage("%s", message);
+    if(g_showFatalError)
+        g_showFatalError(message);
+    exit(-1);
+}
+
+bool InitializeFreeType(void(*addModules)(FT_Library))
+{
+    TTF_PROFILE_SCOPE("InitializeFreeType");
+    if(FT_New_Library(g_ftAllocator.GetMemory(), &g_ft))
+        return false;
+
+    if(addModules)
+        addModules(g_ft);
+    else
+        FT_Add_Default_Modules(g_ft);
+    FT_Set_Default_Properties(g_ft);
+    return g_faceCache.Init(g_ft, g_ftAllocator, g_maxFaces, g_maxSizes, g_maxBytes);
+}
+
+void ShutdownFreeType()
+{
+    g_faceCache.Done();
+    FT_Done_Library(g_ft);
+    g_ft = nullptr;
+}
+
+void LogFreeTypeMemory()
+{
+    const char* arenaNames[FTArena_Count] = {"face", "transient"};
+    for(int i = 0; i < FTArena_Count; ++i)
+    {
+        const FTArenaStats& stats = g_ftAllocator.GetStats(static_cast<FTArenaType>(i));
+        LogMessage("FreeType %s arena: %u live bytes, %u peak bytes, %u reserved bytes, %u allocations, %u frees", arenaNames[i], static_cast<unsigned int>(stats.liveBytes),
+            static_cast<unsigned int>(stats.peakBytes), static_cast<unsigned int>(stats.reservedBytes), static_cast<unsigned int>(stats.allocations), static_cast<unsigned int>(stats.frees));
+    }
+    LogMessage("FreeType glyph loads: %u, %.2f allocations per glyph load", static_cast<unsigned int>(g_ftAllocator.GetGlyphLoads()), g_ftAllocator.GetAllocationsPerGlyphLoad());
+}
+
+void LogFontCacheStats()
+{
+    const FaceCacheStats& stats = g_faceCache.GetStats();
+    LogMessage("Font cache: %u/%u face misses, %u/%u size misses, %u/%u glyphs served from small bitmaps", static_cast<unsigned int>(stats.faceMisses),
+        static_cast<unsigned int>(stats.faceLookups), static_cast<unsigned int>(stats.sizeMisses), static_cast<unsigned int>(stats.sizeLookups),
+        static_cast<unsigned int>(stats.sbitServed), static_cast<unsigned int>(stats.sbitLookups));
+
+    const BidiCacheStats& bidiStats = g_bidiCache.GetStats();
+    if(bidiStats.lookups > 0)
+    {
+        LogMessage("Bidi cache: %u/%u misses, %u flushes, %u strings cached", static_cast<unsigned int>(bidiStats.misses),
+            static_cast<unsigned int>(bidiStats.lookups), static_cast<unsigned int>(bidiStats.flushes), static_cast<unsigned int>(g_bidiCache.GetEntryCount()));
+    }
+}
+
+static unsigned int UTIL_power_of_2(unsigned int input)
+{
+    unsigned int value = 1;
+    while(value < input) value <<= 1;
+    return value;
+}
+
+struct GlyphSpanTarget
+{
+    unsigned char* data;
+    int pitch;
+    int rows;
+    TTFont* fnt;
+};
+
+static void GlyphSpans(int y, int count, const FT_Span* spans, void* user)
+{
+    GlyphSpanTarget* target = reinterpret_cast<GlyphSpanTarget*>(user);
+    TTFont* fnt = target->fnt;
+
+    // FreeType counts span rows upwards from the bottom of the clip box
+    unsigned int texelSize = GetGlyphTexelSize(g_textureFormat);
+    unsigned char* dstData = target->data + (target->rows - 1 - y) * target->pitch;
+    for(int i = 0; i < count; ++i)
+        FillGlyphSpan(g_textureFormat, dstData + spans[i].x * texelSize, spans[i].len, fnt->alphaTable[spans[i].coverage], fnt->color);
+}
+
+uint32_t GetGlyphColor(const TTFont* fnt, uint32_t color)
+{
+    if(g_textureFormat == GlyphFormat_BGRA8888)
+        return color;
+
+    int fontRed = (g_useBGRA ? fnt->b : fnt->r);
+    int fontBlue = (g_useBGRA ? fnt->r : fnt->b);
+    uint32_t red = ((color >> 16) & 0xFF) * fontRed / 255;
+    uint32_t green = ((color >> 8) & 0xFF) * fnt->g / 255;
+    uint32_t blue = (color & 0xFF) * fontBlue / 255;
+    return (color & 0xFF000000) | (red << 16) | (green << 8) | blue;
+}
+
+static GlyphPage CreateGlyphTexture(unsigned int width, unsigned int height)
+{
+    int64_t createStart = TextStatsTimestamp();
+    GlyphPage texture = g_renderBackend->CreatePage(width, height, g_textureFormat);
+    g_hitchReport.AddStep(GlyphStep_CreateSurface, TextStatsTimestamp() - createStart);
+    if(!texture)
+        FatalError("Failed to create glyph texture");
+    g_textCounters.textureBytesAllocated += width * height * GetGlyphTexelSize(g_textureFormat);
+    return texture;
+}
+
+static AtlasRect GetAtlasRect(const TTFont::GlyphMap::mapped_type& glyph)
+{
+    // Page sizes are powers of two so the texture coordinates convert back to texels exactly
+    float pageSize = static_cast<float>(g_glyphAtlas.GetPageSize());
+    AtlasRect rect;
+    rect.x = static_cast<unsigned int>(std::get<5>(glyph) * pageSize);
+    rect.y = static_cast<unsigned int>(std::get<7>(glyph) * pageSize);
+    rect.width = std::get<0>(glyph);
+    rect.height = std::get<1>(glyph);
+    return rect;
+}
+
+static int AllocateAtlasGlyph(const GlyphImage& image, AtlasRect& rect)
+{
+    int page = g_glyphAtlas.Allocate(image.width, image.rows, rect);
+    if(page >= 0)
+        return page;
+
+    unsigned int pageSize = g_glyphAtlas.GetPageSize();
+    GlyphPage surface = CreateGlyphTexture(pageSize, pageSize);
+    g_textureTracker.Track(surface, "ATLAS", pageSize, pageSize, g_textureFormat, 0, 0);
+
+    // Start from a transparent page so the space between shelves doesn't show up in dumps
+    GlyphPageLock lock;
+    if(g_renderBackend->LockPage(surface, nullptr, false, lock))
+    {
+        memset(lock.texels, 0x00, lock.pitch * lock.rows);
+        g_renderBackend->UnlockPage(surface, nullptr);
+    }
+
+    g_glyphAtlas.AddPage(surface);
+    return g_glyphAtlas.Allocate(image.width, image.rows, rect);
+}
+
+static void LoadGlyph(TTFont* fnt, const GlyphImage& image, GlyphPage& texture, int& page, float& u0, float& u1, float& v0, float& v1)
+{
+    TTF_PROFILE_SCOPE("UploadGlyph");
+    if(!texture)
+    {
+        AtlasRect rect;
+        page = (g_glyphAtlas.Fits(image.width, image.rows) ? AllocateAtlasGlyph(image, rect) : -1);
+        if(page >= 0)
+        {
+            texture = g_glyphAtlas.GetSurface(page);
+            g_textureTracker.SetGlyphArea(texture, g_glyphAtlas.GetPacker(page).GetUsedArea());
+
+            float pageSize = static_cast<float>(g_glyphAtlas.GetPageSize());
+            u0 = rect.x / pageSize;
+            u1 = (rect.x + image.width) / pageSize;
+            v0 = rect.y / pageSize;
+            v1 = (rect.y + image.rows) / pageSize;
+        }
+        else
+        {
+            unsigned int width = UTIL_power_of_2(image.width);
+            unsigned int height = UTIL_power_of_2(image.rows);
+            texture = CreateGlyphTexture(width, height);
+            g_textureTracker.Track(texture, fnt->name, width, height, g_textureFormat, image.width, image.rows);
+
+            u0 = 0.f;
+            u1 = static_cast<float>(image.width) / width;
+            v0 = 0.f;
+            v1 = static_cast<float>(image.rows) / height;
+        }
+    }
+
+    // Atlas glyphs only lock their own rectangle and the padding next to it
+    AtlasRect lockRect;
+    const AtlasRect* lockArea = nullptr;
+    if(page >= 0)
+    {
+        float pageSize = static_cast<float>(g_glyphAtlas.GetPageSize());
+        lockRect.x = static_cast<unsigned int>(u0 * pageSize);
+        lockRect.y = static_cast<unsigned int>(v0 * pageSize);
+        lockRect.width = image.width + g_glyphAtlas.GetPadding();
+        lockRect.height = image.rows + g_glyphAtlas.GetPadding();
+        lockArea = &lockRect;
+    }
+
+    GlyphPageLock lock;
+    int64_t lockStart = TextStatsTimestamp();
+    bool locked = g_renderBackend->LockPage(texture, lockArea, false, lock);
+    int64_t fillStart = TextStatsTimestamp();
+    g_hitchReport.AddStep(GlyphStep_Lock, fillStart - lockStart);
+    if(!locked)
+        return;
+
+    if(lockArea)
+    {
+        size_t rowBytes = static_cast<size_t>(lock.width) * GetGlyphTexelSize(g_textureFormat);
+        for(unsigned int y = 0; y < lock.rows; ++y)
+            memset(lock.texels + y * lock.pitch, 0x00, rowBytes);
+        g_textCounters.textureBytesUploaded += rowBytes * lock.rows;
+    }
+    else
+    {
+        memset(lock.texels, 0x00, lock.pitch * lock.rows);
+        g_textCounters.textureBytesUploaded += lock.pitch * lock.rows;
+    }
+    if(image.outline)
+    {
+        // Rasterize the outline straight into the locked texture without going through the glyph slot bitmap
+        GlyphSpanTarget target;
+        target.data = lock.texels;
+        target.pitch = lock.pitch;
+        target.rows = static_cast<int>(image.rows);
+        target.fnt = fnt;
+
+        FT_Raster_Params params;
+        memset(&params, 0, sizeof(params));
+        params.source = image.outline;
+        params.flags = FT_RASTER_FLAG_AA | FT_RASTER_FLAG_DIRECT | FT_RASTER_FLAG_CLIP;
+        params.gray_spans = GlyphSpans;
+        params.user = &target;
+        params.clip_box.xMin = 0;
+        params.clip_box.yMin = 0;
+        params.clip_box.xMax = static_cast<FT_Pos>(image.width);
+        params.clip_box.yMax = static_cast<FT_Pos>(image.rows);
+
+        FTArenaScope arenaScope(g_ftAllocator, FTArena_Transient);
+        FT_Outline_Translate(image.outline, -image.originX, -image.originY);
+        FT_Outline_Render(g_ft, image.outline, &params);
+        FT_Outline_Translate(image.outline, image.originX, image.originY);
+    }
+    else if(image.buffer)
+    {
+        ConvertGlyphBitmap(g_textureFormat, lock.texels, lock.pitch, image.buffer, image.pitch,
+            static_cast<int>(image.width), static_cast<int>(image.rows), fnt->alphaTable, fnt->color);
+    }
+
+    g_renderBackend->UnlockPage(texture, lockArea);
+    g_hitchReport.AddStep(GlyphStep_Fill, TextStatsTimestamp() - fillStart);
+}
+
+void LoadGlyphImage(TTFont* fnt, uint32_t utf32, GlyphImage& image)
+{
+    TTF_PROFILE_SCOPE("LoadGlyphImage");
+    FTArenaScope arenaScope(g_ftAllocator, FTArena_Transient);
+    g_ftAllocator.CountGlyphLoad();
+    memset(&image, 0, sizeof(image));
+
+    FT_UInt glyphIndex = g_faceCache.LookupGlyphIndex(fnt->scaler.face_id, utf32);
+    if(fnt->useSBits)
+    {
+        FTC_SBit sbit = g_faceCache.LookupSBit(&fnt->scaler, glyphIndex);
+        if(sbit)
+        {
+            image.width = sbit->width;
+            image.rows = sbit->height;
+            image.left = sbit->left;
+            image.top = sbit->top;
+            image.advance = sbit->xadvance;
+            image.buffer = sbit->buffer;
+            image.pitch = sbit->pitch;
+            return;
+        }
+    }
+
+    // Outlines are left unrendered when they get rasterized straight into the texture
+    FT_Size size = g_faceCache.LookupSize(&fnt->scaler);
+    if(!size || FT_Load_Glyph(size->face, glyphIndex, (g_useDirectRaster ? FT_LOAD_DEFAULT : FT_LOAD_RENDER)))
+        FatalError("Failed to load glyph");
+
+    FT_GlyphSlot glyph = size->face->glyph;
+    if(glyph->format != FT_GLYPH_FORMAT_OUTLINE && glyph->format != FT_GLYPH_FORMAT_BITMAP)
+    {
+        if(FT_Render_Glyph(glyph, FT_RENDER_MODE_NORMAL))
+            FatalError("Failed to load glyph");
+    }
+
+    image.advance = static_cast<int>(glyph->advance.x >> 6);
+    if(g_useDirectRaster && glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+    {
+        // Same pixel grid fitting as FreeType's smooth renderer
+        FT_BBox cbox;
+        FT_Outline_Get_CBox(&glyph->outline, &cbox);
+        cbox.xMin &= -64;
+        cbox.yMin &= -64;
+        cbox.xMax = (cbox.xMax + 63) & -64;
+        cbox.yMax = (cbox.yMax + 63) & -64;
+        image.width = static_cast<unsigned int>((cbox.xMax - cbox.xMin) >> 6);
+        image.rows = static_cast<unsigned int>((cbox.yMax - cbox.yMin) >> 6);
+        image.left = static_cast<int>(cbox.xMin >> 6);
+        image.top = static_cast<int>(cbox.yMax >> 6);
+        image.outline = &glyph->outline;
+        image.originX = cbox.xMin;
+        image.originY = cbox.yMin;
+    }
+    else
+    {
+        image.width = glyph->bitmap.width;
+        image.rows = glyph->bitmap.rows;
+        image.left = glyph->bitmap_left;
+        image.top = glyph->bitmap_top;
+        if(glyph->bitmap.pixel_mode == FT_PIXEL_MODE_GRAY)
+        {
+            image.buffer = glyph->bitmap.buffer;
+            image.pitch = glyph->bitmap.pitch;
+        }
+    }
+}
+
+TTFont::GlyphMap::iterator CacheGlyph(TTFont* fnt, uint32_t utf32)
+{
+    TTF_PROFILE_SCOPE("CacheGlyph");
+    int64_t rasterStart = TextStatsTimestamp();
+    ++g_textCounters.cacheMisses;
+    g_hitchReport.BeginGlyph(fnt->name, static_cast<int>(fnt->scaler.height), utf32);
+
+    GlyphImage image;
+    LoadGlyphImage(fnt, utf32, image);
+    g_hitchReport.AddStep(GlyphStep_Load, TextStatsTimestamp() - rasterStart);
+
+    GlyphPage texture = nullptr;
+    int page = -1;
+    float uv[4] = {};
+    LoadGlyph(fnt, image, texture, page, uv[0], uv[1], uv[2], uv[3]);
+    g_hitchReport.EndGlyph();
+    g_textCounters.rasterTicks += TextStatsTimestamp() - rasterStart;
+    return fnt->cachedGlyphs.emplace(std::piecewise_construct, std::forward_as_tuple(utf32), std::forward_as_tuple(image.width,
+        image.rows, image.left, image.top, texture, uv[0], uv[1], uv[2], uv[3], image.advance, page, g_textFrame)).first;
+}
+
+static void ReloadGlyph(TTFont* fnt, TTFont::GlyphMap::value_type& glyph, int64_t restoreTicks)
+{
+    int64_t loadStart = TextStatsTimestamp();
+    g_hitchReport.BeginGlyph(fnt->name, static_cast<int>(fnt->scaler.height), glyph.first);
+    g_hitchReport.AddStep(GlyphStep_Restore, restoreTicks);
+
+    GlyphImage image;
+    LoadGlyphImage(fnt, glyph.first, image);
+    g_hitchReport.AddStep(GlyphStep_Load, TextStatsTimestamp() - loadStart);
+
+    GlyphPage texture = std::get<4>(glyph.second);
+    LoadGlyph(fnt, image, texture, std::get<10>(glyph.second), std::get<5>(glyph.second), std::get<6>(glyph.second),
+        std::get<7>(glyph.second), std::get<8>(glyph.second));
+    g_hitchReport.EndGlyph();
+    g_textCounters.rasterTicks += TextStatsTimestamp() - loadStart + restoreTicks;
+}
+
+void RestoreGlyph(TTFont* fnt, TTFont::GlyphMap::iterator it)
+{
+    TTF_PROFILE_SCOPE("RestoreGlyph");
+    GlyphPage texture = std::get<4>(it->second);
+    int64_t restoreStart = TextStatsTimestamp();
+    g_renderBackend->RestorePage(texture);
+    int64_t restoreTicks = TextStatsTimestamp() - restoreStart;
+    if(std::get<10>(it->second) < 0)
+    {
+        ReloadGlyph(fnt, *it, restoreTicks);
+        return;
+    }
+
+    // A restored page lost every glyph on it, not only the one that noticed
+    for(TTFont* owner : g_fonts)
+    {
+        for(auto& glyph : owner->cachedGlyphs)
+        {
+            if(std::get<4>(glyph.second) == texture)
+            {
+                ReloadGlyph(owner, glyph, restoreTicks);
+                restoreTicks = 0;
+            }
+        }
+    }
+}
+
+void ReleaseGlyphs(TTFont* fnt)
+{
+    for(auto& it : fnt->cachedGlyphs)
+    {
+        GlyphPage texture = std::get<4>(it.second);
+        int page = std::get<10>(it.second);
+        if(page >= 0)
+        {
+            // Pages go away together with their last glyph
+            if(!g_glyphAtlas.Free(page, GetAtlasRect(it.second)))
+            {
+                g_textureTracker.SetGlyphArea(texture, g_glyphAtlas.GetPacker(page).GetUsedArea());
+                continue;
+            }
+        }
+        g_textureTracker.Untrack(texture);
+        g_renderBackend->ReleasePage(texture);
+    }
+    fnt->cachedGlyphs.clear();
+}
+
+void DumpGlyphAtlas(const char* path)
+{
+    std::vector<AtlasDumpGlyph> glyphs;
+    for(TTFont* fnt : g_fonts)
+    {
+        for(const auto& it : fnt->cachedGlyphs)
+        {
+            if(std::get<10>(it.second) >= 0)
+                glyphs.push_back({fnt->name, it.first, std::get<10>(it.second), GetAtlasRect(it.second), std::get<11>(it.second)});
+        }
+    }
+
+    // Coverage is the last byte of every texel in all glyph texture formats
+    unsigned int pageSize = g_glyphAtlas.GetPageSize();
+    unsigned int texelSize = GetGlyphTexelSize(g_textureFormat);
+    std::vector<std::vector<unsigned char>> pixels(g_glyphAtlas.GetPageCount());
+    for(size_t i = 0; i < pixels.size(); ++i)
+    {
+        GlyphPage surface = g_glyphAtlas.GetSurface(static_cast<int>(i));
+        GlyphPageLock lock;
+        if(!surface || !g_renderBackend->LockPage(surface, nullptr, true, lock))
+            continue;
+
+        pixels[i].resize(pageSize * pageSize);
+        for(unsigned int y = 0; y < pageSize; ++y)
+        {
+            const unsigned char* texels = lock.texels + y * lock.pitch + texelSize - 1;
+            for(unsigned int x = 0; x < pageSize; ++x)
+                pixels[i][y * pageSize + x] = texels[x * texelSize];
+        }
+        g_renderBackend->UnlockPage(surface, nullptr);
+    }
+
+    if(WriteAtlasDump(path, g_glyphAtlas, glyphs, pixels, g_textFrame))
+        LogMessage("Glyph atlas written to %s.json", path);
+}
+
+void PrewarmGlyphs(TTFont* fnt)
+{
+    if(g_prewarmGlyphs <= 0 || !g_renderBackend || !g_renderBackend->IsReady())
+        return;
+
+    std::vector<uint32_t> codepoints;
+    g_prewarmManifest.GetRanked(fnt->name, static_cast<size_t>(g_prewarmGlyphs), codepoints);
+    if(codepoints.empty())
+        return;
+
+    TTF_PROFILE_SCOPE_DETAIL("PrewarmGlyphs", fnt->name.c_str());
+    int64_t prewarmStart = TextStatsTimestamp();
+    size_t created = 0;
+    for(uint32_t utf32 : codepoints)
+    {
+        // Whatever doesn't fit the budget gets created on first use as before
+        if(TextStatsTicksToMs(TextStatsTimestamp() - prewarmStart) >= g_prewarmBudgetMs)
+            break;
+
+        if(fnt->cachedGlyphs.find(utf32) == fnt->cachedGlyphs.end())
+        {
+            CacheGlyph(fnt, utf32);
+            ++created;
+        }
+    }
+    LogMessage("Prewarmed %u of %u glyphs for %s in %.3f ms", static_cast<unsigned int>(created), static_cast<unsigned int>(codepoints.size()),
+        fnt->name.c_str(), TextStatsTicksToMs(TextStatsTimestamp() - prewarmStart));
+}
+
+// Quads drawn with one texture go to the backend together, a string usually stays on one atlas page
+#define GLYPH_BATCH_QUADS 64
+
+bool FontHasCharacter(const void* font, uint32_t utf32)
+{
+    return g_faceCache.LookupGlyphIndex(static_cast<const TTFont*>(font)->scaler.face_id, utf32) != 0;
+}
+
+int DrawGlyphs(TTFont* fnt, int x, int baseline, int spaceWidth, float clipRect, uint32_t glyphColor, int encoding, const char* ctext, int len)
+{
+    TextVertex vertices[GLYPH_BATCH_QUADS * 4];
+    GlyphPage batchPage = nullptr;
+    size_t batchQuads = 0;
+    // False once the glyph starts past the clip rectangle
+    auto drawCharacter = [&](uint32_t utf32)
+    {
+        if(utf32 <= 32)
+        {
+            x += spaceWidth;
+            return true;
+        }
+
+        if(fnt->usage) ++(*fnt->usage)[utf32];
+        auto it = fnt->cachedGlyphs.find(utf32);
+        if(it == fnt->cachedGlyphs.end())
+            it = CacheGlyph(fnt, utf32);
+        else
+        {
+            ++g_textCounters.cacheHits;
+            if(g_renderBackend->IsPageLost(std::get<4>(it->second)))
+                RestoreGlyph(fnt, it);
+        }
+        GlyphPage texture = std::get<4>(it->second);
+        std::get<11>(it->second) = g_textFrame;
+
+        GlyphQuad quad;
+        BuildGlyphQuad(x, baseline, std::get<0>(it->second), std::get<1>(it->second), std::get<2>(it->second), std::get<3>(it->second),
+            std::get<5>(it->second), std::get<6>(it->second), std::get<7>(it->second), std::get<8>(it->second), g_halfPixelOffset, quad);
+        if(quad.minx > clipRect) return false;
+
+        if(batchQuads == GLYPH_BATCH_QUADS || (batchQuads > 0 && texture != batchPage))
+        {
+            g_renderBackend->DrawQuads(batchPage, vertices, batchQuads);
+            ++g_textCounters.stateChanges;
+            batchQuads = 0;
+        }
+        batchPage = texture;
+        BuildGlyphVertices(quad, glyphColor, &vertices[batchQuads * 4]);
+        ++batchQuads;
+        ++g_textCounters.glyphsDrawn;
+        x += std::get<9>(it->second);
+        return true;
+    };
+
+    if(g_bidiCache.IsNeeded(encoding, ctext, len))
+    {
+        // Combining marks, Hebrew and Arabic draw composed, shaped and in the visual order the cache worked out the first time the string showed up
+        for(uint32_t utf32 : g_bidiCache.Reorder(encoding, ctext, len, fnt, FontHasCharacter))
+        {
+            if(!drawCharacter(utf32)) break;
+        }
+    }
+    else
+    {
+        for(int i = 0; i < len;)
+        {
+            int utf8size;
+            uint32_t utf32 = DecodeCharacter(encoding, ctext + i, len - i, utf8size);
+            i += utf8size;
+            if(!drawCharacter(utf32)) break;
+        }
+    }
+
+    if(batchQuads > 0)
+    {
+        g_renderBackend->DrawQuads(batchPage, vertices, batchQuads);
+        ++g_textCounters.stateChanges;
+    }
+    return x;
+}
+
+int MeasureGlyphs(TTFont* fnt, int spaceWidth, int encoding, const char* ctext, int len)
+{
+    auto getAdvance = [fnt](uint32_t utf32)
+    {
+        return GetGlyphAdvance(fnt, utf32);
+    };
+    if(!g_bidiCache.IsNeeded(encoding, ctext, len))
+        return MeasureText(encoding, ctext, len, spaceWidth, getAdvance);
+
+    // Same characters DrawGlyphs gets from the cache, the order doesn't change the width
+    int width = 0;
+    for(uint32_t utf32 : g_bidiCache.Reorder(encoding, ctext, len, fnt, FontHasCharacter))
+        width += (utf32 <= 32 ? spaceWidth : getAdvance(utf32));
+    return width;
+}
+
+int MeasurePrefix(PrefixMeasure& measure, TTFont* fnt, int spaceWidth, int encoding, const char* ctext, int len)
+{
+    if(g_bidiCache.IsNeeded(encoding, ctext, len))
+        return MeasureGlyphs(fnt, spaceWidth, encoding, ctext, len);
+
+    int width = measure.Measure(fnt->traceId, encoding, ctext, len, spaceWidth, [fnt](uint32_t utf32)
+    {
+        return GetGlyphAdvance(fnt, utf32);
+    });
+    if(fnt->usage)
+    {
+        // The reused characters skipped GetGlyphAdvance and its counting
+        int reused = static_cast<int>(measure.GetReusedLength());
+        for(int i = 0; i < reused;)
+        {
+            int utf8size;
+            uint32_t utf32 = DecodeCharacter(encoding, ctext + i, reused - i, utf8size);
+            i += utf8size;
+            if(utf32 > 32)
+                ++(*fnt->usage)[utf32];
+        }
+    }
+    return width;
+}
+
+static void SetFontScaler(TTFont* ttFont, const std::string& fontPath, int size)
+{
+    ttFont->scaler.face_id = g_faceCache.GetFaceID(fontPath);
+    ttFont->scaler.width = 0;
+    ttFont->scaler.height = static_cast<FT_UInt>(size);
+    ttFont->scaler.pixel = 1;
+    ttFont->scaler.x_res = 0;
+    ttFont->scaler.y_res = 0;
+    ttFont->useSBits = (size <= g_sbitMaxSize);
+}
+
+bool OpenFontFace(TTFont* ttFont, const std::string& fontPath, int size)
+{
+    TTF_PROFILE_SCOPE("OpenFontFace");
+    SetFontScaler(ttFont, fontPath, size);
+
+    FT_Size fontSize = g_faceCache.LookupSize(&ttFont->scaler);
+    if(!fontSize)
+        return false;
+
+    FT_Face fontFace = fontSize->face;
+    if(FT_IS_SCALABLE(fontFace))
+    {
+        FT_Fixed scale = fontSize->metrics.y_scale;
+        int height = FT_MulFix(fontFace->height, scale);
+        int ascent = FT_MulFix(fontFace->ascender, scale);
+        int descent = FT_MulFix(fontFace->descender, scale);
+        ttFont->height = static_cast<int>(((height + 63) & -64) / 64);
+        ttFont->ascent = static_cast<int>(((ascent + 63) & -64) / 64);
+        ttFont->descent = static_cast<int>(((descent + 63) & -64) / 64);
+    }
+    else
+    {
+        ttFont->height = static_cast<int>(((fontSize->metrics.height + 63) & -64) / 64);
+        ttFont->ascent = static_cast<int>(((fontSize->metrics.ascender + 63) & -64) / 64);
+        ttFont->descent = static_cast<int>(((fontSize->metrics.descender + 63) & -64) / 64);
+    }
+    return true;
+}
+
+bool ResolveFontDescriptor(std::string& fontName)
+{
+    std::transform(fontName.begin(), fontName.end(), fontName.begin(), toupper);
+    if(fontName.find(':') == std::string::npos)
+    {
+        auto it = g_fontsWrapper.find(fontName);
+        if(it == g_fontsWrapper.end())
+        {
+            it = g_fontsWrapper.find("DEFAULT");
+            if(it == g_fontsWrapper.end())
+                return false;
+        }
+        fontName.assign(it->second);
+    }
+    return true;
+}
+
+TTFont* LoadFont(const std::string& fontName, void(*resolveFontFile)(std::string&, int&))
+{
+    int size = 20, r = 0xFF, g = 0xFF, b = 0xFF, a = 0xFF;
+    std::string fntName;
+    ReadFontDetails(fontName, fntName, size, r, g, b, a);
+    if(g_useBGRA) std::swap(r, b);
+    if(resolveFontFile)
+        resolveFontFile(fntName, size);
+
+    TTFont* ttFont = new TTFont;
+    ttFont->name = fontName;
+    ttFont->traceId = ++g_traceFonts;
+    g_textTrace.LoadFont(ttFont->traceId, fontName);
+    ttFont->r = r; ttFont->g = g; ttFont->b = b; ttFont->a = a;
+    ttFont->color = static_cast<uint32_t>(r | (g << 8) | (b << 16));
+    BuildAlphaTable(ttFont->alphaTable, a, g_textGamma);
+    if(!OpenFontFace(ttFont, fntName, size))
+    {
+        delete ttFont;
+        return nullptr;
+    }
+
+    g_fonts.emplace(ttFont);
+    if(g_recordUsage)
+        ttFont->usage = g_glyphUsage.GetHistogram(fontName);
+    PrewarmGlyphs(ttFont);
+    return ttFont;
+}
+
+int GetGlyphAdvance(TTFont* ttFont, uint32_t utf32)
+{
+    if(ttFont->usage) ++(*ttFont->usage)[utf32];
+    auto it = ttFont->cachedGlyphs.find(utf32);
+    if(it == ttFont->cachedGlyphs.end())
+        it = CacheGlyph(ttFont, utf32);
+    else
+        ++g_textCounters.cacheHits;
+    return std::get<9>(it->second);
+}
+
+void UnloadFont(TTFont* ttFont)
+{
+    ReleaseGlyphs(ttFont);
+    g_fonts.erase(ttFont);
+    delete ttFont;
+}
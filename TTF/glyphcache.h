@@ -0,0 +1,125 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_CACHE_H
+
+#include "bidi.h"
+#include "facecache.h"
+#include "ftmemory.h"
+#include "glyphatlas.h"
+#include "glyphconvert.h"
+#include "glyphusage.h"
+#include "hitchreport.h"
+#include "renderbackend.h"
+#include "texttrace.h"
+#include "texturetracker.h"
+
+class PrefixMeasure;
+
+// Glyph cache, texture upload and the draw loop shared by the plugin and the headless tools
+// Nothing in here touches the engine or Win32, pages come from g_renderBackend
+struct TTFont
+{
+    // The last two members are the atlas page, -1 for glyphs with a surface of their own, and the frame the glyph was last drawn in
+    typedef std::unordered_map<uint32_t, std::tuple<unsigned int, unsigned int, int, int, GlyphPage, float, float, float, float, int, int, uint32_t>> GlyphMap;
+
+    std::string name;
+    uint32_t traceId = 0;
+    FTC_ScalerRec scaler = {};
+    bool useSBits = false;
+    GlyphMap cachedGlyphs;
+    GlyphHistogram* usage = nullptr;
+    int height = 0, ascent = 0, descent = 0;
+    int r, g, b, a;
+    uint32_t color;
+    unsigned char alphaTable[256];
+};
+
+struct GlyphImage
+{
+    unsigned int width, rows;
+    int left, top, advance;
+    // Gray coverage copied into the texture
+    const unsigned char* buffer;
+    int pitch;
+    // Outline rasterized straight into the texture instead
+    FT_Outline* outline;
+    FT_Pos originX, originY;
+};
+
+// Render and texture stage states set and restored around every text draw call
+#define TEXT_SETUP_STATE_CHANGES 27
+
+extern bool g_useBGRA;
+extern bool g_useDirectRaster;
+// GD3D11 maps texels to pixels the Direct3D 10 way and needs no half pixel offset
+extern bool g_halfPixelOffset;
+extern GlyphTextureFormat g_textureFormat;
+extern float g_textGamma;
+extern int g_sbitMaxSize;
+extern FT_UInt g_maxFaces;
+extern FT_UInt g_maxSizes;
+extern FT_ULong g_maxBytes;
+extern BidiCache g_bidiCache;
+extern std::unordered_set<TTFont*> g_fonts;
+extern FTPoolAllocator g_ftAllocator;
+extern FT_Library g_ft;
+extern FaceCache g_faceCache;
+extern TextureTracker g_textureTracker;
+extern HitchReport g_hitchReport;
+extern GlyphAtlas g_glyphAtlas;
+extern GlyphRenderBackend* g_renderBackend;
+extern uint32_t g_textFrame;
+extern uint32_t g_traceFonts;
+extern TextTraceWriter g_textTrace;
+extern bool g_recordUsage;
+extern GlyphUsage g_glyphUsage;
+extern int g_prewarmGlyphs;
+extern double g_prewarmBudgetMs;
+extern GlyphUsage g_prewarmManifest;
+// Names of the [FONTS] section and the descriptors they stand for
+extern std::unordered_map<std::string, std::string> g_fontsWrapper;
+// Shows errors the text path can't recover from before the process exits
+extern void(*g_showFatalError)(const char* message);
+
+// Creates g_ft on the pooled allocator together with the face cache, addModules registers the FreeType modules and nullptr all of them
+bool InitializeFreeType(void(*addModules)(FT_Library));
+void ShutdownFreeType();
+void LogFreeTypeMemory();
+void LogFontCacheStats();
+
+// Luminance textures don't carry the font color so it gets applied through the vertex color
+uint32_t GetGlyphColor(const TTFont* fnt, uint32_t color);
+
+void LoadGlyphImage(TTFont* fnt, uint32_t utf32, GlyphImage& image);
+TTFont::GlyphMap::iterator CacheGlyph(TTFont* fnt, uint32_t utf32);
+void RestoreGlyph(TTFont* fnt, TTFont::GlyphMap::iterator it);
+void ReleaseGlyphs(TTFont* fnt);
+// Writes every atlas page as <path>_<page>.png and the glyphs on them as <path>.json
+void DumpGlyphAtlas(const char* path);
+void PrewarmGlyphs(TTFont* fnt);
+
+// Draws a string with the text state already set up, spaceWidth advances control characters and spaces
+// Returns the pen position after the last glyph drawn
+int DrawGlyphs(TTFont* fnt, int x, int baseline, int spaceWidth, float clipRect, uint32_t glyphColor, int encoding, const char* ctext, int len);
+int GetGlyphAdvance(TTFont* fnt, uint32_t utf32);
+// CharacterCoverage of the fonts, marks only compose into the precomposed characters the font has
+bool FontHasCharacter(const void* font, uint32_t utf32);
+// Width of a string the way DrawGlyphs draws it, composed and shaped when the bidi cache changes it
+int MeasureGlyphs(TTFont* fnt, int spaceWidth, int encoding, const char* ctext, int len);
+// MeasureGlyphs for the engine's word wrap, which measures the line it builds after every word it adds
+// Only the new characters get looked up, the font's usage histogram still counts the whole line
+int MeasurePrefix(PrefixMeasure& measure, TTFont* fnt, int spaceWidth, int encoding, const char* ctext, int len);
+
+bool OpenFontFace(TTFont* ttFont, const std::string& fontPath, int size);
+// Descriptors are either a name from the [FONTS] section or <file>:Size=..:R=..:G=..:B=..:A=..
+bool ResolveFontDescriptor(std::string& fontName);
+// Opens a resolved descriptor, resolveFontFile turns its file into a path and may change the size, nullptr when the face doesn't open
+TTFont* LoadFont(const std::string& fontName, void(*resolveFontFile)(std::string&, int&));
+void UnloadFont(TTFont* ttFont);
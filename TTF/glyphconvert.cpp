@@ -0,0 +1,213 @@
+#include "glyphconvert.h"
+
+#include <math.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GLYPH_TARGET_SSSE3
+#else
+#include <cpuid.h>
+#define GLYPH_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+
+namespace
+{
+    void ConvertRow_BGRA8888_Scalar(unsigned char* dst, const unsigned char* src, int width, const unsigned char* alphaTable, uint32_t color)
+    {
+        uint32_t* texels = reinterpret_cast<uint32_t*>(dst);
+        for(int w = 0; w < width; ++w)
+            texels[w] = color | (static_cast<uint32_t>(alphaTable[src[w]]) << 24);
+    }
+
+    void ConvertRow_A8L8_Scalar(unsigned char* dst, const unsigned char* src, int width, const unsigned char* alphaTable, uint32_t)
+    {
+        uint16_t* texels = reinterpret_cast<uint16_t*>(dst);
+        for(int w = 0; w < width; ++w)
+            texels[w] = static_cast<uint16_t>(0x00FF | (alphaTable[src[w]] << 8));
+    }
+
+    // There is no byte gather before AVX2 so the table lookup stays scalar and only the texel expansion is vectorized
+    inline __m128i LookupAlpha_SSE2(const unsigned char* src, const unsigned char* alphaTable)
+    {
+        // Packing the looked up bytes in general purpose registers avoids a store forwarding stall on the vector load
+        int alpha[4];
+        for(int i = 0; i < 4; ++i)
+        {
+            const unsigned char* quad = src + i * 4;
+            alpha[i] = static_cast<int>(alphaTable[quad[0]] | (alphaTable[quad[1]] << 8) | (alphaTable[quad[2]] << 16) | (static_cast<unsigned int>(alphaTable[quad[3]]) << 24));
+        }
+        return _mm_setr_epi32(alpha[0], alpha[1], alpha[2], alpha[3]);
+    }
+
+    inline void StoreBGRA8888(unsigned char* dst, __m128i alpha, __m128i color)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_unpacklo_epi8(zero, alpha);
+        __m128i hi = _mm_unpackhi_epi8(zero, alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_or_si128(_mm_unpacklo_epi16(zero, lo), color));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_or_si128(_mm_unpackhi_epi16(zero, lo), color));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_or_si128(_mm_unpacklo_epi16(zero, hi), color));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_or_si128(_mm_unpackhi_epi16(zero, hi), color));
+    }
+
+    inline void StoreA8L8(unsigned char* dst, __m128i alpha)
+    {
+        __m128i luminance = _mm_set1_epi8(static_cast<char>(0xFF));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi8(luminance, alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(luminance, alpha));
+    }
+
+    void ConvertRow_BGRA8888_SSE2(unsigned char* dst, const unsigned char* src, int width, const unsigned char* alphaTable, uint32_t color)
+    {
+        __m128i colors = _mm_set1_epi32(static_cast<int>(color));
+        int w = 0;
+        for(; w + 16 <= width; w += 16)
+            StoreBGRA8888(dst + w * 4, LookupAlpha_SSE2(src + w, alphaTable), colors);
+        ConvertRow_BGRA8888_Scalar(dst + w * 4, src + w, width - w, alphaTable, color);
+    }
+
+    void ConvertRow_A8L8_SSE2(unsigned char* dst, const unsigned char* src, int width, const unsigned char* alphaTable, uint32_t color)
+    {
+        int w = 0;
+        for(; w + 16 <= width; w += 16)
+            StoreA8L8(dst + w * 2, LookupAlpha_SSE2(src + w, alphaTable));
+        ConvertRow_A8L8_Scalar(dst + w * 2, src + w, width - w, alphaTable, color);
+    }
+
+    // pshufb moves every alpha byte straight into its texel, replacing the SSE2 unpack chains
+    GLYPH_TARGET_SSSE3 void ConvertRow_BGRA8888_SSSE3(unsigned char* dst, const unsigned char* src, int width, const unsigned char* alphaTable, uint32_t color)
+    {
+        const char z = static_cast<char>(0x80);
+        __m128i shuffle0 = _mm_setr_epi8(z, z, z, 0, z, z, z, 1, z, z, z, 2, z, z, z, 3);
+        __m128i shuffle1 = _mm_setr_epi8(z, z, z, 4, z, z, z, 5, z, z, z, 6, z, z, z, 7);
+        __m128i shuffle2 = _mm_setr_epi8(z, z, z, 8, z, z, z, 9, z, z, z, 10, z, z, z, 11);
+        __m128i shuffle3 = _mm_setr_epi8(z, z, z, 12, z, z, z, 13, z, z, z, 14, z, z, z, 15);
+        __m128i colors = _mm_set1_epi32(static_cast<int>(color));
+        int w = 0;
+        for(; w + 16 <= width; w += 16)
+        {
+            __m128i alpha = LookupAlpha_SSE2(src + w, alphaTable);
+            unsigned char* texels = dst + w * 4;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(texels + 0), _mm_or_si128(_mm_shuffle_epi8(alpha, shuffle0), colors));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(texels + 16), _mm_or_si128(_mm_shuffle_epi8(alpha, shuffle1), colors));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(texels + 32), _mm_or_si128(_mm_shuffle_epi8(alpha, shuffle2), colors));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(texels + 48), _mm_or_si128(_mm_shuffle_epi8(alpha, shuffle3), colors));
+        }
+        ConvertRow_BGRA8888_Scalar(dst + w * 4, src + w, width - w, alphaTable, color);
+    }
+
+    GLYPH_TARGET_SSSE3 void ConvertRow_A8L8_SSSE3(unsigned char* dst, const unsigned char* src, int width, const unsigned char* alphaTable, uint32_t color)
+    {
+        const char z = static_cast<char>(0x80);
+        __m128i shuffle0 = _mm_setr_epi8(z, 0, z, 1, z, 2, z, 3, z, 4, z, 5, z, 6, z, 7);
+        __m128i shuffle1 = _mm_setr_epi8(z, 8, z, 9, z, 10, z, 11, z, 12, z, 13, z, 14, z, 15);
+        __m128i luminance = _mm_set1_epi16(0x00FF);
+        int w = 0;
+        for(; w + 16 <= width; w += 16)
+        {
+            __m128i alpha = LookupAlpha_SSE2(src + w, alphaTable);
+            unsigned char* texels = dst + w * 2;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(texels + 0), _mm_or_si128(_mm_shuffle_epi8(alpha, shuffle0), luminance));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(texels + 16), _mm_or_si128(_mm_shuffle_epi8(alpha, shuffle1), luminance));
+        }
+        ConvertRow_A8L8_Scalar(dst + w * 2, src + w, width - w, alphaTable, color);
+    }
+
+    const GlyphConvertRowFunc g_convertRows[GlyphFormat_Count][3] = {
+        {ConvertRow_BGRA8888_Scalar, ConvertRow_BGRA8888_SSE2, ConvertRow_BGRA8888_SSSE3},
+        {ConvertRow_A8L8_Scalar, ConvertRow_A8L8_SSE2, ConvertRow_A8L8_SSSE3},
+    };
+
+    GlyphConvertLevel DetectGlyphConvertLevel()
+    {
+        unsigned int ecx, edx;
+#ifdef _MSC_VER
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 0);
+        if(cpuInfo[0] < 1)
+            return GlyphConvert_Scalar;
+        __cpuid(cpuInfo, 1);
+        ecx = static_cast<unsigned int>(cpuInfo[2]);
+        edx = static_cast<unsigned int>(cpuInfo[3]);
+#else
+        unsigned int eax, ebx;
+        if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return GlyphConvert_Scalar;
+#endif
+        if(ecx & (1u << 9))
+            return GlyphConvert_SSSE3;
+        if(edx & (1u << 26))
+            return GlyphConvert_SSE2;
+        return GlyphConvert_Scalar;
+    }
+}
+
+void BuildAlphaTable(unsigned char alphaTable[256], int alpha, float gamma)
+{
+    if(alpha < 0) alpha = 0;
+    if(alpha > 255) alpha = 255;
+    for(int i = 0; i < 256; ++i)
+    {
+        int coverage = i;
+        if(gamma > 0.f && gamma != 1.f)
+            coverage = static_cast<int>(powf(i / 255.f, 1.f / gamma) * 255.f + 0.5f);
+        alphaTable[i] = static_cast<unsigned char>(coverage * alpha / 255);
+    }
+}
+
+unsigned int GetGlyphTexelSize(GlyphTextureFormat format)
+{
+    switch(format)
+    {
+        case GlyphFormat_A8L8: return 2;
+        default: return 4;
+    }
+}
+
+GlyphConvertLevel GetGlyphConvertLevel()
+{
+    static GlyphConvertLevel level = DetectGlyphConvertLevel();
+    return level;
+}
+
+GlyphConvertRowFunc GetGlyphConvertRow(GlyphTextureFormat format, GlyphConvertLevel level)
+{
+    return g_convertRows[format][level];
+}
+
+void ConvertGlyphBitmap(GlyphTextureFormat format, unsigned char* dst, int dstPitch, const unsigned char* src, int srcPitch, int width, int height,
+    const unsigned char* alphaTable, uint32_t color)
+{
+    GlyphConvertRowFunc convertRow = GetGlyphConvertRow(format, GetGlyphConvertLevel());
+    for(int h = 0; h < height; ++h)
+    {
+        convertRow(dst, src, width, alphaTable, color);
+        dst += dstPitch;
+        src += srcPitch;
+    }
+}
+
+void FillGlyphSpan(GlyphTextureFormat format, unsigned char* dst, int length, unsigned char alpha, uint32_t color)
+{
+    switch(format)
+    {
+        case GlyphFormat_A8L8:
+        {
+            uint16_t texel = static_cast<uint16_t>(0x00FF | (alpha << 8));
+            uint16_t* texels = reinterpret_cast<uint16_t*>(dst);
+            for(int w = 0; w < length; ++w)
+                texels[w] = texel;
+        }
+        break;
+        default:
+        {
+            uint32_t texel = color | (static_cast<uint32_t>(alpha) << 24);
+            uint32_t* texels = reinterpret_cast<uint32_t*>(dst);
+            for(int w = 0; w < length; ++w)
+                texels[w] = texel;
+        }
+        break;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+
+// Converts 8-bit coverage rows coming from FreeType into glyph texture texels
+// Coverage is mapped through a per-font 256 entry alpha table so the font alpha and gamma cost nothing per texel
+// Kernels are picked at runtime from SSSE3, SSE2 and scalar variants, all of them produce identical output
+enum GlyphTextureFormat
+{
+    GlyphFormat_BGRA8888 = 0,
+    GlyphFormat_A8L8,
+    GlyphFormat_Count
+};
+
+enum GlyphConvertLevel
+{
+    GlyphConvert_Scalar = 0,
+    GlyphConvert_SSE2,
+    GlyphConvert_SSSE3
+};
+
+typedef void(*GlyphConvertRowFunc)(unsigned char* dst, const unsigned char* src, int width, const unsigned char* alphaTable, uint32_t color);
+
+void BuildAlphaTable(unsigned char alphaTable[256], int alpha, float gamma);
+unsigned int GetGlyphTexelSize(GlyphTextureFormat format);
+
+GlyphConvertLevel GetGlyphConvertLevel();
+GlyphConvertRowFunc GetGlyphConvertRow(GlyphTextureFormat format, GlyphConvertLevel level);
+
+// color holds the texel bytes that precede alpha in BGRA8888 textures, other formats ignore it
+void ConvertGlyphBitmap(GlyphTextureFormat format, unsigned char* dst, int dstPitch, const unsigned char* src, int srcPitch, int width, int height,
+    const unsigned char* alphaTable, uint32_t color);
+void FillGlyphSpan(GlyphTextureFormat format, unsigned char* dst, int length, unsigned char alpha, uint32_t color);
@@ -0,0 +1,85 @@
+#include "glyphusage.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+typedef std::pair<uint32_t, uint32_t> GlyphCount;
+
+static void SortByUsage(const GlyphHistogram& histogram, std::vector<GlyphCount>& counts)
+{
+    counts.assign(histogram.begin(), histogram.end());
+    std::sort(counts.begin(), counts.end(), [](const GlyphCount& a, const GlyphCount& b)
+    {
+        // Ties are broken by codepoint so the manifest doesn't depend on hash order
+        return (a.second != b.second ? a.second > b.second : a.first < b.first);
+    });
+}
+
+bool GlyphUsage::Load(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if(!f)
+        return false;
+
+    GlyphHistogram* histogram = nullptr;
+    char line[512];
+    while(fgets(line, sizeof(line), f) != nullptr)
+    {
+        size_t len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        if(line[0] == '[')
+        {
+            char* end = strrchr(line, ']');
+            if(end)
+                histogram = &m_fonts[std::string(line + 1, end)];
+            continue;
+        }
+
+        unsigned int codepoint, count;
+        if(histogram && sscanf(line, "U+%X %u", &codepoint, &count) == 2)
+        {
+            uint32_t& total = (*histogram)[codepoint];
+            total = (count > UINT32_MAX - total ? UINT32_MAX : total + count);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+bool GlyphUsage::Save(const char* path) const
+{
+    FILE* f = fopen(path, "w");
+    if(!f)
+        return false;
+
+    std::vector<GlyphCount> counts;
+    for(const auto& font : m_fonts)
+    {
+        if(font.second.empty())
+            continue;
+
+        fprintf(f, "[%s]\n", font.first.c_str());
+        SortByUsage(font.second, counts);
+        for(const GlyphCount& count : counts)
+            fprintf(f, "U+%04X %u\n", count.first, count.second);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return true;
+}
+
+void GlyphUsage::GetRanked(const std::string& font, size_t limit, std::vector<uint32_t>& codepoints) const
+{
+    codepoints.clear();
+    auto it = m_fonts.find(font);
+    if(it == m_fonts.end())
+        return;
+
+    std::vector<GlyphCount> counts;
+    SortByUsage(it->second, counts);
+    if(counts.size() > limit)
+        counts.resize(limit);
+    for(const GlyphCount& count : counts)
+        codepoints.push_back(count.first);
+}
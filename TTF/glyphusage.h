@@ -0,0 +1,34 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef std::unordered_map<uint32_t, uint32_t> GlyphHistogram;
+
+// Counts how often each codepoint gets requested from every font descriptor
+// Histograms are plain text so sessions can be merged into a ranked prewarm manifest
+class GlyphUsage
+{
+    public:
+        GlyphUsage() = default;
+        GlyphUsage(const GlyphUsage&) = delete;
+        GlyphUsage& operator=(const GlyphUsage&) = delete;
+
+        // The returned histogram stays valid for the lifetime of this object
+        GlyphHistogram* GetHistogram(const std::string& font) {return &m_fonts[font];}
+
+        // Loading adds to the current counts so several files merge into one histogram
+        bool Load(const char* path);
+        bool Save(const char* path) const;
+
+        // Codepoints of the font ordered from the most to the least requested one
+        void GetRanked(const std::string& font, size_t limit, std::vector<uint32_t>& codepoints) const;
+
+        bool IsEmpty() const {return m_fonts.empty();}
+
+    private:
+        std::map<std::string, GlyphHistogram> m_fonts;
+};
@@ -0,0 +1,64 @@
+#include "hitchreport.h"
+#include "textstats.h"
+#include "log.h"
+
+#include <algorithm>
+
+#define HITCH_WORST_OFFENDERS 5
+
+void HitchReport::BeginGlyph(const std::string& font, int size, uint32_t codepoint)
+{
+    if(!IsEnabled())
+        return;
+
+    m_glyphs.emplace_back();
+    m_current = &m_glyphs.back();
+    m_current->font = font;
+    m_current->size = size;
+    m_current->codepoint = codepoint;
+    std::fill(std::begin(m_current->steps), std::end(m_current->steps), 0);
+    m_current->total = 0;
+}
+
+void HitchReport::AddStep(GlyphWorkStep step, int64_t ticks)
+{
+    if(!m_current)
+        return;
+
+    m_current->steps[step] += ticks;
+    m_current->total += ticks;
+}
+
+void HitchReport::EndGlyph()
+{
+    m_current = nullptr;
+}
+
+void HitchReport::EndFrame()
+{
+    ++m_frame;
+    if(m_glyphs.empty())
+        return;
+
+    int64_t frameTicks = 0;
+    for(const GlyphWork& glyph : m_glyphs)
+        frameTicks += glyph.total;
+
+    double frameMs = TextStatsTicksToMs(frameTicks);
+    if(frameMs >= m_thresholdMs)
+    {
+        size_t offenders = std::min<size_t>(m_glyphs.size(), HITCH_WORST_OFFENDERS);
+        std::partial_sort(m_glyphs.begin(), m_glyphs.begin() + offenders, m_glyphs.end(), [](const GlyphWork& a, const GlyphWork& b) {return a.total > b.total;});
+
+        LogMessage("Text hitch in frame %u: %.3f ms of glyph work for %u glyphs", m_frame, frameMs, static_cast<unsigned int>(m_glyphs.size()));
+        for(size_t i = 0; i < offenders; ++i)
+        {
+            const GlyphWork& glyph = m_glyphs[i];
+            LogMessage("    %s size %d U+%04X: %.3f ms (load %.3f, create %.3f, lock %.3f, fill %.3f, restore %.3f)", glyph.font.c_str(), glyph.size,
+                glyph.codepoint, TextStatsTicksToMs(glyph.total), TextStatsTicksToMs(glyph.steps[GlyphStep_Load]),
+                TextStatsTicksToMs(glyph.steps[GlyphStep_CreateSurface]), TextStatsTicksToMs(glyph.steps[GlyphStep_Lock]),
+                TextStatsTicksToMs(glyph.steps[GlyphStep_Fill]), TextStatsTicksToMs(glyph.steps[GlyphStep_Restore]));
+        }
+    }
+    m_glyphs.clear();
+}
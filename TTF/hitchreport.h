@@ -0,0 +1,49 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Attributes frames that stall on synchronous glyph work to the fonts and codepoints that caused them
+enum GlyphWorkStep
+{
+    GlyphStep_Load = 0,
+    GlyphStep_CreateSurface,
+    GlyphStep_Lock,
+    GlyphStep_Fill,
+    GlyphStep_Restore,
+    GlyphStep_Count
+};
+
+class HitchReport
+{
+    public:
+        HitchReport() = default;
+        HitchReport(const HitchReport&) = delete;
+        HitchReport& operator=(const HitchReport&) = delete;
+
+        // Frames with more glyph work than thresholdMs get logged, 0 disables the report
+        void SetThreshold(double thresholdMs) {m_thresholdMs = thresholdMs;}
+        bool IsEnabled() const {return m_thresholdMs > 0.0;}
+
+        void BeginGlyph(const std::string& font, int size, uint32_t codepoint);
+        void AddStep(GlyphWorkStep step, int64_t ticks);
+        void EndGlyph();
+
+        void EndFrame();
+
+    private:
+        struct GlyphWork
+        {
+            std::string font;
+            int size;
+            uint32_t codepoint;
+            int64_t steps[GlyphStep_Count];
+            int64_t total;
+        };
+
+        std::vector<GlyphWork> m_glyphs;
+        GlyphWork* m_current = nullptr;
+        double m_thresholdMs = 0.0;
+        uint32_t m_frame = 0;
+};
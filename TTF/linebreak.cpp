@@ -0,0 +1,321 @@
+#include "linebreak.h"
+
+#include <algorithm>
+
+struct LineBreakRange
+{
+    uint32_t first;
+    uint32_t last;
+    LineBreakClass lineClass;
+};
+
+static const LineBreakClass g_asciiClasses[128] = {
+    LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM,
+    LineBreak_CM, LineBreak_BA, LineBreak_LF, LineBreak_BK, LineBreak_BK, LineBreak_CR, LineBreak_CM, LineBreak_CM,
+    LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM,
+    LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM, LineBreak_CM,
+    LineBreak_SP, LineBreak_EX, LineBreak_QU, LineBreak_AL, LineBreak_PR, LineBreak_PO, LineBreak_AL, LineBreak_QU,
+    LineBreak_OP, LineBreak_CP, LineBreak_AL, LineBreak_PR, LineBreak_IS, LineBreak_HY, LineBreak_IS, LineBreak_SY,
+    LineBreak_NU, LineBreak_NU, LineBreak_NU, LineBreak_NU, LineBreak_NU, LineBreak_NU, LineBreak_NU, LineBreak_NU,
+    LineBreak_NU, LineBreak_NU, LineBreak_IS, LineBreak_IS, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_EX,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_OP, LineBreak_PR, LineBreak_CP, LineBreak_AL, LineBreak_AL,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_AL,
+    LineBreak_AL, LineBreak_AL, LineBreak_AL, LineBreak_OP, LineBreak_BA, LineBreak_CL, LineBreak_AL, LineBreak_CM,
+};
+
+// Everything above ASCII that isn't AL, sorted by code point. Covers the scripts the game gets translated to,
+// the general punctuation and the CJK blocks, scripts without an entry break like Latin.
+static const LineBreakRange g_lineBreakRanges[] = {
+    {0x0080, 0x0084, LineBreak_CM}, {0x0085, 0x0085, LineBreak_NL}, {0x0086, 0x009F, LineBreak_CM},
+    {0x00A0, 0x00A0, LineBreak_GL}, {0x00A1, 0x00A1, LineBreak_OP}, {0x00A2, 0x00A2, LineBreak_PO},
+    {0x00A3, 0x00A5, LineBreak_PR}, {0x00AB, 0x00AB, LineBreak_QU}, {0x00AD, 0x00AD, LineBreak_BA},
+    {0x00B0, 0x00B0, LineBreak_PO}, {0x00B1, 0x00B1, LineBreak_PR}, {0x00B4, 0x00B4, LineBreak_BB},
+    {0x00BB, 0x00BB, LineBreak_QU}, {0x00BF, 0x00BF, LineBreak_OP},
+    {0x02C8, 0x02C8, LineBreak_BB}, {0x02CC, 0x02CC, LineBreak_BB}, {0x02DF, 0x02DF, LineBreak_BB},
+    {0x0300, 0x034E, LineBreak_CM}, {0x034F, 0x034F, LineBreak_GL}, {0x0350, 0x035B, LineBreak_CM},
+    {0x035C, 0x0362, LineBreak_GL}, {0x0363, 0x036F, LineBreak_CM}, {0x037E, 0x037E, LineBreak_IS},
+    {0x0483, 0x0489, LineBreak_CM}, {0x0589, 0x0589, LineBreak_IS}, {0x058A, 0x058A, LineBreak_BA},
+    {0x0591, 0x05BD, LineBreak_CM}, {0x05BE, 0x05BE, LineBreak_BA}, {0x05BF, 0x05BF, LineBreak_CM},
+    {0x05C1, 0x05C2, LineBreak_CM}, {0x05C4, 0x05C5, LineBreak_CM}, {0x05C7, 0x05C7, LineBreak_CM},
+    {0x05D0, 0x05EA, LineBreak_HL}, {0x05EF, 0x05F2, LineBreak_HL},
+    {0x0609, 0x060B, LineBreak_PO}, {0x060C, 0x060D, LineBreak_IS}, {0x0610, 0x061A, LineBreak_CM},
+    {0x061B, 0x061B, LineBreak_EX}, {0x061C, 0x061C, LineBreak_CM}, {0x061D, 0x061F, LineBreak_EX},
+    {0x064B, 0x065F, LineBreak_CM}, {0x0660, 0x0669, LineBreak_NU}, {0x066A, 0x066A, LineBreak_PO},
+    {0x066B, 0x066C, LineBreak_NU}, {0x0670, 0x0670, LineBreak_CM}, {0x06D4, 0x06D4, LineBreak_EX},
+    {0x06D6, 0x06DC, LineBreak_CM}, {0x06DF, 0x06E4, LineBreak_CM}, {0x06E7, 0x06E8, LineBreak_CM},
+    {0x06EA, 0x06ED, LineBreak_CM}, {0x06F0, 0x06F9, LineBreak_NU},
+    {0x1100, 0x115F, LineBreak_ID}, {0x1160, 0x11FF, LineBreak_CM}, {0x1680, 0x1680, LineBreak_BA},
+    {0x1AB0, 0x1AFF, LineBreak_CM}, {0x1DC0, 0x1DFF, LineBreak_CM},
+    {0x2000, 0x2006, LineBreak_BA}, {0x2007, 0x2007, LineBreak_GL}, {0x2008, 0x200A, LineBreak_BA},
+    {0x200B, 0x200B, LineBreak_ZW}, {0x200C, 0x200C, LineBreak_CM}, {0x200D, 0x200D, LineBreak_ZWJ},
+    {0x2010, 0x2010, LineBreak_BA}, {0x2011, 0x2011, LineBreak_GL}, {0x2012, 0x2013, LineBreak_BA},
+    {0x2014, 0x2014, LineBreak_B2}, {0x2018, 0x2019, LineBreak_QU}, {0x201A, 0x201A, LineBreak_OP},
+    {0x201B, 0x201D, LineBreak_QU}, {0x201E, 0x201E, LineBreak_OP}, {0x201F, 0x201F, LineBreak_QU},
+    {0x2024, 0x2026, LineBreak_IN}, {0x2027, 0x2027, LineBreak_BA}, {0x2028, 0x2029, LineBreak_BK},
+    {0x202F, 0x202F, LineBreak_GL}, {0x2030, 0x2037, LineBreak_PO}, {0x2039, 0x203A, LineBreak_QU},
+    {0x203C, 0x203D, LineBreak_NS}, {0x2044, 0x2044, LineBreak_IS}, {0x2045, 0x2045, LineBreak_OP},
+    {0x2046, 0x2046, LineBreak_CL}, {0x2047, 0x2049, LineBreak_NS}, {0x2060, 0x2060, LineBreak_WJ},
+    {0x20A0, 0x20CF, LineBreak_PR}, {0x20D0, 0x20FF, LineBreak_CM}, {0x2103, 0x2103, LineBreak_PO},
+    {0x2109, 0x2109, LineBreak_PO}, {0x2116, 0x2116, LineBreak_PR}, {0x2212, 0x2213, LineBreak_PR},
+    {0x2308, 0x2308, LineBreak_OP}, {0x2309, 0x2309, LineBreak_CL}, {0x230A, 0x230A, LineBreak_OP},
+    {0x230B, 0x230B, LineBreak_CL}, {0x2329, 0x2329, LineBreak_OP}, {0x232A, 0x232A, LineBreak_CL},
+    {0x2E3A, 0x2E3B, LineBreak_B2}, {0x2E80, 0x2FFF, LineBreak_ID},
+    {0x3000, 0x3000, LineBreak_BA}, {0x3001, 0x3002, LineBreak_CL}, {0x3003, 0x3004, LineBreak_ID},
+    {0x3005, 0x3005, LineBreak_NS}, {0x3006, 0x3007, LineBreak_ID}, {0x3008, 0x3008, LineBreak_OP},
+    {0x3009, 0x3009, LineBreak_CL}, {0x300A, 0x300A, LineBreak_OP}, {0x300B, 0x300B, LineBreak_CL},
+    {0x300C, 0x300C, LineBreak_OP}, {0x300D, 0x300D, LineBreak_CL}, {0x300E, 0x300E, LineBreak_OP},
+    {0x300F, 0x300F, LineBreak_CL}, {0x3010, 0x3010, LineBreak_OP}, {0x3011, 0x3011, LineBreak_CL},
+    {0x3012, 0x3013, LineBreak_ID}, {0x3014, 0x3014, LineBreak_OP}, {0x3015, 0x3015, LineBreak_CL},
+    {0x3016, 0x3016, LineBreak_OP}, {0x3017, 0x3017, LineBreak_CL}, {0x3018, 0x3018, LineBreak_OP},
+    {0x3019, 0x3019, LineBreak_CL}, {0x301A, 0x301A, LineBreak_OP}, {0x301B, 0x301B, LineBreak_CL},
+    {0x301C, 0x301C, LineBreak_NS}, {0x301D, 0x301D, LineBreak_OP}, {0x301E, 0x301F, LineBreak_CL},
+    {0x3020, 0x3029, LineBreak_ID}, {0x302A, 0x302F, LineBreak_CM}, {0x3030, 0x303A, LineBreak_ID},
+    {0x303B, 0x303C, LineBreak_NS}, {0x303D, 0x3040, LineBreak_ID}, {0x3041, 0x3041, LineBreak_NS},
+    {0x3042, 0x3042, LineBreak_ID}, {0x3043, 0x3043, LineBreak_NS}, {0x3044, 0x3044, LineBreak_ID},
+    {0x3045, 0x3045, LineBreak_NS}, {0x3046, 0x3046, LineBreak_ID}, {0x3047, 0x3047, LineBreak_NS},
+    {0x3048, 0x3048, LineBreak_ID}, {0x3049, 0x3049, LineBreak_NS}, {0x304A, 0x3062, LineBreak_ID},
+    {0x3063, 0x3063, LineBreak_NS}, {0x3064, 0x3082, LineBreak_ID}, {0x3083, 0x3083, LineBreak_NS},
+    {0x3084, 0x3084, LineBreak_ID}, {0x3085, 0x3085, LineBreak_NS}, {0x3086, 0x3086, LineBreak_ID},
+    {0x3087, 0x3087, LineBreak_NS}, {0x3088, 0x308D, LineBreak_ID}, {0x308E, 0x308E, LineBreak_NS},
+    {0x308F, 0x3094, LineBreak_ID}, {0x3095, 0x3096, LineBreak_NS}, {0x3099, 0x309A, LineBreak_CM},
+    {0x309B, 0x309E, LineBreak_NS}, {0x309F, 0x309F, LineBreak_ID}, {0x30A0, 0x30A0, LineBreak_NS},
+    {0x30A1, 0x30A1, LineBreak_NS}, {0x30A2, 0x30A2, LineBreak_ID}, {0x30A3, 0x30A3, LineBreak_NS},
+    {0x30A4, 0x30A4, LineBreak_ID}, {0x30A5, 0x30A5, LineBreak_NS}, {0x30A6, 0x30A6, LineBreak_ID},
+    {0x30A7, 0x30A7, LineBreak_NS}, {0x30A8, 0x30A8, LineBreak_ID}, {0x30A9, 0x30A9, LineBreak_NS},
+    {0x30AA, 0x30C2, LineBreak_ID}, {0x30C3, 0x30C3, LineBreak_NS}, {0x30C4, 0x30E2, LineBreak_ID},
+    {0x30E3, 0x30E3, LineBreak_NS}, {0x30E4, 0x30E4, LineBreak_ID}, {0x30E5, 0x30E5, LineBreak_NS},
+    {0x30E6, 0x30E6, LineBreak_ID}, {0x30E7, 0x30E7, LineBreak_NS}, {0x30E8, 0x30ED, LineBreak_ID},
+    {0x30EE, 0x30EE, LineBreak_NS}, {0x30EF, 0x30F4, LineBreak_ID}, {0x30F5, 0x30F6, LineBreak_NS},
+    {0x30F7, 0x30FA, LineBreak_ID}, {0x30FB, 0x30FE, LineBreak_NS}, {0x30FF, 0x31EF, LineBreak_ID},
+    {0x31F0, 0x31FF, LineBreak_NS}, {0x3200, 0x4DBF, LineBreak_ID}, {0x4E00, 0xA4CF, LineBreak_ID},
+    {0xAC00, 0xD7A3, LineBreak_ID}, {0xD7B0, 0xD7FF, LineBreak_CM}, {0xF900, 0xFAFF, LineBreak_ID},
+    {0xFB1D, 0xFB1D, LineBreak_HL}, {0xFB1E, 0xFB1E, LineBreak_CM}, {0xFB1F, 0xFB4F, LineBreak_HL},
+    {0xFE00, 0xFE0F, LineBreak_CM}, {0xFE10, 0xFE10, LineBreak_IS}, {0xFE11, 0xFE12, LineBreak_CL},
+    {0xFE13, 0xFE14, LineBreak_IS}, {0xFE15, 0xFE16, LineBreak_EX}, {0xFE17, 0xFE17, LineBreak_OP},
+    {0xFE18, 0xFE18, LineBreak_CL}, {0xFE19, 0xFE19, LineBreak_IN}, {0xFE20, 0xFE2F, LineBreak_CM},
+    {0xFE30, 0xFE4F, LineBreak_ID}, {0xFE50, 0xFE50, LineBreak_CL}, {0xFE51, 0xFE51, LineBreak_ID},
+    {0xFE52, 0xFE52, LineBreak_CL}, {0xFE54, 0xFE55, LineBreak_NS}, {0xFE56, 0xFE57, LineBreak_EX},
+    {0xFE59, 0xFE59, LineBreak_OP}, {0xFE5A, 0xFE5A, LineBreak_CL}, {0xFE5B, 0xFE5B, LineBreak_OP},
+    {0xFE5C, 0xFE5C, LineBreak_CL}, {0xFE5D, 0xFE5D, LineBreak_OP}, {0xFE5E, 0xFE5E, LineBreak_CL},
+    {0xFE69, 0xFE69, LineBreak_PR}, {0xFE6A, 0xFE6A, LineBreak_PO}, {0xFEFF, 0xFEFF, LineBreak_WJ},
+    {0xFF01, 0xFF01, LineBreak_EX}, {0xFF02, 0xFF03, LineBreak_ID}, {0xFF04, 0xFF04, LineBreak_PR},
+    {0xFF05, 0xFF05, LineBreak_PO}, {0xFF06, 0xFF07, LineBreak_ID}, {0xFF08, 0xFF08, LineBreak_OP},
+    {0xFF09, 0xFF09, LineBreak_CL}, {0xFF0A, 0xFF0B, LineBreak_ID}, {0xFF0C, 0xFF0C, LineBreak_CL},
+    {0xFF0D, 0xFF0D, LineBreak_ID}, {0xFF0E, 0xFF0E, LineBreak_CL}, {0xFF0F, 0xFF19, LineBreak_ID},
+    {0xFF1A, 0xFF1B, LineBreak_NS}, {0xFF1C, 0xFF1E, LineBreak_ID}, {0xFF1F, 0xFF1F, LineBreak_EX},
+    {0xFF20, 0xFF3A, LineBreak_ID}, {0xFF3B, 0xFF3B, LineBreak_OP}, {0xFF3C, 0xFF3C, LineBreak_ID},
+    {0xFF3D, 0xFF3D, LineBreak_CL}, {0xFF3E, 0xFF5A, LineBreak_ID}, {0xFF5B, 0xFF5B, LineBreak_OP},
+    {0xFF5C, 0xFF5C, LineBreak_ID}, {0xFF5D, 0xFF5D, LineBreak_CL}, {0xFF5E, 0xFF5E, LineBreak_ID},
+    {0xFF5F, 0xFF5F, LineBreak_OP}, {0xFF60, 0xFF61, LineBreak_CL}, {0xFF62, 0xFF62, LineBreak_OP},
+    {0xFF63, 0xFF64, LineBreak_CL}, {0xFF65, 0xFF65, LineBreak_NS}, {0xFF66, 0xFF66, LineBreak_ID},
+    {0xFF67, 0xFF70, LineBreak_NS}, {0xFF71, 0xFF9D, LineBreak_ID}, {0xFF9E, 0xFF9F, LineBreak_NS},
+    {0xFFE0, 0xFFE0, LineBreak_PO}, {0xFFE1, 0xFFE1, LineBreak_PR}, {0xFFE2, 0xFFE4, LineBreak_ID},
+    {0xFFE5, 0xFFE6, LineBreak_PR},
+    {0x1F000, 0x1F3FA, LineBreak_ID}, {0x1F3FB, 0x1F3FF, LineBreak_CM}, {0x1F400, 0x1FAFF, LineBreak_ID},
+    {0x20000, 0x3FFFD, LineBreak_ID}, {0xE0001, 0xE01EF, LineBreak_CM},
+};
+
+LineBreakClass GetLineBreakClass(uint32_t utf32)
+{
+    if(utf32 < 128)
+        return g_asciiClasses[utf32];
+
+    const LineBreakRange* end = g_lineBreakRanges + sizeof(g_lineBreakRanges) / sizeof(g_lineBreakRanges[0]);
+    const LineBreakRange* it = std::upper_bound(g_lineBreakRanges, end, utf32, [](uint32_t value, const LineBreakRange& range)
+    {
+        return value < range.first;
+    });
+    if(it != g_lineBreakRanges && utf32 <= (it - 1)->last)
+        return (it - 1)->lineClass;
+    return LineBreak_AL;
+}
+
+enum PairAction : uint8_t
+{
+    Pair_Direct = 0,
+    // Breaks only when spaces separate the pair
+    Pair_Indirect,
+    Pair_Prohibited
+};
+
+static bool IsAlphabetic(LineBreakClass lineClass)
+{
+    return (lineClass == LineBreak_AL || lineClass == LineBreak_HL);
+}
+
+// The UAX #14 rules from LB7 on for a pair of classes, the marks and spaces are handled by FindLineBreaks
+static PairAction GetPairAction(LineBreakClass before, LineBreakClass after)
+{
+    // LB7, LB8, LB11
+    if(after == LineBreak_ZW || after == LineBreak_WJ) return Pair_Prohibited;
+    if(before == LineBreak_ZW) return Pair_Direct;
+    if(before == LineBreak_WJ || before == LineBreak_GL) return Pair_Indirect;
+    // LB12a, a no-break space after a hyphen may still break
+    if(after == LineBreak_GL && before != LineBreak_BA && before != LineBreak_HY) return Pair_Indirect;
+    // LB13 to LB17 hold across spaces
+    if(after == LineBreak_CL || after == LineBreak_CP || after == LineBreak_EX || after == LineBreak_IS || after == LineBreak_SY) return Pair_Prohibited;
+    if(before == LineBreak_OP) return Pair_Prohibited;
+    if(before == LineBreak_QU && after == LineBreak_OP) return Pair_Prohibited;
+    if((before == LineBreak_CL || before == LineBreak_CP) && after == LineBreak_NS) return Pair_Prohibited;
+    if(before == LineBreak_B2 && after == LineBreak_B2) return Pair_Prohibited;
+    // LB19 to LB22
+    if(before == LineBreak_QU || after == LineBreak_QU) return Pair_Indirect;
+    if(after == LineBreak_BA || after == LineBreak_HY || after == LineBreak_NS || before == LineBreak_BB) return Pair_Indirect;
+    if(before == LineBreak_SY && after == LineBreak_HL) return Pair_Indirect;
+    if(after == LineBreak_IN) return Pair_Indirect;
+    // LB23 to LB25, numbers stick to their prefixes, suffixes and letters
+    if((IsAlphabetic(before) && after == LineBreak_NU) || (before == LineBreak_NU && IsAlphabetic(after))) return Pair_Indirect;
+    if((before == LineBreak_PR && after == LineBreak_ID) || (before == LineBreak_ID && after == LineBreak_PO)) return Pair_Indirect;
+    if(((before == LineBreak_PR || before == LineBreak_PO) && IsAlphabetic(after)) || (IsAlphabetic(before) && (after == LineBreak_PR || after == LineBreak_PO))) return Pair_Indirect;
+    if((before == LineBreak_CL || before == LineBreak_CP || before == LineBreak_NU) && (after == LineBreak_PO || after == LineBreak_PR)) return Pair_Indirect;
+    if((before == LineBreak_PO || before == LineBreak_PR) && (after == LineBreak_OP || after == LineBreak_NU)) return Pair_Indirect;
+    if((before == LineBreak_HY || before == LineBreak_IS || before == LineBreak_NU || before == LineBreak_SY) && after == LineBreak_NU) return Pair_Indirect;
+    // LB28 to LB30
+    if(IsAlphabetic(before) && IsAlphabetic(after)) return Pair_Indirect;
+    if(before == LineBreak_IS && IsAlphabetic(after)) return Pair_Indirect;
+    if((IsAlphabetic(before) || before == LineBreak_NU) && after == LineBreak_OP) return Pair_Indirect;
+    if(before == LineBreak_CP && (IsAlphabetic(after) || after == LineBreak_NU)) return Pair_Indirect;
+    // LB31, ideographs end up here and break between any two of them
+    return Pair_Direct;
+}
+
+// Evaluated once so breaking a paragraph costs one lookup per character
+struct PairTable
+{
+    uint8_t actions[LineBreak_BK][LineBreak_BK];
+
+    PairTable()
+    {
+        for(int before = 0; before < LineBreak_BK; ++before)
+        {
+            for(int after = 0; after < LineBreak_BK; ++after)
+                actions[before][after] = GetPairAction(static_cast<LineBreakClass>(before), static_cast<LineBreakClass>(after));
+        }
+    }
+};
+static const PairTable g_pairTable;
+
+// Class the pair rules see for a character that starts the text or a line, LB10 turns lone marks into letters
+static LineBreakClass GetStartClass(LineBreakClass lineClass)
+{
+    switch(lineClass)
+    {
+        case LineBreak_CM: case LineBreak_ZWJ: return LineBreak_AL;
+        case LineBreak_LF: case LineBreak_NL: return LineBreak_BK;
+        case LineBreak_SP: return LineBreak_WJ;
+        default: return lineClass;
+    }
+}
+
+void FindLineBreaks(const uint32_t* characters, size_t count, uint8_t* breaks)
+{
+    if(count == 0)
+        return;
+
+    // lastClass skips spaces and marks, previousClass is the class of the character right before
+    LineBreakClass previousClass = GetLineBreakClass(characters[0]);
+    LineBreakClass lastClass = GetStartClass(previousClass);
+    for(size_t i = 1; i < count; ++i)
+    {
+        LineBreakClass lineClass = GetLineBreakClass(characters[i]);
+        uint8_t& opportunity = breaks[i - 1];
+        opportunity = BreakOpportunity_None;
+        if(lastClass == LineBreak_BK || (lastClass == LineBreak_CR && lineClass != LineBreak_LF))
+        {
+            // LB4, LB5
+            opportunity = BreakOpportunity_Mandatory;
+            lastClass = GetStartClass(lineClass);
+        }
+        else if(lineClass == LineBreak_BK || lineClass == LineBreak_LF || lineClass == LineBreak_NL)
+            lastClass = LineBreak_BK;
+        else if(lineClass == LineBreak_CR)
+            lastClass = LineBreak_CR;
+        else if(lineClass == LineBreak_SP)
+        {
+            // LB7, spaces never start a break and are looked through by the rules that hold across them
+        }
+        else if(lineClass == LineBreak_CM || lineClass == LineBreak_ZWJ)
+        {
+            // LB9 keeps marks with their base, after spaces LB10 makes them letters
+            if(previousClass == LineBreak_SP)
+            {
+                if(g_pairTable.actions[lastClass][LineBreak_AL] != Pair_Prohibited)
+                    opportunity = BreakOpportunity_Allowed;
+                lastClass = LineBreak_AL;
+            }
+        }
+        else
+        {
+            uint8_t action = g_pairTable.actions[lastClass][lineClass];
+            // LB8a
+            if(previousClass == LineBreak_ZWJ)
+                action = Pair_Prohibited;
+            if(action == Pair_Direct || (action == Pair_Indirect && previousClass == LineBreak_SP))
+                opportunity = BreakOpportunity_Allowed;
+            lastClass = lineClass;
+        }
+        previousClass = lineClass;
+    }
+    breaks[count - 1] = ((lastClass == LineBreak_BK || lastClass == LineBreak_CR) ? BreakOpportunity_Mandatory : BreakOpportunity_None);
+}
+
+static int GetLineWidth(const TextParagraph& paragraph, size_t lineStart, size_t lineEnd, LineMeasure measureLine, const void* context)
+{
+    if(measureLine)
+        return measureLine(context, paragraph.offsets[lineStart], paragraph.offsets[lineEnd]);
+    return paragraph.advances[lineEnd] - paragraph.advances[lineStart];
+}
+
+static void AddLine(const TextParagraph& paragraph, size_t lineStart, size_t lineEnd, std::vector<TextLine>& lines, LineMeasure measureLine, const void* context)
+{
+    // Spaces hang past the end of a line and the line feed isn't part of it
+    while(lineEnd > lineStart && paragraph.characters[lineEnd - 1] <= 32)
+        --lineEnd;
+    lines.push_back({paragraph.offsets[lineStart], paragraph.offsets[lineEnd] - paragraph.offsets[lineStart], GetLineWidth(paragraph, lineStart, lineEnd, measureLine, context)});
+}
+
+void BreakParagraph(TextParagraph& paragraph, int maxWidth, std::vector<TextLine>& lines, LineMeasure measureLine, const void* context)
+{
+    lines.clear();
+    size_t count = paragraph.characters.size();
+    paragraph.breaks.resize(count);
+    FindLineBreaks(paragraph.characters.data(), count, paragraph.breaks.data());
+
+    // Without measureLine line widths are differences of the prefix sums, so every character is looked at once however long the paragraph is
+    size_t lineStart = 0, lastBreak = 0;
+    for(size_t i = 0; i < count; ++i)
+    {
+        // Measured lines are only looked at where words end, a word cut short may draw wider than the whole of it
+        bool wordEnd = (!measureLine || i + 1 == count || paragraph.breaks[i] != BreakOpportunity_None || paragraph.characters[i + 1] <= 32);
+        if(paragraph.characters[i] > 32 && wordEnd)
+        {
+            while(i > lineStart && GetLineWidth(paragraph, lineStart, i + 1, measureLine, context) > maxWidth)
+            {
+                size_t lineEnd = lastBreak;
+                if(lineEnd <= lineStart)
+                {
+                    // The word doesn't fit on a line of its own and breaks after the last character that still fits
+                    lineEnd = i;
+                    while(lineEnd > lineStart + 1 && GetLineWidth(paragraph, lineStart, lineEnd, measureLine, context) > maxWidth)
+                        --lineEnd;
+                }
+                AddLine(paragraph, lineStart, lineEnd, lines, measureLine, context);
+                lineStart = lineEnd;
+            }
+        }
+
+        if(paragraph.breaks[i] == BreakOpportunity_Mandatory)
+        {
+            AddLine(paragraph, lineStart, i + 1, lines, measureLine, context);
+            lineStart = i + 1;
+        }
+        else if(paragraph.breaks[i] == BreakOpportunity_Allowed)
+            lastBreak = i + 1;
+    }
+    AddLine(paragraph, lineStart, count, lines, measureLine, context);
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// UAX #14 line breaking, classes the pair rules don't tell apart are folded into the ones they resolve to
+// (SA, AI, XX and CB into AL, CJ into NS, Hangul syllables and emoji into ID, conjoining jamo vowels and modifiers into CM)
+enum LineBreakClass : uint8_t
+{
+    LineBreak_OP = 0,
+    LineBreak_CL,
+    LineBreak_CP,
+    LineBreak_QU,
+    LineBreak_GL,
+    LineBreak_NS,
+    LineBreak_EX,
+    LineBreak_SY,
+    LineBreak_IS,
+    LineBreak_PR,
+    LineBreak_PO,
+    LineBreak_NU,
+    LineBreak_AL,
+    LineBreak_HL,
+    LineBreak_ID,
+    LineBreak_IN,
+    LineBreak_HY,
+    LineBreak_BA,
+    LineBreak_BB,
+    LineBreak_B2,
+    LineBreak_ZW,
+    LineBreak_CM,
+    LineBreak_WJ,
+    LineBreak_ZWJ,
+    // Never looked up in the pair table
+    LineBreak_BK,
+    LineBreak_CR,
+    LineBreak_LF,
+    LineBreak_NL,
+    LineBreak_SP,
+    LineBreak_ClassCount
+};
+
+enum LineBreakOpportunity : uint8_t
+{
+    BreakOpportunity_None = 0,
+    BreakOpportunity_Allowed,
+    BreakOpportunity_Mandatory
+};
+
+LineBreakClass GetLineBreakClass(uint32_t utf32);
+// breaks[i] tells whether a line may or has to end after characters[i], the end of the text itself isn't marked
+void FindLineBreaks(const uint32_t* characters, size_t count, uint8_t* breaks);
+
+// Byte range and width in pixels of one wrapped line, the spaces and line feed a line was broken at belong to neither line
+struct TextLine
+{
+    int start;
+    int length;
+    int width;
+};
+
+// One paragraph decoded for wrapping, kept between calls so wrapping doesn't allocate once the buffers grew
+struct TextParagraph
+{
+    std::vector<uint32_t> characters;
+    // Byte offset of every character followed by the text length
+    std::vector<int> offsets;
+    // Prefix sums, advances[i] is the width of the characters before characters[i]
+    std::vector<int> advances;
+    std::vector<uint8_t> breaks;
+
+    void Clear()
+    {
+        characters.clear();
+        offsets.clear();
+        advances.clear();
+    }
+};
+
+// Width in pixels of the bytes from start to end of the text the paragraph was decoded from
+typedef int (*LineMeasure)(const void* context, int start, int end);
+
+// Greedy wrap to maxWidth pixels at the break opportunities of the paragraph in one pass
+// Words wider than a line break between characters, and a line always keeps its first character
+// Lines are measured by their prefix sums, or by measureLine when text draws wider or narrower than its characters add up to
+void BreakParagraph(TextParagraph& paragraph, int maxWidth, std::vector<TextLine>& lines, LineMeasure measureLine = nullptr, const void* context = nullptr);
@@ -0,0 +1,37 @@
+#include "log.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+
+bool g_useLog = false;
+static FILE* g_logFile = nullptr;
+
+void LogOpen(const char* path)
+{
+    if(!g_useLog || g_logFile)
+        return;
+
+    g_logFile = fopen(path, "w");
+}
+
+void LogClose()
+{
+    if(g_logFile)
+    {
+        fclose(g_logFile);
+        g_logFile = nullptr;
+    }
+}
+
+void LogMessage(const char* format, ...)
+{
+    if(!g_logFile)
+        return;
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(g_logFile, format, args);
+    va_end(args);
+    fputc('\n', g_logFile);
+    fflush(g_logFile);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+extern bool g_useLog;
+
+void LogOpen(const char* path);
+void LogClose();
+void LogMessage(const char* format, ...);
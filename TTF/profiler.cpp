@@ -0,0 +1,145 @@
+#include "profiler.h"
+
+#ifdef TTF_PROFILE
+#include "textstats.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#ifdef _MSC_VER
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#define PROFILE_RING_SIZE 16384
+
+struct ProfileEvent
+{
+    const char* name;
+    int64_t start;
+    int64_t duration;
+    char detail[PROFILE_DETAIL_SIZE];
+};
+
+// Only the owning thread writes, the dump reads whatever has been published through count
+struct ProfileRing
+{
+    std::atomic<uint32_t> count;
+    uint32_t threadId;
+    ProfileRing* next;
+    ProfileEvent events[PROFILE_RING_SIZE];
+};
+
+static std::atomic<ProfileRing*> g_profileRings(nullptr);
+static thread_local ProfileRing* t_profileRing = nullptr;
+
+static ProfileRing* GetProfileRing()
+{
+    if(!t_profileRing)
+    {
+        // Rings are never freed so a dump can still read events of threads that already exited
+        ProfileRing* ring = new ProfileRing;
+        ring->count.store(0, std::memory_order_relaxed);
+        ring->threadId = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        ring->next = g_profileRings.load(std::memory_order_relaxed);
+        while(!g_profileRings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed));
+        t_profileRing = ring;
+    }
+    return t_profileRing;
+}
+
+ProfileScope::ProfileScope(const char* name, const char* detail) : m_name(name)
+{
+    m_detail[0] = '\0';
+    if(detail)
+    {
+        // Paths are more telling by their end
+        size_t len = strlen(detail);
+        strncpy(m_detail, (len >= sizeof(m_detail) ? detail + len - (sizeof(m_detail) - 1) : detail), sizeof(m_detail) - 1);
+        m_detail[sizeof(m_detail) - 1] = '\0';
+    }
+    m_start = TextStatsTimestamp();
+}
+
+ProfileScope::~ProfileScope()
+{
+    int64_t end = TextStatsTimestamp();
+    ProfileRing* ring = GetProfileRing();
+    uint32_t index = ring->count.load(std::memory_order_relaxed);
+
+    ProfileEvent& event = ring->events[index % PROFILE_RING_SIZE];
+    event.name = m_name;
+    event.start = m_start;
+    event.duration = end - m_start;
+    memcpy(event.detail, m_detail, sizeof(m_detail));
+    ring->count.store(index + 1, std::memory_order_release);
+}
+
+static void WriteJsonString(FILE* f, const char* str)
+{
+    fputc('"', f);
+    for(; *str; ++str)
+    {
+        unsigned char c = static_cast<unsigned char>(*str);
+        if(c == '"' || c == '\\')
+            fprintf(f, "\\%c", c);
+        else if(c < 0x20)
+            fprintf(f, "\\u%04X", c);
+        else
+            fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+bool ProfileDump(const char* path)
+{
+    FILE* f = fopen(path, "w");
+    if(!f)
+        return false;
+
+    // Timestamps start at the oldest event still in any ring
+    int64_t base = INT64_MAX;
+    for(ProfileRing* ring = g_profileRings.load(std::memory_order_acquire); ring; ring = ring->next)
+    {
+        uint32_t count = ring->count.load(std::memory_order_acquire);
+        uint32_t first = (count > PROFILE_RING_SIZE ? count - PROFILE_RING_SIZE : 0);
+        for(uint32_t i = first; i < count; ++i)
+        {
+            if(ring->events[i % PROFILE_RING_SIZE].start < base)
+                base = ring->events[i % PROFILE_RING_SIZE].start;
+        }
+    }
+
+    fprintf(f, "{\"traceEvents\":[");
+    bool firstEvent = true;
+    for(ProfileRing* ring = g_profileRings.load(std::memory_order_acquire); ring; ring = ring->next)
+    {
+        uint32_t count = ring->count.load(std::memory_order_acquire);
+        uint32_t first = (count > PROFILE_RING_SIZE ? count - PROFILE_RING_SIZE : 0);
+        for(uint32_t i = first; i < count; ++i)
+        {
+            const ProfileEvent& event = ring->events[i % PROFILE_RING_SIZE];
+            fprintf(f, "%s\n{\"name\":", (firstEvent ? "" : ","));
+            WriteJsonString(f, event.name);
+            fprintf(f, ",\"cat\":\"ttf\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u", TextStatsTicksToMs(event.start - base) * 1000.0,
+                TextStatsTicksToMs(event.duration) * 1000.0, static_cast<unsigned int>(getpid()), static_cast<unsigned int>(ring->threadId));
+            if(event.detail[0])
+            {
+                fprintf(f, ",\"args\":{\"detail\":");
+                WriteJsonString(f, event.detail);
+                fputc('}', f);
+            }
+            fputc('}', f);
+            firstEvent = false;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    return true;
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+// Scoped timeline events that get dumped as Chrome trace-event JSON for chrome://tracing or Perfetto
+// Every event lands in a lock-free ring owned by the thread that recorded it, the oldest events get overwritten
+// Everything compiles to nothing unless TTF_PROFILE is defined
+#ifdef TTF_PROFILE
+#define PROFILE_DETAIL_SIZE 48
+
+class ProfileScope
+{
+    public:
+        explicit ProfileScope(const char* name, const char* detail = nullptr);
+        ~ProfileScope();
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name;
+        char m_detail[PROFILE_DETAIL_SIZE];
+        int64_t m_start;
+};
+
+bool ProfileDump(const char* path);
+
+#define TTF_PROFILE_CONCAT2(a, b) a##b
+#define TTF_PROFILE_CONCAT(a, b) TTF_PROFILE_CONCAT2(a, b)
+#define TTF_PROFILE_SCOPE(name) ProfileScope TTF_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define TTF_PROFILE_SCOPE_DETAIL(name, detail) ProfileScope TTF_PROFILE_CONCAT(profileScope, __LINE__)(name, detail)
+#define TTF_PROFILE_DUMP(path) ProfileDump(path)
+#else
+#define TTF_PROFILE_SCOPE(name) ((void)0)
+#define TTF_PROFILE_SCOPE_DETAIL(name, detail) ((void)0)
+#define TTF_PROFILE_DUMP(path) ((void)0)
+#endif
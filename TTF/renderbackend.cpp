@@ -0,0 +1,141 @@
+#include "renderbackend.h"
+
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+
+HeadlessRenderBackend::~HeadlessRenderBackend()
+{
+    for(Page* page : m_pages)
+        delete page;
+}
+
+GlyphPage HeadlessRenderBackend::CreatePage(unsigned int width, unsigned int height, GlyphTextureFormat format)
+{
+    Page* page = new Page;
+    page->width = width;
+    page->height = height;
+    page->format = format;
+    page->texels.resize(static_cast<size_t>(width) * height * GetGlyphTexelSize(format));
+    m_pages.insert(page);
+
+    ++m_stats.pagesCreated;
+    ++m_stats.livePages;
+    m_stats.pageBytes += page->texels.size();
+    return page;
+}
+
+bool HeadlessRenderBackend::LockPage(GlyphPage page, const AtlasRect* rect, bool, GlyphPageLock& lock)
+{
+    Page* headlessPage = static_cast<Page*>(page);
+    unsigned int texelSize = GetGlyphTexelSize(headlessPage->format);
+    lock.pitch = static_cast<int>(headlessPage->width * texelSize);
+    if(rect)
+    {
+        lock.texels = headlessPage->texels.data() + rect->y * lock.pitch + rect->x * texelSize;
+        lock.width = rect->width;
+        lock.rows = rect->height;
+    }
+    else
+    {
+        lock.texels = headlessPage->texels.data();
+        lock.width = headlessPage->width;
+        lock.rows = headlessPage->height;
+    }
+    ++m_stats.locks;
+    return true;
+}
+
+void HeadlessRenderBackend::ReleasePage(GlyphPage page)
+{
+    Page* headlessPage = static_cast<Page*>(page);
+    if(m_pages.erase(headlessPage) == 0)
+        return;
+
+    ++m_stats.pagesReleased;
+    --m_stats.livePages;
+    m_stats.pageBytes -= headlessPage->texels.size();
+    delete headlessPage;
+}
+
+void HeadlessRenderBackend::DrawQuads(GlyphPage, const TextVertex*, size_t quads)
+{
+    ++m_stats.drawCalls;
+    m_stats.quads += quads;
+}
+
+void SoftwareRenderBackend::SetTarget(unsigned int width, unsigned int height)
+{
+    m_width = width;
+    m_height = height;
+    m_target.assign(static_cast<size_t>(width) * height, 0xFF000000);
+}
+
+void SoftwareRenderBackend::DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads)
+{
+    HeadlessRenderBackend::DrawQuads(page, vertices, quads);
+
+    const Page* softwarePage = static_cast<const Page*>(page);
+    unsigned int texelSize = GetGlyphTexelSize(softwarePage->format);
+    for(size_t quad = 0; quad < quads; ++quad)
+    {
+        // The first vertex holds the minimum corner and the third the maximum one
+        const TextVertex& minCorner = vertices[quad * 4];
+        const TextVertex& maxCorner = vertices[quad * 4 + 2];
+        float width = maxCorner.sx - minCorner.sx;
+        float height = maxCorner.sy - minCorner.sy;
+        if(width <= 0.f || height <= 0.f)
+            continue;
+
+        // Pixel centers sit on integer coordinates like they do for D3D7
+        int x0 = std::max(static_cast<int>(std::ceil(minCorner.sx)), 0);
+        int y0 = std::max(static_cast<int>(std::ceil(minCorner.sy)), 0);
+        int x1 = std::min(static_cast<int>(std::ceil(maxCorner.sx)), static_cast<int>(m_width));
+        int y1 = std::min(static_cast<int>(std::ceil(maxCorner.sy)), static_cast<int>(m_height));
+
+        uint32_t color = minCorner.color;
+        uint32_t colorA = color >> 24;
+        uint32_t colorR = (color >> 16) & 0xFF;
+        uint32_t colorG = (color >> 8) & 0xFF;
+        uint32_t colorB = color & 0xFF;
+        for(int y = y0; y < y1; ++y)
+        {
+            float v = minCorner.tv + (y - minCorner.sy) / height * (maxCorner.tv - minCorner.tv);
+            unsigned int texelY = std::min(static_cast<unsigned int>(std::max(v, 0.f) * softwarePage->height), softwarePage->height - 1);
+            for(int x = x0; x < x1; ++x)
+            {
+                float u = minCorner.tu + (x - minCorner.sx) / width * (maxCorner.tu - minCorner.tu);
+                unsigned int texelX = std::min(static_cast<unsigned int>(std::max(u, 0.f) * softwarePage->width), softwarePage->width - 1);
+                const unsigned char* texel = softwarePage->texels.data() + (static_cast<size_t>(texelY) * softwarePage->width + texelX) * texelSize;
+
+                uint32_t texelR, texelG, texelB, texelA;
+                if(softwarePage->format == GlyphFormat_BGRA8888)
+                {
+                    texelB = texel[0];
+                    texelG = texel[1];
+                    texelR = texel[2];
+                    texelA = texel[3];
+                }
+                else
+                {
+                    texelR = texelG = texelB = texel[0];
+                    texelA = texel[1];
+                }
+
+                // Modulate with the vertex color, then blend with source alpha over the image
+                uint32_t alpha = texelA * colorA / 255;
+                if(alpha == 0)
+                    continue;
+
+                uint32_t& dst = m_target[static_cast<size_t>(y) * m_width + x];
+                uint32_t dstR = (dst >> 16) & 0xFF;
+                uint32_t dstG = (dst >> 8) & 0xFF;
+                uint32_t dstB = dst & 0xFF;
+                dstR = (texelR * colorR / 255 * alpha + dstR * (255 - alpha)) / 255;
+                dstG = (texelG * colorG / 255 * alpha + dstG * (255 - alpha)) / 255;
+                dstB = (texelB * colorB / 255 * alpha + dstB * (255 - alpha)) / 255;
+                dst = 0xFF000000 | (dstR << 16) | (dstG << 8) | dstB;
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_set>
+#include <vector>
+
+#include "glyphatlas.h"
+#include "glyphconvert.h"
+#include "textcore.h"
+
+// A texture holding one glyph or a whole atlas page, what it really is depends on the backend
+typedef void* GlyphPage;
+
+struct GlyphPageLock
+{
+    unsigned char* texels;
+    int pitch;
+    unsigned int width;
+    unsigned int rows;
+};
+
+// Everything the glyph cache and the draw loop need from a renderer
+class GlyphRenderBackend
+{
+    public:
+        virtual ~GlyphRenderBackend() = default;
+
+        // False while there is no device to create pages on
+        virtual bool IsReady() const {return true;}
+
+        // Pages start out with undefined texels, rect limits a lock to part of the page and nullptr locks all of it
+        virtual GlyphPage CreatePage(unsigned int width, unsigned int height, GlyphTextureFormat format) = 0;
+        virtual bool LockPage(GlyphPage page, const AtlasRect* rect, bool readOnly, GlyphPageLock& lock) = 0;
+        virtual void UnlockPage(GlyphPage page, const AtlasRect* rect) = 0;
+        virtual void ReleasePage(GlyphPage page) = 0;
+
+        // Pages in video memory can get lost, restoring one brings the page back but not its texels
+        virtual bool IsPageLost(GlyphPage) {return false;}
+        virtual void RestorePage(GlyphPage) {}
+
+        // Text render state is set up once around every string and shared by all quads drawn in between
+        // Quads are 4 vertices each in the order BuildGlyphVertices writes them
+        virtual void BeginText() = 0;
+        virtual void DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads) = 0;
+        virtual void EndText() = 0;
+};
+
+struct RenderBackendStats
+{
+    size_t pagesCreated = 0;
+    size_t pagesReleased = 0;
+    size_t livePages = 0;
+    size_t pageBytes = 0;
+    size_t locks = 0;
+    size_t textRuns = 0;
+    size_t drawCalls = 0;
+    size_t quads = 0;
+};
+
+// Keeps pages in system memory and only counts what gets drawn, for benchmarks and tools that run without a game
+class HeadlessRenderBackend : public GlyphRenderBackend
+{
+    public:
+        HeadlessRenderBackend() = default;
+        ~HeadlessRenderBackend() override;
+
+        HeadlessRenderBackend(const HeadlessRenderBackend&) = delete;
+        HeadlessRenderBackend& operator=(const HeadlessRenderBackend&) = delete;
+
+        GlyphPage CreatePage(unsigned int width, unsigned int height, GlyphTextureFormat format) override;
+        bool LockPage(GlyphPage page, const AtlasRect* rect, bool readOnly, GlyphPageLock& lock) override;
+        void UnlockPage(GlyphPage, const AtlasRect*) override {}
+        void ReleasePage(GlyphPage page) override;
+
+        void BeginText() override {++m_stats.textRuns;}
+        void DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads) override;
+        void EndText() override {}
+
+        const RenderBackendStats& GetStats() const {return m_stats;}
+
+    protected:
+        struct Page
+        {
+            unsigned int width;
+            unsigned int height;
+            GlyphTextureFormat format;
+            std::vector<unsigned char> texels;
+        };
+
+        std::unordered_set<Page*> m_pages;
+        RenderBackendStats m_stats;
+};
+
+// Composites every quad into a BGRA8888 image the way the D3D7 text state does,
+// texels are point sampled, modulated by the vertex color and alpha blended over the image
+class SoftwareRenderBackend : public HeadlessRenderBackend
+{
+    public:
+        SoftwareRenderBackend() = default;
+
+        // Clears the image to opaque black
+        void SetTarget(unsigned int width, unsigned int height);
+        unsigned int GetTargetWidth() const {return m_width;}
+        unsigned int GetTargetHeight() const {return m_height;}
+        const std::vector<uint32_t>& GetTarget() const {return m_target;}
+
+        void DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads) override;
+
+    private:
+        std::vector<uint32_t> m_target;
+        unsigned int m_width = 0;
+        unsigned int m_height = 0;
+};
@@ -0,0 +1,118 @@
+#include "shaping.h"
+#include "bidi.h"
+
+#include <algorithm>
+
+struct ArabicForms
+{
+    uint16_t letter;
+    uint16_t isolated;
+    uint16_t final;
+    uint16_t initial;
+    uint16_t medial;
+};
+
+#include "arabicforms.h"
+
+enum JoiningType : uint8_t
+{
+    Joining_None = 0,
+    Joining_Right,
+    Joining_Dual,
+    Joining_Causing,
+    Joining_Transparent
+};
+
+static JoiningType GetJoiningType(uint32_t utf32, const ArabicForms*& forms)
+{
+    forms = nullptr;
+    if(utf32 >= g_arabicForms[0].letter && utf32 <= 0x06FF)
+    {
+        const ArabicForms* end = g_arabicForms + sizeof(g_arabicForms) / sizeof(g_arabicForms[0]);
+        const ArabicForms* it = std::lower_bound(g_arabicForms, end, utf32, [](const ArabicForms& letterForms, uint32_t value)
+        {
+            return letterForms.letter < value;
+        });
+        if(it != end && it->letter == utf32)
+        {
+            forms = it;
+            return (it->initial ? Joining_Dual : (it->final ? Joining_Right : Joining_None));
+        }
+    }
+    // Tatweel and the zero width joiner join with both sides without changing shape themselves
+    if(utf32 == 0x0640 || utf32 == 0x200D)
+        return Joining_Causing;
+    if(GetBidiClass(utf32) == Bidi_NSM)
+        return Joining_Transparent;
+    return Joining_None;
+}
+
+// Isolated lam-alef ligature, the final form follows it
+static uint32_t GetLamAlefLigature(uint32_t alef)
+{
+    switch(alef)
+    {
+        case 0x0622: return 0xFEF5;
+        case 0x0623: return 0xFEF7;
+        case 0x0625: return 0xFEF9;
+        case 0x0627: return 0xFEFB;
+        default: return 0;
+    }
+}
+
+void ShapeArabic(const uint32_t* characters, size_t count, std::vector<uint32_t>& shaped)
+{
+    shaped.clear();
+    // Joining type of the last letter that wasn't a mark
+    JoiningType previous = Joining_None;
+    for(size_t i = 0; i < count; ++i)
+    {
+        const ArabicForms* forms;
+        JoiningType type = GetJoiningType(characters[i], forms);
+        if(type == Joining_Transparent)
+        {
+            shaped.push_back(characters[i]);
+            continue;
+        }
+
+        size_t next = i + 1;
+        JoiningType nextType = Joining_None;
+        for(; next < count; ++next)
+        {
+            const ArabicForms* nextForms;
+            nextType = GetJoiningType(characters[next], nextForms);
+            if(nextType != Joining_Transparent)
+                break;
+        }
+        if(next == count)
+            nextType = Joining_None;
+
+        bool joinsPrevious = ((previous == Joining_Dual || previous == Joining_Causing) && type != Joining_None);
+        bool joinsNext = ((type == Joining_Dual || type == Joining_Causing) && nextType != Joining_None);
+        uint32_t ligature = ((characters[i] == 0x0644 && joinsNext) ? GetLamAlefLigature(characters[next]) : 0);
+        if(ligature)
+        {
+            // Marks between lam and alef stay behind the ligature
+            shaped.push_back(joinsPrevious ? ligature + 1 : ligature);
+            shaped.insert(shaped.end(), characters + i + 1, characters + next);
+            previous = Joining_Right;
+            i = next;
+            continue;
+        }
+
+        uint32_t form = 0;
+        if(forms)
+        {
+            if(joinsPrevious && joinsNext)
+                form = forms->medial;
+            else if(joinsPrevious)
+                form = forms->final;
+            else if(joinsNext)
+                form = forms->initial;
+            if(!form)
+                form = forms->isolated;
+        }
+        shaped.push_back(form ? form : characters[i]);
+        previous = type;
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Replaces the Arabic letters of a line in logical order with the presentation form the neighbouring letters join them into
+// and lam followed by alef with their ligature, everything else is copied. Marks don't break a join, letters without
+// presentation forms don't join. shaped ends up shorter than characters for every ligature.
+void ShapeArabic(const uint32_t* characters, size_t count, std::vector<uint32_t>& shaped);
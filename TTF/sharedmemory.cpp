@@ -0,0 +1,136 @@
+#include "sharedmemory.h"
+
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+bool SharedMemory::Create(const char* name, size_t size)
+{
+    Close();
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), name);
+    if(!mapping)
+        return false;
+
+    if(GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if(!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_data = view;
+    m_size = size;
+    return true;
+}
+
+bool SharedMemory::Open(const char* name, size_t size)
+{
+    Close();
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+    if(!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    if(!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_data = view;
+    m_size = size;
+    return true;
+}
+
+void SharedMemory::Close()
+{
+    if(m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if(m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    m_size = 0;
+}
+#else
+static std::string GetSegmentName(const char* name)
+{
+    const char* separator = strrchr(name, '\\');
+    return std::string("/") + (separator ? separator + 1 : name);
+}
+
+bool SharedMemory::Create(const char* name, size_t size)
+{
+    Close();
+    std::string segmentName = GetSegmentName(name);
+    int fd = shm_open(segmentName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd < 0)
+        return false;
+
+    void* view = (ftruncate(fd, static_cast<off_t>(size)) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED);
+    close(fd);
+    if(view == MAP_FAILED)
+    {
+        shm_unlink(segmentName.c_str());
+        return false;
+    }
+
+    m_data = view;
+    m_size = size;
+    m_createdName = segmentName;
+    return true;
+}
+
+bool SharedMemory::Open(const char* name, size_t size)
+{
+    Close();
+    int fd = shm_open(GetSegmentName(name).c_str(), O_RDONLY, 0);
+    if(fd < 0)
+        return false;
+
+    // The creator may not have sized the segment yet
+    struct stat info;
+    void* view = (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= size ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED);
+    close(fd);
+    if(view == MAP_FAILED)
+        return false;
+
+    m_data = view;
+    m_size = size;
+    return true;
+}
+
+void SharedMemory::Close()
+{
+    if(m_data)
+    {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    if(!m_createdName.empty())
+    {
+        shm_unlink(m_createdName.c_str());
+        m_createdName.clear();
+    }
+    m_size = 0;
+}
+#endif
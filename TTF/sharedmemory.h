@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+
+// Named shared memory segment, a file mapping backed by the paging file on Windows and shm_open elsewhere
+// Names use the Windows form, POSIX drops a "Local\" or "Global\" prefix and names the segment "/<rest>"
+class SharedMemory
+{
+    public:
+        SharedMemory() = default;
+        ~SharedMemory() {Close();}
+
+        SharedMemory(const SharedMemory&) = delete;
+        SharedMemory& operator=(const SharedMemory&) = delete;
+
+        // Creates a zeroed segment, fails when one of that name exists already
+        bool Create(const char* name, size_t size);
+        // Maps an existing segment read only, fails when it's smaller than size
+        bool Open(const char* name, size_t size);
+        void Close();
+
+        void* GetData() const {return m_data;}
+
+    private:
+        void* m_data = nullptr;
+        size_t m_size = 0;
+        void* m_mapping = nullptr;
+        // POSIX segments outlive their processes, the creator removes the name again on Close
+        std::string m_createdName;
+};
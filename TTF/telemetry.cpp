@@ -0,0 +1,170 @@
+#include "telemetry.h"
+#include "textstats.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// Reads racing the writer more often than this give up instead of spinning
+#define TELEMETRY_READ_ATTEMPTS 1000
+// Without PollTelemetry's seconds the reader stops once the frame counter stood still this long
+#define TELEMETRY_IDLE_MS 30000
+
+static float GetPercentile(const float* sorted, uint32_t count, uint32_t percent)
+{
+    return sorted[(count - 1) * percent / 100];
+}
+
+bool TelemetryWriter::Open(const char* name)
+{
+    Close();
+    // A second game publishing into the same block would break the sequence lock
+    if(!m_memory.Create(name, sizeof(TelemetryBlock)))
+        return false;
+
+    m_block = static_cast<TelemetryBlock*>(m_memory.GetData());
+    m_block->version = TTF_TELEMETRY_VERSION;
+    m_block->size = sizeof(TelemetryBlock);
+    // Readers only accept the block once the magic shows up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_block->magic = TTF_TELEMETRY_MAGIC;
+    return true;
+}
+
+void TelemetryWriter::Close()
+{
+    m_memory.Close();
+    m_block = nullptr;
+}
+
+void TelemetryWriter::Publish(TelemetryStats& stats, double frameRasterMs)
+{
+    if(!m_block)
+        return;
+
+    m_rasterWindow[m_rasterFrames++ % TTF_TELEMETRY_WINDOW] = static_cast<float>(frameRasterMs);
+    uint32_t count = std::min<uint32_t>(m_rasterFrames, TTF_TELEMETRY_WINDOW);
+    float sorted[TTF_TELEMETRY_WINDOW];
+    std::copy(m_rasterWindow, m_rasterWindow + count, sorted);
+    std::sort(sorted, sorted + count);
+    stats.rasterMs = static_cast<float>(frameRasterMs);
+    stats.rasterP50Ms = GetPercentile(sorted, count, 50);
+    stats.rasterP95Ms = GetPercentile(sorted, count, 95);
+    stats.rasterP99Ms = GetPercentile(sorted, count, 99);
+
+    // The miss rate is refreshed once a second so it doesn't jump around with every frame
+    m_totalMisses += stats.cacheMisses;
+    int64_t now = TextStatsTimestamp();
+    if(m_rateStart == 0)
+    {
+        m_rateStart = now;
+        m_rateMisses = m_totalMisses;
+    }
+    double rateMs = TextStatsTicksToMs(now - m_rateStart);
+    if(rateMs >= 1000.0)
+    {
+        m_missesPerSecond = static_cast<float>((m_totalMisses - m_rateMisses) * 1000.0 / rateMs);
+        m_rateStart = now;
+        m_rateMisses = m_totalMisses;
+    }
+    stats.totalCacheMisses = m_totalMisses;
+    stats.missesPerSecond = m_missesPerSecond;
+
+    // Odd while the stats are being copied, the fences keep the copy between the two increments
+    m_block->sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_block->stats = stats;
+    m_block->sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool TelemetryReader::Open(const char* name)
+{
+    Close();
+    if(!m_memory.Open(name, sizeof(TelemetryBlock)))
+        return false;
+
+    m_block = static_cast<const TelemetryBlock*>(m_memory.GetData());
+    if(m_block->magic != TTF_TELEMETRY_MAGIC || m_block->version != TTF_TELEMETRY_VERSION || m_block->size != sizeof(TelemetryBlock))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void TelemetryReader::Close()
+{
+    m_memory.Close();
+    m_block = nullptr;
+}
+
+bool TelemetryReader::Read(TelemetryStats& stats) const
+{
+    if(!m_block)
+        return false;
+
+    for(int attempt = 0; attempt < TELEMETRY_READ_ATTEMPTS; ++attempt)
+    {
+        uint32_t sequence = m_block->sequence.load(std::memory_order_acquire);
+        if(sequence & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        stats = m_block->stats;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(m_block->sequence.load(std::memory_order_relaxed) == sequence)
+            return true;
+    }
+    return false;
+}
+
+bool PollTelemetry(const char* name, const char* reportPath, int intervalMs, int seconds)
+{
+    TelemetryReader reader;
+    if(!reader.Open(name))
+        return false;
+
+    FILE* f = fopen(reportPath, "w");
+    if(!f)
+        return false;
+
+    fprintf(f, "elapsed_ms,frame,fonts,cached_glyphs,atlas_pages,draw_calls,glyphs_drawn,measure_calls,cache_misses,total_cache_misses,misses_per_s,"
+        "raster_ms,raster_p50_ms,raster_p95_ms,raster_p99_ms,texture_surfaces,texture_kb,texture_peak_kb,freetype_kb\n");
+
+    int64_t start = TextStatsTimestamp();
+    double idleSince = 0.0;
+    uint32_t lastFrame = 0;
+    for(;;)
+    {
+        double elapsedMs = TextStatsTicksToMs(TextStatsTimestamp() - start);
+        if(seconds > 0 && elapsedMs >= seconds * 1000.0)
+            break;
+
+        TelemetryStats stats;
+        if(reader.Read(stats))
+        {
+            fprintf(f, "%.0f,%u,%u,%u,%u,%u,%u,%u,%u,%llu,%.2f,%.3f,%.3f,%.3f,%.3f,%u,%llu,%llu,%llu\n", elapsedMs, stats.frame, stats.fonts,
+                stats.cachedGlyphs, stats.atlasPages, stats.drawCalls, stats.glyphsDrawn, stats.measureCalls, stats.cacheMisses,
+                static_cast<unsigned long long>(stats.totalCacheMisses), stats.missesPerSecond, stats.rasterMs, stats.rasterP50Ms, stats.rasterP95Ms,
+                stats.rasterP99Ms, stats.textureSurfaces, static_cast<unsigned long long>(stats.textureBytes / 1024),
+                static_cast<unsigned long long>(stats.texturePeakBytes / 1024), static_cast<unsigned long long>(stats.freeTypeBytes / 1024));
+            // Rows show up right away so the report can be followed while the game runs
+            fflush(f);
+
+            if(stats.frame != lastFrame)
+            {
+                lastFrame = stats.frame;
+                idleSince = elapsedMs;
+            }
+        }
+        if(seconds <= 0 && elapsedMs - idleSince >= TELEMETRY_IDLE_MS)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "sharedmemory.h"
+
+// Text pipeline metrics published in a named shared memory segment for tools watching long sessions
+// The block is versioned and guarded by a sequence lock, the writer makes the sequence odd while it copies
+// and a reader retries until it sees the same even sequence before and after reading the stats
+// Outside Windows the segment is the POSIX shared memory object "/GothicTTF_Telemetry"
+#define TTF_TELEMETRY_NAME "Local\\GothicTTF_Telemetry"
+#define TTF_TELEMETRY_MAGIC 0x54465454
+#define TTF_TELEMETRY_VERSION 1
+
+// Frames kept for the rasterization time percentiles
+#define TTF_TELEMETRY_WINDOW 256
+
+struct TelemetryStats
+{
+    uint32_t frame;
+    uint32_t fonts;
+    uint32_t cachedGlyphs;
+    uint32_t atlasPages;
+    uint32_t drawCalls;
+    uint32_t glyphsDrawn;
+    uint32_t measureCalls;
+    uint32_t cacheMisses;
+    uint64_t totalCacheMisses;
+    uint64_t textureBytes;
+    uint64_t texturePeakBytes;
+    uint64_t freeTypeBytes;
+    uint32_t textureSurfaces;
+    float missesPerSecond;
+    float rasterMs;
+    float rasterP50Ms;
+    float rasterP95Ms;
+    float rasterP99Ms;
+};
+
+struct TelemetryBlock
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    std::atomic<uint32_t> sequence;
+    TelemetryStats stats;
+};
+
+class TelemetryWriter
+{
+    public:
+        TelemetryWriter() = default;
+        ~TelemetryWriter() {Close();}
+
+        TelemetryWriter(const TelemetryWriter&) = delete;
+        TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+        bool Open(const char* name);
+        void Close();
+        bool IsOpen() const {return m_block != nullptr;}
+
+        // Fills in the derived stats from the frame's raster time and publishes everything
+        void Publish(TelemetryStats& stats, double frameRasterMs);
+
+    private:
+        SharedMemory m_memory;
+        TelemetryBlock* m_block = nullptr;
+        float m_rasterWindow[TTF_TELEMETRY_WINDOW] = {};
+        uint32_t m_rasterFrames = 0;
+        int64_t m_rateStart = 0;
+        uint64_t m_rateMisses = 0;
+        uint64_t m_totalMisses = 0;
+        float m_missesPerSecond = 0.f;
+};
+
+class TelemetryReader
+{
+    public:
+        TelemetryReader() = default;
+        ~TelemetryReader() {Close();}
+
+        TelemetryReader(const TelemetryReader&) = delete;
+        TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+        // Fails when no plugin publishes under the name or its block has a different version
+        bool Open(const char* name);
+        void Close();
+
+        // Copies a consistent snapshot, false when the writer kept it busy for too long
+        bool Read(TelemetryStats& stats) const;
+
+    private:
+        SharedMemory m_memory;
+        const TelemetryBlock* m_block = nullptr;
+};
+
+// Polls the block every intervalMs and appends a CSV row per poll, seconds 0 keeps going until the game stops publishing
+bool PollTelemetry(const char* name, const char* reportPath, int intervalMs, int seconds);
@@ -0,0 +1,138 @@
+#include "ttftests.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "bidi.h"
+#include "compose.h"
+#include "shaping.h"
+#include "textcore.h"
+#include "textcorpus.h"
+
+// Logical order and the visual order the reordering has to turn it into
+static const char* g_bidiChecks[][2] = {
+    {u8"abc def", u8"abc def"},
+    {u8"\u05D0\u05D1\u05D2", u8"\u05D2\u05D1\u05D0"},
+    {u8"abc \u05D0\u05D1\u05D2 def", u8"abc \u05D2\u05D1\u05D0 def"},
+    {u8"\u05D0\u05D1\u05D2 abc \u05D3\u05D4\u05D5", u8"\u05D5\u05D4\u05D3 abc \u05D2\u05D1\u05D0"},
+    {u8"\u05D0\u05D1\u05D2 123 \u05D3\u05D4\u05D5.", u8".\u05D5\u05D4\u05D3 123 \u05D2\u05D1\u05D0"},
+    {u8"(\u05D0\u05D1\u05D2)", u8"(\u05D2\u05D1\u05D0)"},
+    {u8"\u05D0\u05D1\u05D2 (abc) \u05D3\u05D4\u05D5", u8"\u05D5\u05D4\u05D3 (abc) \u05D2\u05D1\u05D0"},
+    {u8"\u0633\u0644\u0627\u0645 12", u8"12 \u0645\u0627\u0644\u0633"},
+    {u8"\u0633\u0644\u0627\u0645 \u0661\u0662", u8"\u0661\u0662 \u0645\u0627\u0644\u0633"},
+    {u8"\u05D0\u05D1\u05B8\u05D2  ", u8"  \u05D2\u05B8\u05D1\u05D0"},
+};
+
+// Logical order in, presentation forms out
+static const char* g_shapingChecks[][2] = {
+    {u8"abc", u8"abc"},
+    {u8"\u0628\u064A\u062A", u8"\uFE91\uFEF4\uFE96"},
+    {u8"\u062F\u0627\u0631", u8"\uFEA9\uFE8D\uFEAD"},
+    {u8"\u0628 \u0628", u8"\uFE8F \uFE8F"},
+    {u8"\u0628\u064E\u062A", u8"\uFE91\u064E\uFE96"},
+    {u8"\u0640\u0628", u8"\u0640\uFE90"},
+    {u8"\u0644\u0627", u8"\uFEFB"},
+    {u8"\u0633\u0644\u0627\u0645", u8"\uFEB3\uFEFC\uFEE1"},
+    {u8"\u0644\u064E\u0623", u8"\uFEF7\u064E"},
+};
+
+// Decomposed in, NFC out
+static const char* g_compositionChecks[][2] = {
+    {u8"abc", u8"abc"},
+    {u8"a\u0300", u8"\u00E0"},
+    {u8"tra\u0323i", u8"tr\u1EA1i"},
+    {u8"qu\u0103\u0323ng", u8"qu\u1EB7ng"},
+    {u8"a\u0323\u0302", u8"\u1EAD"},
+    {u8"a\u0302\u0323", u8"\u1EAD"},
+    {u8"\u01B0\u0303", u8"\u1EEF"},
+    {u8"x\u0301", u8"x\u0301"},
+    {u8"\u0627\u0654", u8"\u0623"},
+};
+
+static void DecodeCheck(const char* text, std::vector<uint32_t>& characters)
+{
+    characters.clear();
+    for(int i = 0, len = static_cast<int>(strlen(text)); i < len;)
+    {
+        int utf8size;
+        characters.push_back(DecodeCharacter(0, text + i, len - i, utf8size));
+        i += utf8size;
+    }
+}
+
+// Composes the letters with marks, shapes the Arabic words and reorders the mixed direction strings and the Hebrew and Arabic corpus slices
+const char* CheckBidi()
+{
+    BidiCache cache;
+    const char* failure = nullptr;
+    std::vector<uint32_t> logical, composed, shaped, expected;
+    for(const auto& check : g_shapingChecks)
+    {
+        DecodeCheck(check[0], logical);
+        DecodeCheck(check[1], expected);
+        ShapeArabic(logical.data(), logical.size(), shaped);
+        if(shaped != expected)
+        {
+            failure = "Shaped text differs from its expected presentation forms";
+            break;
+        }
+    }
+
+    for(const auto& check : g_compositionChecks)
+    {
+        if(failure)
+            break;
+        DecodeCheck(check[0], logical);
+        DecodeCheck(check[1], expected);
+        ComposeCharacters(logical.data(), logical.size(), composed, [](uint32_t) {return true;});
+        if(composed != expected)
+            failure = "Composed text differs from its expected precomposed characters";
+    }
+
+    // The reordering checks are written with the base letters
+    cache.SetShaping(false);
+    for(const auto& check : g_bidiChecks)
+    {
+        if(failure)
+            break;
+        DecodeCheck(check[1], expected);
+        bool rightToLeft = (&check != &g_bidiChecks[0]);
+        if(MayNeedBidi(0, check[0], static_cast<int>(strlen(check[0]))) != rightToLeft)
+            failure = "Right-to-left text wasn't detected";
+        else if(cache.Reorder(0, check[0], static_cast<int>(strlen(check[0]))) != expected)
+            failure = "Reordered text differs from its expected visual order";
+    }
+
+    // Windows-1255 and 1256 slices have to come out like their UTF-8 counterparts shaped as they are drawn, every second lookup has to hit
+    cache.SetShaping(true);
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(50, slices);
+    for(size_t i = 0; i + 1 < slices.size() && !failure; ++i)
+    {
+        const CorpusSlice& utf8Slice = slices[i];
+        const CorpusSlice& codePageSlice = slices[i + 1];
+        if(utf8Slice.encoding != 0 || (codePageSlice.encoding != 1255 && codePageSlice.encoding != 1256))
+            continue;
+
+        for(size_t line = 0; line < utf8Slice.lines.size() && !failure; ++line)
+        {
+            const std::string& utf8Line = utf8Slice.lines[line];
+            const std::string& codePageLine = codePageSlice.lines[line];
+            if(!MayNeedBidi(0, utf8Line.c_str(), static_cast<int>(utf8Line.length())) || !MayNeedBidi(codePageSlice.encoding, codePageLine.c_str(), static_cast<int>(codePageLine.length())))
+            {
+                failure = "Right-to-left text wasn't detected";
+                break;
+            }
+
+            expected = cache.Reorder(0, utf8Line.c_str(), static_cast<int>(utf8Line.length()));
+            if(cache.Reorder(codePageSlice.encoding, codePageLine.c_str(), static_cast<int>(codePageLine.length())) != expected)
+                failure = "A code page line reordered differently from its UTF-8 line";
+            size_t misses = cache.GetStats().misses;
+            if(cache.Reorder(0, utf8Line.c_str(), static_cast<int>(utf8Line.length())) != expected || cache.GetStats().misses != misses)
+                failure = "Cached visual order wasn't reused";
+        }
+    }
+
+    return failure;
+}
@@ -0,0 +1,215 @@
+#include "ttftests.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "enginetext.h"
+#include "renderbackend.h"
+#include "toolfonts.h"
+
+// The engine objects the hooks read, laid out however the compiler likes since the traits take their offsets
+struct FakeString
+{
+    const char* text;
+    int length;
+
+    const char* ToChar() const {return text;}
+    int Length() const {return length;}
+};
+
+struct FakeFont
+{
+    int size;
+    TTFont* ttFont;
+    int height;
+    int ascent;
+    int descent;
+};
+
+struct FakeView
+{
+    int pixelX;
+    int pixelWidth;
+    uintptr_t font;
+    uint32_t color;
+};
+
+struct FakeViewText
+{
+    int x;
+    int y;
+    FakeString text;
+};
+
+struct FakeViewPrint
+{
+    int pixelX;
+    int pixelY;
+    int pixelWidth;
+    int textOffsetX;
+    int textOffsetY;
+};
+
+struct FakeTraits
+{
+    typedef FakeString ViewString;
+
+    static constexpr uintptr_t FontSize = offsetof(FakeFont, size);
+    static constexpr uintptr_t FontTTF = offsetof(FakeFont, ttFont);
+    static constexpr uintptr_t FontHeight = offsetof(FakeFont, height);
+    static constexpr uintptr_t FontAscent = offsetof(FakeFont, ascent);
+    static constexpr uintptr_t FontDescent = offsetof(FakeFont, descent);
+
+    static constexpr uintptr_t ViewPixelX = offsetof(FakeView, pixelX);
+    static constexpr uintptr_t ViewPixelWidth = offsetof(FakeView, pixelWidth);
+    static constexpr uintptr_t ViewFont = offsetof(FakeView, font);
+    static constexpr uintptr_t ViewColor = offsetof(FakeView, color);
+
+    static constexpr uintptr_t ViewTextX = offsetof(FakeViewText, x);
+    static constexpr uintptr_t ViewTextY = offsetof(FakeViewText, y);
+    static constexpr uintptr_t ViewTextString = offsetof(FakeViewText, text);
+    static constexpr uintptr_t ViewPrintPixelX = offsetof(FakeViewPrint, pixelX);
+    static constexpr uintptr_t ViewPrintPixelY = offsetof(FakeViewPrint, pixelY);
+    static constexpr uintptr_t ViewPrintPixelWidth = offsetof(FakeViewPrint, pixelWidth);
+    static constexpr uintptr_t ViewPrintTextOffsetX = offsetof(FakeViewPrint, textOffsetX);
+    static constexpr uintptr_t ViewPrintTextOffsetY = offsetof(FakeViewPrint, textOffsetY);
+};
+
+// Keeps every vertex drawn so a hook's output can be compared with drawing the same text directly
+class RecordingRenderBackend : public HeadlessRenderBackend
+{
+    public:
+        void DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads) override
+        {
+            HeadlessRenderBackend::DrawQuads(page, vertices, quads);
+            m_vertices.insert(m_vertices.end(), vertices, vertices + quads * 4);
+        }
+
+        std::vector<TextVertex> TakeVertices()
+        {
+            std::vector<TextVertex> vertices;
+            vertices.swap(m_vertices);
+            return vertices;
+        }
+
+    private:
+        std::vector<TextVertex> m_vertices;
+};
+
+static bool SameVertices(const std::vector<TextVertex>& a, const std::vector<TextVertex>& b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(TextVertex)) == 0);
+}
+
+// The text zCView::Printwin gets has to keep every word in order and only hold lines that fit the view
+static const char* CheckViewWrap(const FakeFont& font, FakeView& view)
+{
+    static const char text[] = "Der Kerl hat mir das Schwert gestohlen und ist in Richtung des alten Lagers verschwunden.\n"
+        "Wenn du ihn findest, bring es mir zur\xC3\xBC" "ck und ich zahle dir hundert Goldst\xC3\xBC" "cke.";
+    FakeString string = {text, static_cast<int>(sizeof(text) - 1)};
+    int spaceWidth = font.size / 4;
+    std::string broken;
+    view.pixelWidth = MeasureGlyphs(font.ttFont, spaceWidth, g_useEncoding, text, string.length);
+    if(BreakViewText<FakeTraits>(reinterpret_cast<uintptr_t>(&view), string, broken))
+        return "BreakViewText broke text that already fits at its own line feed";
+
+    // Wide enough for every word so all breaks fall on spaces
+    view.pixelWidth = 200;
+    if(!BreakViewText<FakeTraits>(reinterpret_cast<uintptr_t>(&view), string, broken))
+        return "BreakViewText didn't break text wider than the view";
+
+    std::string words(text);
+    std::string brokenWords(broken);
+    std::replace(words.begin(), words.end(), '\n', ' ');
+    std::replace(brokenWords.begin(), brokenWords.end(), '\n', ' ');
+    if(brokenWords != words)
+        return "BreakViewText lost or moved text instead of turning the spaces it breaks at into line feeds";
+
+    size_t lines = 0;
+    for(size_t start = 0; start <= broken.length(); ++lines)
+    {
+        size_t end = broken.find('\n', start);
+        if(end == std::string::npos)
+            end = broken.length();
+        if(MeasureGlyphs(font.ttFont, spaceWidth, g_useEncoding, broken.c_str() + start, static_cast<int>(end - start)) > view.pixelWidth)
+            return "BreakViewText left a line wider than the view";
+        start = end + 1;
+    }
+    if(lines < 5)
+        return "BreakViewText didn't wrap the text to the view's width";
+    return nullptr;
+}
+
+static const char* CheckEngineHooks(RecordingRenderBackend& backend, TTFont* ttFont)
+{
+    FakeFont font = {};
+    uintptr_t zCFont = reinterpret_cast<uintptr_t>(&font);
+    SetEngineFont<FakeTraits>(zCFont, ttFont);
+    if(font.ttFont != ttFont || font.size != static_cast<int>(ttFont->scaler.height) || font.height != ttFont->height
+        || font.ascent != ttFont->ascent || font.descent != ttFont->descent)
+        return "SetEngineFont didn't fill in the font's members";
+    if(GetFontY<FakeTraits>(zCFont) != ttFont->height - ttFont->descent)
+        return "GetFontY isn't the font height without the descent";
+
+    static const char text[] = "Gothic \xC3\x9C" "berschrift, die breiter als der Ausschnitt ist";
+    FakeString string = {text, static_cast<int>(sizeof(text) - 1)};
+    int spaceWidth = font.size / 4;
+    int width = MeasureGlyphs(ttFont, spaceWidth, g_useEncoding, text, string.length);
+    uint32_t measureCalls = g_textCounters.measureCalls;
+    if(GetFontX<FakeTraits>(zCFont, string) != width)
+        return "GetFontX differs from MeasureGlyphs";
+    if(g_textCounters.measureCalls != measureCalls + 1)
+        return "GetFontX didn't count its measure call";
+
+    // The view ends halfway through the text so the clip has to come from its members
+    FakeView view = {30, width / 2, zCFont, 0xFFC08040};
+    uint32_t drawCalls = g_textCounters.drawCalls;
+    PrintChars<FakeTraits>(reinterpret_cast<uintptr_t>(&view), 40, 70, string);
+    std::vector<TextVertex> printed = backend.TakeVertices();
+    backend.BeginText();
+    DrawGlyphs(ttFont, 40, 70 + font.ascent, spaceWidth, static_cast<float>(view.pixelX + view.pixelWidth), GetGlyphColor(ttFont, view.color),
+        g_useEncoding, text, string.length);
+    backend.EndText();
+    std::vector<TextVertex> expected = backend.TakeVertices();
+    if(expected.empty() || !SameVertices(printed, expected))
+        return "PrintChars drew differently from DrawGlyphs at the view's font, color and clip";
+
+    backend.BeginText();
+    DrawGlyphs(ttFont, 40, 70 + font.ascent, spaceWidth, 1000000.f, GetGlyphColor(ttFont, view.color), g_useEncoding, text, string.length);
+    backend.EndText();
+    if(backend.TakeVertices().size() <= printed.size())
+        return "PrintChars didn't clip the text to the view";
+
+    FakeViewText viewText = {12, 5, string};
+    FakeViewPrint viewPrint = {100, 200, 3 * width / 4, 7, 9};
+    BlitTextCharacters<FakeTraits>(reinterpret_cast<uintptr_t>(&viewPrint), reinterpret_cast<uintptr_t>(&viewText), zCFont, 0xFF20A0FF);
+    std::vector<TextVertex> blitted = backend.TakeVertices();
+    backend.BeginText();
+    DrawGlyphs(ttFont, 100 + 7 + 12, 200 + 9 + 5 + font.ascent, spaceWidth, static_cast<float>(viewPrint.pixelX + viewPrint.pixelWidth),
+        GetGlyphColor(ttFont, 0xFF20A0FF), g_useEncoding, text, string.length);
+    backend.EndText();
+    expected = backend.TakeVertices();
+    if(expected.empty() || !SameVertices(blitted, expected))
+        return "BlitTextCharacters drew differently from DrawGlyphs at the view text's position and the view's clip";
+
+    if(g_textCounters.drawCalls != drawCalls + 2)
+        return "PrintChars and BlitTextCharacters didn't count one draw call each";
+    return CheckViewWrap(font, view);
+}
+
+// Instantiates the engine hooks' bodies against FakeTraits and a font of the bundled ones,
+// they have to read the fake engine's members, draw exactly what DrawGlyphs draws for them and wrap to the view
+const char* CheckEngineText()
+{
+    RecordingRenderBackend backend;
+    g_renderBackend = &backend;
+    TTFont* ttFont = LoadToolFont("DejaVuSans.ttf:Size=20");
+    const char* failure = (ttFont ? CheckEngineHooks(backend, ttFont) : "Failed to load font");
+    UnloadToolFonts();
+    g_renderBackend = nullptr;
+    return failure;
+}
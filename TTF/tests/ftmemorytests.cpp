@@ -0,0 +1,167 @@
+#include "ttftests.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "ftmemory.h"
+
+static bool HasPattern(const void* block, size_t size, unsigned char seed)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(block);
+    for(size_t i = 0; i < size; ++i)
+    {
+        if(bytes[i] != static_cast<unsigned char>(seed + i))
+            return false;
+    }
+    return true;
+}
+
+static void FillPattern(void* block, size_t size, unsigned char seed)
+{
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(block);
+    for(size_t i = 0; i < size; ++i)
+        bytes[i] = static_cast<unsigned char>(seed + i);
+}
+
+// Frees a block of each size class and takes them back, every size class has to hand out the chunk freed last
+static const char* CheckFreeListReuse(FTPoolAllocator& allocator)
+{
+    static const size_t sizes[] = {1, 16, 24, 64, 100, 256, 1000, 2048, 4096};
+    std::vector<void*> blocks;
+    for(size_t size : sizes)
+    {
+        // A neighbour that stays allocated keeps the freed chunk from being the only one of its class
+        blocks.push_back(allocator.Allocate(size));
+        blocks.push_back(allocator.Allocate(size));
+    }
+    for(size_t i = 0; i < blocks.size(); i += 2)
+        allocator.Free(blocks[i]);
+    for(size_t i = blocks.size(); i > 0; i -= 2)
+    {
+        size_t size = sizes[(i - 2) / 2];
+        void* block = allocator.Allocate(size);
+        if(block != blocks[i - 2])
+            return "A size class didn't reuse the chunk freed last";
+        if(reinterpret_cast<uintptr_t>(block) % 8 != 0)
+            return "A pooled block isn't 8-byte aligned";
+    }
+    for(void* block : blocks)
+        allocator.Free(block);
+    return nullptr;
+}
+
+// Grows a block through every size class into a CRT block and shrinks it back, through FreeType's FT_Memory callbacks
+static const char* CheckReallocate(FTPoolAllocator& allocator)
+{
+    static const long sizes[] = {8, 16, 17, 200, 4096, 4097, 20000, 3000, 40, 12};
+    FT_Memory memory = allocator.GetMemory();
+    void* block = memory->alloc(memory, sizes[0]);
+    FillPattern(block, static_cast<size_t>(sizes[0]), 7);
+    for(size_t i = 1; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        size_t kept = static_cast<size_t>(sizes[i] < sizes[i - 1] ? sizes[i] : sizes[i - 1]);
+        block = memory->realloc(memory, sizes[i - 1], sizes[i], block);
+        if(!block || !HasPattern(block, kept, 7))
+            return "Reallocating lost the contents of a block";
+        if(allocator.GetStats(FTArena_Face).liveBytes != static_cast<size_t>(sizes[i]))
+            return "Reallocating didn't move the live bytes to the new size";
+        FillPattern(block, static_cast<size_t>(sizes[i]), 7);
+    }
+    memory->free(memory, block);
+    return nullptr;
+}
+
+// Blocks above the largest size class come from the CRT, each one reserves exactly its size and header
+static const char* CheckLargeBlocks(FTPoolAllocator& allocator)
+{
+    size_t reserved = allocator.GetStats(FTArena_Face).reservedBytes;
+    void* block = allocator.Allocate(4097);
+    void* bigger = allocator.Allocate(100000);
+    if(allocator.GetStats(FTArena_Face).reservedBytes != reserved + 4097 + 100000 + 2 * 8)
+        return "Blocks over 4 KiB didn't go to the CRT heap";
+    allocator.Free(block);
+    allocator.Free(bigger);
+    if(allocator.GetStats(FTArena_Face).reservedBytes != reserved)
+        return "Freeing blocks over 4 KiB didn't give their memory back";
+    return nullptr;
+}
+
+// FreeType frees glyph data long after the scope that loaded it, the block has to go back to the arena it came from
+static const char* CheckFreeOutsideScope(FTPoolAllocator& allocator)
+{
+    void* block;
+    void* large;
+    {
+        FTArenaScope scope(allocator, FTArena_Transient);
+        block = allocator.Allocate(48);
+        large = allocator.Allocate(8000);
+    }
+    if(allocator.GetArena() != FTArena_Face)
+        return "FTArenaScope didn't restore the previous arena";
+
+    size_t faceFrees = allocator.GetStats(FTArena_Face).frees;
+    size_t transientFrees = allocator.GetStats(FTArena_Transient).frees;
+    allocator.Free(block);
+    allocator.Free(large);
+    const FTArenaStats& transient = allocator.GetStats(FTArena_Transient);
+    if(transient.liveBytes != 0 || transient.frees != transientFrees + 2 || allocator.GetStats(FTArena_Face).frees != faceFrees)
+        return "A block freed outside its scope was counted in the wrong arena";
+
+    FTArenaScope scope(allocator, FTArena_Transient);
+    if(allocator.Allocate(48) != block)
+        return "A block freed outside its scope didn't return to its arena's free list";
+    allocator.Free(block);
+    return nullptr;
+}
+
+// Allocates, reallocates and frees through an allocator of its own and checks the counters end where they started
+const char* CheckFTMemory()
+{
+    struct Step
+    {
+        const char*(*run)(FTPoolAllocator&);
+    };
+    static const Step steps[] = {{&CheckFreeListReuse}, {&CheckReallocate}, {&CheckLargeBlocks}, {&CheckFreeOutsideScope}};
+
+    FTPoolAllocator allocator;
+    for(const Step& step : steps)
+    {
+        FTArenaStats before[FTArena_Count];
+        for(int arena = 0; arena < FTArena_Count; ++arena)
+            before[arena] = allocator.GetStats(static_cast<FTArenaType>(arena));
+
+        if(const char* failure = step.run(allocator))
+            return failure;
+
+        for(int arena = 0; arena < FTArena_Count; ++arena)
+        {
+            const FTArenaStats& after = allocator.GetStats(static_cast<FTArenaType>(arena));
+            if(after.liveBytes != before[arena].liveBytes)
+                return "Live bytes didn't return to where they started";
+            if(after.allocations - before[arena].allocations != after.frees - before[arena].frees)
+                return "Allocations and frees don't match";
+            if(after.peakBytes < before[arena].peakBytes || after.peakBytes < after.liveBytes)
+                return "Peak bytes fell below the live bytes";
+        }
+    }
+
+    // Slabs stay reserved once carved, so a second round of the same steps must be served from them without reserving more
+    FTArenaStats reserved[FTArena_Count];
+    for(int arena = 0; arena < FTArena_Count; ++arena)
+        reserved[arena] = allocator.GetStats(static_cast<FTArenaType>(arena));
+    for(const Step& step : steps)
+    {
+        if(const char* failure = step.run(allocator))
+            return failure;
+    }
+    for(int arena = 0; arena < FTArena_Count; ++arena)
+    {
+        const FTArenaStats& after = allocator.GetStats(static_cast<FTArenaType>(arena));
+        if(after.liveBytes != 0 || after.reservedBytes != reserved[arena].reservedBytes)
+            return "Repeating the steps reserved more memory instead of reusing the free lists";
+        if(after.peakBytes != reserved[arena].peakBytes)
+            return "Repeating the steps raised the peak";
+    }
+    return nullptr;
+}
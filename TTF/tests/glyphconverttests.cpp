@@ -0,0 +1,54 @@
+#include "ttftests.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "glyphconvert.h"
+
+// Converts random coverage rows with every kernel the CPU runs and compares them byte for byte with the scalar kernel
+// The rows are followed by guard bytes so a kernel writing past its last texel fails too
+const char* CheckGlyphConvert()
+{
+    const unsigned char guard = 0xA5;
+    const int maxWidth = 80;
+    uint32_t seed = 12345;
+    auto random = [&seed]()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    unsigned char alphaTable[256];
+    std::vector<unsigned char> src(maxWidth);
+    std::vector<unsigned char> expected, converted;
+    for(int format = 0; format < GlyphFormat_Count; ++format)
+    {
+        GlyphTextureFormat textureFormat = static_cast<GlyphTextureFormat>(format);
+        size_t texelSize = GetGlyphTexelSize(textureFormat);
+        GlyphConvertRowFunc scalar = GetGlyphConvertRow(textureFormat, GlyphConvert_Scalar);
+        for(int round = 0; round < 8; ++round)
+        {
+            // Fully opaque without gamma, then random font alpha and gamma
+            BuildAlphaTable(alphaTable, round == 0 ? 255 : static_cast<int>(random() % 256), round == 0 ? 1.f : 0.5f + (random() % 100) / 50.f);
+            uint32_t color = random() & 0x00FFFFFF;
+            for(int width = 0; width <= maxWidth; ++width)
+            {
+                for(unsigned char& coverage : src)
+                    coverage = static_cast<unsigned char>(random());
+
+                size_t rowBytes = static_cast<size_t>(width) * texelSize;
+                expected.assign(rowBytes + 16, guard);
+                scalar(expected.data(), src.data(), width, alphaTable, color);
+                for(int level = GlyphConvert_SSE2; level <= GetGlyphConvertLevel(); ++level)
+                {
+                    converted.assign(rowBytes + 16, guard);
+                    GetGlyphConvertRow(textureFormat, static_cast<GlyphConvertLevel>(level))(converted.data(), src.data(), width, alphaTable, color);
+                    if(converted != expected)
+                        return "A SIMD kernel converted a row differently from the scalar kernel";
+                }
+            }
+        }
+    }
+    return nullptr;
+}
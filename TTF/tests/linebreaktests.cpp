@@ -0,0 +1,44 @@
+#include "ttftests.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "linebreak.h"
+
+struct LineBreakCheck
+{
+    std::vector<uint32_t> characters;
+    // Whether a line may end after each character but the last
+    std::vector<uint8_t> breaks;
+};
+
+static const LineBreakCheck g_lineBreakChecks[] = {
+    // Ideographs break between any two of them
+    {{0x6F22, 0x5B57, 0x6587}, {BreakOpportunity_Allowed, BreakOpportunity_Allowed}},
+    // Small kana and the prolonged sound mark stay with the kana before them
+    {{0x3042, 0x3063, 0x3042, 0x30FC, 0x3042}, {BreakOpportunity_None, BreakOpportunity_Allowed, BreakOpportunity_None, BreakOpportunity_Allowed}},
+    {{0x30AB, 0x30C3, 0x30C8, 0x30E3}, {BreakOpportunity_None, BreakOpportunity_Allowed, BreakOpportunity_None}},
+    {{0x30C8, 0x31F0, 0x30C8}, {BreakOpportunity_None, BreakOpportunity_Allowed}},
+    {{0xFF76, 0xFF6F, 0xFF76, 0xFF70}, {BreakOpportunity_None, BreakOpportunity_Allowed, BreakOpportunity_None}},
+    // Closing punctuation doesn't start a line
+    {{0x6F22, 0x3002, 0x5B57}, {BreakOpportunity_None, BreakOpportunity_Allowed}},
+    {{'a', 'b', ' ', 'c'}, {BreakOpportunity_None, BreakOpportunity_None, BreakOpportunity_Allowed}},
+};
+
+// Runs FindLineBreaks on short strings whose break opportunities UAX #14 spells out
+const char* CheckLineBreaks()
+{
+    std::vector<uint8_t> breaks;
+    for(const LineBreakCheck& check : g_lineBreakChecks)
+    {
+        breaks.assign(check.characters.size(), 0xFF);
+        FindLineBreaks(check.characters.data(), check.characters.size(), breaks.data());
+        if(breaks.back() != BreakOpportunity_None)
+            return "The end of the text got a break opportunity";
+        breaks.pop_back();
+        if(breaks != check.breaks)
+            return "Break opportunities differ from the expected ones";
+    }
+    return nullptr;
+}
@@ -0,0 +1,116 @@
+#include "ttftests.h"
+
+#include <string>
+#include <vector>
+
+#include "ttfapi.h"
+#include "textapi.h"
+#include "textcore.h"
+#include "textcorpus.h"
+#include "renderbackend.h"
+#include "toolfonts.h"
+
+// Measures every corpus line in every encoding and draws it, the widths have to be where the pen ends up
+const char* CheckMeasureDrawn()
+{
+    HeadlessRenderBackend backend;
+    g_renderBackend = &backend;
+    g_resolveFontFile = &ResolveToolFontFile;
+    // Fonts of the text API are the plugin's own TTFont
+    TTF_Font* apiFont = TTF_GetFont("DejaVuSans.ttf:Size=20");
+    TTFont* font = reinterpret_cast<TTFont*>(apiFont);
+    if(!font)
+    {
+        g_renderBackend = nullptr;
+        return "Failed to load font";
+    }
+
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(50, slices);
+    int spaceWidth = static_cast<int>(font->scaler.height) / 4;
+    const char* failure = nullptr;
+    size_t changedLines = 0;
+    for(const CorpusSlice& slice : slices)
+    {
+        for(size_t i = 0; i < slice.lines.size() && !failure; ++i)
+        {
+            const std::string& line = slice.lines[i];
+            int len = static_cast<int>(line.length());
+            backend.BeginText();
+            int drawn = DrawGlyphs(font, 0, font->ascent, spaceWidth, 1000000.f, GetGlyphColor(font, 0xFFFFFFFF), slice.encoding, line.c_str(), len);
+            backend.EndText();
+
+            if(MeasureGlyphs(font, spaceWidth, slice.encoding, line.c_str(), len) != drawn)
+                failure = "Measured width differs from the drawn width";
+            else if(slice.encoding == API_ENCODING && TTF_MeasureText(apiFont, line.c_str(), len) != drawn)
+                failure = "TTF_MeasureText differs from the drawn width";
+
+            // A layout wide enough for the whole line gives it the drawn width too
+            TTF_TextLine layoutLine;
+            if(!failure && slice.encoding == API_ENCODING && line.find('\n') == std::string::npos
+                && (TTF_LayoutText(apiFont, line.c_str(), len, drawn, &layoutLine, 1) != 1 || layoutLine.width != drawn))
+                failure = "TTF_LayoutText differs from the drawn width";
+
+            int logical = MeasureText(slice.encoding, line.c_str(), len, spaceWidth, [font](uint32_t utf32)
+            {
+                return GetGlyphAdvance(font, utf32);
+            });
+            if(logical != drawn)
+                ++changedLines;
+        }
+    }
+
+    // The corpus has to reach the lines that compose or shape for the check to mean anything
+    if(!failure && changedLines == 0)
+        failure = "No corpus line draws narrower or wider than its characters";
+
+    UnloadToolFonts();
+    g_renderBackend = nullptr;
+    return failure;
+}
+
+// Measures every corpus line word by word like the engine's word wrap, once through PrefixMeasure and once from scratch,
+// both have to give the same widths and count the same glyph usage
+const char* CheckPrefixUsage()
+{
+    HeadlessRenderBackend backend;
+    g_renderBackend = &backend;
+    TTFont* font = LoadToolFont("DejaVuSans.ttf:Size=20");
+    if(!font)
+    {
+        g_renderBackend = nullptr;
+        return "Failed to load font";
+    }
+
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(20, slices);
+    int spaceWidth = static_cast<int>(font->scaler.height) / 4;
+    PrefixMeasure prefixMeasure;
+    GlyphHistogram prefixUsage, usage;
+    const char* failure = nullptr;
+    for(const CorpusSlice& slice : slices)
+    {
+        for(size_t i = 0; i < slice.lines.size() && !failure; ++i)
+        {
+            const std::string& line = slice.lines[i];
+            for(size_t end = line.find(' '); !failure; end = line.find(' ', end + 1))
+            {
+                int len = static_cast<int>(end == std::string::npos ? line.length() : end);
+                font->usage = &prefixUsage;
+                int prefixWidth = MeasurePrefix(prefixMeasure, font, spaceWidth, slice.encoding, line.c_str(), len);
+                font->usage = &usage;
+                if(MeasureGlyphs(font, spaceWidth, slice.encoding, line.c_str(), len) != prefixWidth)
+                    failure = "Prefix measured width differs from the whole line";
+                if(end == std::string::npos)
+                    break;
+            }
+        }
+    }
+    font->usage = nullptr;
+    if(!failure && (usage.empty() || prefixUsage != usage))
+        failure = "Prefix measuring counted other glyph usage than measuring whole lines";
+
+    UnloadToolFonts();
+    g_renderBackend = nullptr;
+    return failure;
+}
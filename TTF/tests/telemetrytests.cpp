@@ -0,0 +1,101 @@
+#include "ttftests.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "telemetry.h"
+#include "textstats.h"
+
+#define TELEMETRY_TEST_FRAMES 20000
+
+// Every field of a frame's stats is derived from its number, a snapshot mixing two frames can't pass this
+static void FillFrameStats(TelemetryStats& stats, uint32_t frame)
+{
+    stats = TelemetryStats();
+    stats.frame = frame;
+    stats.fonts = frame * 3;
+    stats.cachedGlyphs = frame * 5;
+    stats.atlasPages = frame * 7;
+    stats.drawCalls = frame * 11;
+    stats.glyphsDrawn = frame * 13;
+    stats.measureCalls = frame * 17;
+    stats.cacheMisses = 1;
+    stats.textureBytes = frame * 19ull;
+    stats.texturePeakBytes = frame * 23ull;
+    stats.freeTypeBytes = frame * 29ull;
+    stats.textureSurfaces = frame * 31;
+}
+
+static bool IsFrameStats(const TelemetryStats& stats)
+{
+    uint32_t frame = stats.frame;
+    // One miss a frame adds up to the frame number, the raster time of the frame is the frame number too
+    return stats.fonts == frame * 3 && stats.cachedGlyphs == frame * 5 && stats.atlasPages == frame * 7 && stats.drawCalls == frame * 11
+        && stats.glyphsDrawn == frame * 13 && stats.measureCalls == frame * 17 && stats.cacheMisses == 1 && stats.totalCacheMisses == frame
+        && stats.textureBytes == frame * 19ull && stats.texturePeakBytes == frame * 23ull && stats.freeTypeBytes == frame * 29ull
+        && stats.textureSurfaces == frame * 31 && stats.rasterMs == static_cast<float>(frame);
+}
+
+// Publishes frames from a writer thread while the reader keeps taking snapshots of the same segment,
+// every snapshot has to be one whole frame and the frames have to come in order
+const char* CheckTelemetry()
+{
+    // Parallel ctest runs must not share a segment
+    std::string name = "Local\\GothicTTF_TelemetryTest_" + std::to_string(TextStatsTimestamp());
+    TelemetryReader reader;
+    if(reader.Open(name.c_str()))
+        return "Opened a segment nobody publishes";
+
+    TelemetryWriter writer;
+    if(!writer.Open(name.c_str()))
+        return "Failed to create the telemetry segment";
+    TelemetryWriter second;
+    if(second.Open(name.c_str()))
+        return "A second writer opened a segment that is published already";
+    if(!reader.Open(name.c_str()))
+        return "Failed to open the published segment";
+
+    std::atomic<bool> done(false);
+    std::thread writerThread([&writer, &done]()
+    {
+        TelemetryStats stats;
+        for(uint32_t frame = 1; frame <= TELEMETRY_TEST_FRAMES; ++frame)
+        {
+            FillFrameStats(stats, frame);
+            writer.Publish(stats, frame);
+        }
+        done.store(true);
+    });
+
+    const char* failure = nullptr;
+    uint32_t lastFrame = 0;
+    uint32_t snapshots = 0;
+    bool finished = false;
+    while(!failure && !finished)
+    {
+        finished = done.load();
+        TelemetryStats stats;
+        if(!reader.Read(stats))
+            continue;
+        // The block starts out zeroed before the first frame gets published
+        if(stats.frame == 0 && lastFrame == 0)
+            continue;
+        if(!IsFrameStats(stats))
+            failure = "Read a torn snapshot";
+        else if(stats.frame < lastFrame)
+            failure = "Read an older frame after a newer one";
+        lastFrame = stats.frame;
+        ++snapshots;
+    }
+    writerThread.join();
+
+    if(!failure && lastFrame != TELEMETRY_TEST_FRAMES)
+        failure = "The last snapshot isn't the last published frame";
+    else if(!failure && snapshots < 2)
+        failure = "The reader never raced the writer";
+    reader.Close();
+    writer.Close();
+    return failure;
+}
@@ -0,0 +1,116 @@
+#include "ttftests.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ttfapi.h"
+#include "textapi.h"
+#include "textcorpus.h"
+#include "textstats.h"
+#include "glyphcache.h"
+#include "renderbackend.h"
+#include "toolfonts.h"
+
+// Checks what the public API promises for one line of text and queues it, nullptr when it holds
+static const char* CheckApiText(TTF_Font* font, const std::string& text, int maxWidth, std::vector<TTF_TextLine>& lines, uint32_t& glyphs)
+{
+    int len = static_cast<int>(text.length());
+    lines.resize(static_cast<size_t>(std::max(TTF_LayoutText(font, text.c_str(), len, maxWidth, nullptr, 0), 1)));
+    if(TTF_LayoutText(font, text.c_str(), len, maxWidth, lines.data(), static_cast<int32_t>(lines.size())) != static_cast<int32_t>(lines.size()))
+        return "Layout gave a different line count the second time";
+
+    // Lines come in order and only the spaces and line feeds they were broken at lie between them
+    auto onlySpaces = [&text](int start, int end)
+    {
+        for(int i = start; i < end; ++i)
+        {
+            if(static_cast<unsigned char>(text[i]) > ' ')
+                return false;
+        }
+        return true;
+    };
+
+    int end = 0;
+    for(const TTF_TextLine& line : lines)
+    {
+        int utf8size;
+        if(line.start < end || line.start + line.length > len || !onlySpaces(end, line.start))
+            return "Wrapped lines don't cover the text";
+        if(line.width != TTF_MeasureText(font, text.c_str() + line.start, line.length))
+            return "Wrapped line width differs from its measured width";
+        // Only a single character that doesn't fit on its own may overflow
+        if(line.width > maxWidth && (DecodeCharacter(API_ENCODING, text.c_str() + line.start, line.length, utf8size), utf8size != line.length))
+            return "Wrapped line is wider than the layout width";
+        end = line.start + line.length;
+    }
+    if(!onlySpaces(end, len))
+        return "Wrapped lines don't cover the text";
+
+    if(!TTF_DrawText(font, 0, 0, 0xFFFFFFFF, text.c_str(), -1))
+        return "Failed to queue text";
+    // Composed and shaped lines draw fewer glyphs than they have characters
+    if(g_bidiCache.IsNeeded(API_ENCODING, text.c_str(), len))
+    {
+        for(uint32_t utf32 : g_bidiCache.Reorder(API_ENCODING, text.c_str(), len, font, FontHasCharacter))
+        {
+            if(utf32 > 32)
+                ++glyphs;
+        }
+        return nullptr;
+    }
+    for(int i = 0; i < len;)
+    {
+        int utf8size;
+        if(DecodeCharacter(API_ENCODING, text.c_str() + i, len - i, utf8size) > 32)
+            ++glyphs;
+        i += utf8size;
+    }
+    return nullptr;
+}
+
+// Measures, wraps and draws every UTF-8 line of the corpus through the exported functions like another plugin would
+const char* CheckTextApi()
+{
+    HeadlessRenderBackend backend;
+    g_renderBackend = &backend;
+    g_resolveFontFile = &ResolveToolFontFile;
+    const char* descriptor = "DejaVuSans.ttf:Size=20";
+    TTF_Font* font = TTF_GetFont(descriptor);
+    TTF_FontMetrics metrics;
+    const char* failure = nullptr;
+    if(TTF_GetApiVersion() != TTF_API_VERSION)
+        failure = "Wrong API version";
+    else if(!font)
+        failure = "Failed to load font";
+    else if(TTF_GetFont(descriptor) != font)
+        failure = "The same descriptor opened a second font";
+    else if(!TTF_GetFontMetrics(font, &metrics) || metrics.size != 20)
+        failure = "Font metrics don't match the descriptor";
+
+    // A width that fits a few words and one narrower than some of them
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(50, slices);
+    std::vector<TTF_TextLine> lines;
+    uint32_t glyphs = 0;
+    g_textCounters = TextFrameCounters();
+    for(int width : {300, 40})
+    {
+        for(const CorpusSlice& slice : slices)
+        {
+            for(size_t i = 0; i < slice.lines.size() && !failure && slice.encoding == API_ENCODING; ++i)
+                failure = CheckApiText(font, slice.lines[i], width, lines, glyphs);
+        }
+    }
+
+    if(!failure)
+    {
+        DrawQueuedText();
+        if(HasQueuedText() || g_textCounters.glyphsDrawn != glyphs || backend.GetStats().quads != glyphs)
+            failure = "Queued text didn't draw every glyph";
+    }
+
+    UnloadToolFonts();
+    g_renderBackend = nullptr;
+    return failure;
+}
@@ -0,0 +1,127 @@
+#include "ttftests.h"
+
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+#include "textapi.h"
+#include "textbatch.h"
+#include "tooltrace.h"
+
+// Pages as a renderer using the text batching API sees them
+struct MirrorPage
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    std::vector<unsigned char> texels;
+};
+
+// Checks one pulled frame the way a renderer depends on it and applies its page updates to the mirror, nullptr when it holds
+static const char* CheckTextFrame(const TTF_TextFrame& frame, uint32_t glyphsDrawn, std::unordered_map<const void*, MirrorPage>& mirror)
+{
+    if(frame.version != TTF_TEXT_BATCH_VERSION)
+        return "Pulled a frame with the wrong version";
+
+    for(uint32_t i = 0; i < frame.releasedCount; ++i)
+    {
+        if(mirror.erase(frame.releasedPages[i]) == 0)
+            return "Released a page that never had an update";
+    }
+
+    for(uint32_t i = 0; i < frame.updateCount; ++i)
+    {
+        const TTF_TextPageUpdate& update = frame.updates[i];
+        if(update.format >= GlyphFormat_Count || update.width == 0 || update.height == 0 || update.x + update.width > update.pageWidth
+            || update.y + update.height > update.pageHeight)
+            return "Page update outside of its page";
+
+        MirrorPage& page = mirror[update.page];
+        if(page.texels.empty())
+        {
+            page.width = update.pageWidth;
+            page.height = update.pageHeight;
+            page.format = update.format;
+            page.texels.resize(static_cast<size_t>(page.width) * page.height * GetGlyphTexelSize(static_cast<GlyphTextureFormat>(page.format)));
+        }
+        else if(page.width != update.pageWidth || page.height != update.pageHeight || page.format != update.format)
+            return "Page changed its size or format";
+
+        unsigned int texelSize = GetGlyphTexelSize(static_cast<GlyphTextureFormat>(page.format));
+        for(uint32_t y = 0; y < update.height; ++y)
+            memcpy(&page.texels[((update.y + y) * page.width + update.x) * texelSize], update.texels + y * update.pitch, update.width * texelSize);
+    }
+
+    uint32_t quads = 0;
+    for(uint32_t i = 0; i < frame.batchCount; ++i)
+    {
+        const TTF_TextBatch& batch = frame.batches[i];
+        if(mirror.find(batch.page) == mirror.end())
+            return "Batch draws with a page that never had an update";
+        if(batch.firstQuad + batch.quads > frame.quadCount)
+            return "Batch reaches past the pulled quads";
+        quads += batch.quads;
+    }
+    if(quads != glyphsDrawn || frame.quadCount != glyphsDrawn)
+        return "Pulled quads don't match the glyphs drawn";
+
+    // Dirty rectangles have to cover every texel the plugin wrote
+    if(mirror.size() != g_batchBackend.GetStats().livePages)
+        return "Mirrored pages don't match the plugin's pages";
+    for(const auto& it : mirror)
+    {
+        GlyphPageLock lock;
+        if(!g_batchBackend.LockPage(const_cast<void*>(it.first), nullptr, true, lock))
+            return "Failed to read a page";
+
+        size_t rowBytes = static_cast<size_t>(it.second.width) * GetGlyphTexelSize(static_cast<GlyphTextureFormat>(it.second.format));
+        for(unsigned int y = 0; y < lock.rows; ++y)
+        {
+            if(memcmp(lock.texels + y * lock.pitch, &it.second.texels[y * rowBytes], rowBytes) != 0)
+                return "Mirrored page differs, a page update is missing";
+        }
+    }
+    return nullptr;
+}
+
+// Pulls every frame of the corpus trace through the exported functions like a renderer would
+const char* CheckTextBatching()
+{
+    if(!WriteCorpusTrace("textbatching.trace", 40, {"DejaVuSans.ttf:Size=18", "DejaVuSans.ttf:Size=32"}))
+        return "Failed to write the corpus trace";
+
+    // Starts from the backend the game would have, small pages so the glyphs spread over several of them
+    HeadlessRenderBackend deviceBackend;
+    g_renderBackend = &deviceBackend;
+    g_glyphAtlas.SetPageSize(256);
+    if(TTF_EnableTextBatching(TTF_TEXT_BATCH_VERSION + 1) || !TTF_EnableTextBatching(TTF_TEXT_BATCH_VERSION))
+    {
+        g_renderBackend = nullptr;
+        return "Text batching didn't check the API version";
+    }
+
+    TracedFonts fonts;
+    std::unordered_map<const void*, MirrorPage> mirror;
+    const char* failure = nullptr;
+    uint32_t frames = 0;
+    g_textCounters = TextFrameCounters();
+    bool success = DrawTracedText("textbatching.trace", fonts, [&failure](uint32_t)
+    {
+        return failure == nullptr;
+    }, [&](uint32_t, int64_t)
+    {
+        TTF_TextFrame frame;
+        if(!failure)
+            failure = (TTF_GetTextFrame(&frame) ? CheckTextFrame(frame, g_textCounters.glyphsDrawn, mirror) : "Failed to pull a frame");
+        g_textCounters = TextFrameCounters();
+        ++frames;
+    });
+
+    UnloadToolFonts();
+    g_renderBackend = nullptr;
+    if(!success)
+        return "Failed to draw the corpus trace";
+    if(!failure && (frames == 0 || mirror.size() < 2))
+        failure = "The corpus trace didn't fill more than one page";
+    return failure;
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "toolfonts.h"
+#include "ttftests.h"
+
+#ifndef TTF_BUNDLED_FONTS
+#define TTF_BUNDLED_FONTS "fonts"
+#endif
+
+struct TestCheck
+{
+    const char* name;
+    const char*(*run)();
+};
+
+static const TestCheck g_testChecks[] = {
+    {"text_batching", &CheckTextBatching},
+    {"text_api", &CheckTextApi},
+    {"measure_drawn", &CheckMeasureDrawn},
+    {"prefix_usage", &CheckPrefixUsage},
+    {"bidi", &CheckBidi},
+    {"line_breaks", &CheckLineBreaks},
+    {"glyph_convert", &CheckGlyphConvert},
+    {"ftmemory", &CheckFTMemory},
+    {"telemetry", &CheckTelemetry},
+    {"engine_text", &CheckEngineText},
+};
+
+int main(int argc, char** argv)
+{
+    if(argc != 2)
+    {
+        fprintf(stderr, "Usage: ttftests <check>\n");
+        return 2;
+    }
+
+    for(const TestCheck& check : g_testChecks)
+    {
+        if(strcmp(argv[1], check.name) != 0)
+            continue;
+
+        if(!InitializeToolFonts(TTF_BUNDLED_FONTS))
+        {
+            fprintf(stderr, "Failed to initialize FreeType\n");
+            return 1;
+        }
+        const char* failure = check.run();
+        ShutdownToolFonts();
+        if(failure)
+        {
+            fprintf(stderr, "%s: %s\n", check.name, failure);
+            return 1;
+        }
+        printf("%s held\n", check.name);
+        return 0;
+    }
+
+    fprintf(stderr, "Unknown check %s\n", argv[1]);
+    return 2;
+}
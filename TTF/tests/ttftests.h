@@ -0,0 +1,15 @@
+#pragma once
+
+// Checks of the headless build, ctest runs each of them as "ttftests <check>"
+// They run with FreeType set up on the bundled fonts and return nullptr when they hold or the first failure
+
+const char* CheckTextBatching();
+const char* CheckTextApi();
+const char* CheckMeasureDrawn();
+const char* CheckPrefixUsage();
+const char* CheckBidi();
+const char* CheckLineBreaks();
+const char* CheckGlyphConvert();
+const char* CheckFTMemory();
+const char* CheckTelemetry();
+const char* CheckEngineText();
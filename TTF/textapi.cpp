@@ -0,0 +1,207 @@
+#include "textapi.h"
+#include "glyphcache.h"
+#include "log.h"
+#include "textcore.h"
+#include "textstats.h"
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The exports keep their undecorated names
+#ifdef _MSC_VER
+#define TTF_EXPORT(name) __pragma(comment(linker, "/EXPORT:" #name "=_" #name))
+#else
+#define TTF_EXPORT(name)
+#endif
+
+BatchRenderBackend g_batchBackend;
+void(*g_resolveFontFile)(std::string&, int&) = nullptr;
+bool(*g_hookFrameEnd)() = nullptr;
+void(*g_restoreRendererText)() = nullptr;
+
+// Fonts opened through TTF_GetFont by their resolved descriptor, they live as long as the process
+static std::unordered_map<std::string, TTFont*> g_apiFonts;
+
+// Text queued through TTF_DrawText, the characters of a frame share one buffer
+struct QueuedText
+{
+    TTFont* font;
+    int x;
+    int y;
+    uint32_t color;
+    size_t start;
+    int length;
+};
+static std::vector<QueuedText> g_queuedText;
+static std::string g_queuedChars;
+
+bool HasQueuedText()
+{
+    return !g_queuedText.empty();
+}
+
+void DrawQueuedText()
+{
+    g_textCounters.stateChanges += TEXT_SETUP_STATE_CHANGES;
+    g_renderBackend->BeginText();
+    for(const QueuedText& text : g_queuedText)
+    {
+        ++g_textCounters.drawCalls;
+        DrawGlyphs(text.font, text.x, text.y + text.font->ascent, static_cast<int>(text.font->scaler.height) / 4, 1000000.f,
+            GetGlyphColor(text.font, text.color), API_ENCODING, g_queuedChars.data() + text.start, text.length);
+    }
+    g_renderBackend->EndText();
+    g_queuedText.clear();
+    g_queuedChars.clear();
+}
+
+// Renderers that draw the text of a whole frame at once switch the plugin over to recording, see textbatch.h
+TTF_EXPORT(TTF_EnableTextBatching)
+extern "C" int __cdecl TTF_EnableTextBatching(uint32_t version)
+{
+    if(version != TTF_TEXT_BATCH_VERSION || !g_renderBackend)
+        return 0;
+    if(g_renderBackend == &g_batchBackend)
+        return 1;
+
+    // Glyphs on device textures get created again in system memory the next time they are drawn
+    for(TTFont* ttFont : g_fonts)
+        ReleaseGlyphs(ttFont);
+    g_renderBackend = &g_batchBackend;
+
+    // The renderer draws the text itself now so its own BlitText and Print hooks can come back
+    if(g_restoreRendererText)
+        g_restoreRendererText();
+    LogMessage("Text batching enabled by the renderer");
+    return 1;
+}
+
+TTF_EXPORT(TTF_GetTextFrame)
+extern "C" int __cdecl TTF_GetTextFrame(TTF_TextFrame* frame)
+{
+    if(!frame || g_renderBackend != &g_batchBackend)
+        return 0;
+
+    g_batchBackend.GetFrame(g_textFrame, *frame);
+    return 1;
+}
+
+static_assert(sizeof(TTF_TextLine) == sizeof(TextLine), "TTF_TextLine has to match TextLine");
+
+// Handles that aren't fonts of the plugin are turned away instead of crashing the game
+static TTFont* GetApiFont(TTF_Font* font)
+{
+    TTFont* ttFont = reinterpret_cast<TTFont*>(font);
+    return (ttFont && g_fonts.find(ttFont) != g_fonts.end() ? ttFont : nullptr);
+}
+
+static int GetApiTextLength(const char* text, int32_t length)
+{
+    return (length < 0 ? static_cast<int>(strlen(text)) : length);
+}
+
+TTF_EXPORT(TTF_GetApiVersion)
+extern "C" uint32_t __cdecl TTF_GetApiVersion()
+{
+    return TTF_API_VERSION;
+}
+
+TTF_EXPORT(TTF_GetFont)
+extern "C" TTF_Font* __cdecl TTF_GetFont(const char* descriptor)
+{
+    std::string fontName(descriptor ? descriptor : "");
+    if(fontName.empty() || !ResolveFontDescriptor(fontName))
+        return nullptr;
+
+    auto it = g_apiFonts.find(fontName);
+    if(it == g_apiFonts.end())
+    {
+        TTFont* ttFont = LoadFont(fontName, g_resolveFontFile);
+        if(!ttFont)
+            return nullptr;
+        it = g_apiFonts.emplace(fontName, ttFont).first;
+    }
+    return reinterpret_cast<TTF_Font*>(it->second);
+}
+
+TTF_EXPORT(TTF_GetFontMetrics)
+extern "C" int __cdecl TTF_GetFontMetrics(TTF_Font* font, TTF_FontMetrics* metrics)
+{
+    TTFont* ttFont = GetApiFont(font);
+    if(!ttFont || !metrics)
+        return 0;
+
+    metrics->size = static_cast<int32_t>(ttFont->scaler.height);
+    metrics->height = ttFont->height;
+    metrics->ascent = ttFont->ascent;
+    metrics->descent = ttFont->descent;
+    return 1;
+}
+
+TTF_EXPORT(TTF_MeasureText)
+extern "C" int32_t __cdecl TTF_MeasureText(TTF_Font* font, const char* text, int32_t length)
+{
+    TTFont* ttFont = GetApiFont(font);
+    if(!ttFont || !text)
+        return 0;
+
+    ++g_textCounters.measureCalls;
+    return MeasureGlyphs(ttFont, static_cast<int>(ttFont->scaler.height) / 4, API_ENCODING, text, GetApiTextLength(text, length));
+}
+
+// Text being wrapped when its lines draw composed or shaped
+struct ApiLayoutText
+{
+    TTFont* font;
+    const char* text;
+};
+
+static int MeasureApiLine(const void* context, int start, int end)
+{
+    const ApiLayoutText& layout = *static_cast<const ApiLayoutText*>(context);
+    return MeasureGlyphs(layout.font, static_cast<int>(layout.font->scaler.height) / 4, API_ENCODING, layout.text + start, end - start);
+}
+
+TTF_EXPORT(TTF_LayoutText)
+extern "C" int32_t __cdecl TTF_LayoutText(TTF_Font* font, const char* text, int32_t length, int32_t maxWidth, TTF_TextLine* lines, int32_t maxLines)
+{
+    TTFont* ttFont = GetApiFont(font);
+    if(!ttFont || !text)
+        return 0;
+
+    static TextParagraph paragraph;
+    static std::vector<TextLine> wrapped;
+    ++g_textCounters.measureCalls;
+    // Lines get the widths TTF_MeasureText gives them, measured as drawn when the bidi cache changes the text
+    int len = GetApiTextLength(text, length);
+    ApiLayoutText layout = {ttFont, text};
+    bool measureLines = g_bidiCache.IsNeeded(API_ENCODING, text, len);
+    WrapText(API_ENCODING, text, len, static_cast<int>(ttFont->scaler.height) / 4, maxWidth, [ttFont](uint32_t utf32)
+    {
+        return GetGlyphAdvance(ttFont, utf32);
+    }, paragraph, wrapped, measureLines ? &MeasureApiLine : nullptr, &layout);
+    if(lines && maxLines > 0)
+        memcpy(lines, wrapped.data(), std::min(wrapped.size(), static_cast<size_t>(maxLines)) * sizeof(TTF_TextLine));
+    return static_cast<int32_t>(wrapped.size());
+}
+
+TTF_EXPORT(TTF_DrawText)
+extern "C" int __cdecl TTF_DrawText(TTF_Font* font, int32_t x, int32_t y, uint32_t color, const char* text, int32_t length)
+{
+    TTFont* ttFont = GetApiFont(font);
+    if(!ttFont || !text || !g_renderBackend)
+        return 0;
+
+    // Tools without a game draw the queue themselves
+    if(g_hookFrameEnd && !g_hookFrameEnd())
+        return 0;
+
+    int len = GetApiTextLength(text, length);
+    g_queuedText.push_back({ttFont, x, y, color, g_queuedChars.size(), len});
+    g_queuedChars.append(text, static_cast<size_t>(len));
+    return 1;
+}
+
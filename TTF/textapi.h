@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+#include "textbatch.h"
+#include "ttfapi.h"
+
+// Text coming through the public API is always UTF-8, DecodeCharacter treats anything but a code page that way
+#define API_ENCODING 0
+
+extern BatchRenderBackend g_batchBackend;
+// Set by the plugin, tools leave them empty: turns descriptor files into paths below the game's font directory,
+// hooks the end of the frame the queued text gets drawn at and puts back the renderer's own text functions once it batches
+extern void(*g_resolveFontFile)(std::string&, int&);
+extern bool(*g_hookFrameEnd)();
+extern void(*g_restoreRendererText)();
+
+bool HasQueuedText();
+void DrawQueuedText();
+
+extern "C" {
+int __cdecl TTF_EnableTextBatching(uint32_t version);
+int __cdecl TTF_GetTextFrame(TTF_TextFrame* frame);
+uint32_t __cdecl TTF_GetApiVersion();
+TTF_Font* __cdecl TTF_GetFont(const char* descriptor);
+int __cdecl TTF_GetFontMetrics(TTF_Font* font, TTF_FontMetrics* metrics);
+int32_t __cdecl TTF_MeasureText(TTF_Font* font, const char* text, int32_t length);
+int32_t __cdecl TTF_LayoutText(TTF_Font* font, const char* text, int32_t length, int32_t maxWidth, TTF_TextLine* lines, int32_t maxLines);
+int __cdecl TTF_DrawText(TTF_Font* font, int32_t x, int32_t y, uint32_t color, const char* text, int32_t length);
+}
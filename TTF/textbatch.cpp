@@ -0,0 +1,111 @@
+#include "textbatch.h"
+
+#include <algorithm>
+
+static_assert(sizeof(TTF_TextVertex) == sizeof(TextVertex), "TTF_TextVertex has to match TextVertex");
+
+bool BatchRenderBackend::LockPage(GlyphPage page, const AtlasRect* rect, bool readOnly, GlyphPageLock& lock)
+{
+    if(!HeadlessRenderBackend::LockPage(page, rect, readOnly, lock))
+        return false;
+    if(readOnly)
+        return true;
+
+    const Page* batchPage = static_cast<const Page*>(page);
+    AtlasRect dirty = (rect ? *rect : AtlasRect{0, 0, batchPage->width, batchPage->height});
+    auto it = m_updateIndex.find(page);
+    if(it == m_updateIndex.end())
+    {
+        m_updateIndex.emplace(page, m_updates.size());
+        TTF_TextPageUpdate update = {};
+        update.page = page;
+        update.pageWidth = batchPage->width;
+        update.pageHeight = batchPage->height;
+        update.format = static_cast<uint32_t>(batchPage->format);
+        update.x = dirty.x;
+        update.y = dirty.y;
+        update.width = dirty.width;
+        update.height = dirty.height;
+        m_updates.push_back(update);
+        return true;
+    }
+
+    // One rectangle per page and frame, glyphs uploaded in the same frame mostly sit next to each other on a shelf
+    TTF_TextPageUpdate& update = m_updates[it->second];
+    uint32_t right = std::max(update.x + update.width, dirty.x + dirty.width);
+    uint32_t bottom = std::max(update.y + update.height, dirty.y + dirty.height);
+    update.x = std::min(update.x, dirty.x);
+    update.y = std::min(update.y, dirty.y);
+    update.width = right - update.x;
+    update.height = bottom - update.y;
+    return true;
+}
+
+void BatchRenderBackend::ReleasePage(GlyphPage page)
+{
+    // Nothing recorded for the page may outlive it
+    auto it = m_updateIndex.find(page);
+    if(it != m_updateIndex.end())
+    {
+        size_t index = it->second;
+        m_updateIndex.erase(it);
+        if(index != m_updates.size() - 1)
+        {
+            m_updates[index] = m_updates.back();
+            m_updateIndex[const_cast<void*>(m_updates[index].page)] = index;
+        }
+        m_updates.pop_back();
+    }
+    m_batches.erase(std::remove_if(m_batches.begin(), m_batches.end(), [page](const TTF_TextBatch& batch)
+    {
+        return batch.page == page;
+    }), m_batches.end());
+
+    m_released.push_back(page);
+    HeadlessRenderBackend::ReleasePage(page);
+}
+
+void BatchRenderBackend::DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads)
+{
+    HeadlessRenderBackend::DrawQuads(page, vertices, quads);
+
+    uint32_t firstQuad = static_cast<uint32_t>(m_vertices.size() / 4);
+    m_vertices.insert(m_vertices.end(), vertices, vertices + quads * 4);
+    // Strings drawn back to back on the same page end up in one batch
+    if(!m_batches.empty() && m_batches.back().page == page && m_batches.back().firstQuad + m_batches.back().quads == firstQuad)
+        m_batches.back().quads += static_cast<uint32_t>(quads);
+    else
+        m_batches.push_back({page, firstQuad, static_cast<uint32_t>(quads)});
+}
+
+void BatchRenderBackend::GetFrame(uint32_t frameNumber, TTF_TextFrame& frame)
+{
+    for(TTF_TextPageUpdate& update : m_updates)
+    {
+        const Page* batchPage = static_cast<const Page*>(update.page);
+        unsigned int texelSize = GetGlyphTexelSize(batchPage->format);
+        update.pitch = static_cast<int32_t>(batchPage->width * texelSize);
+        update.texels = batchPage->texels.data() + update.y * update.pitch + update.x * texelSize;
+    }
+
+    m_frameVertices.swap(m_vertices);
+    m_frameBatches.swap(m_batches);
+    m_frameUpdates.swap(m_updates);
+    m_frameReleased.swap(m_released);
+    m_vertices.clear();
+    m_batches.clear();
+    m_updates.clear();
+    m_updateIndex.clear();
+    m_released.clear();
+
+    frame.version = TTF_TEXT_BATCH_VERSION;
+    frame.frame = frameNumber;
+    frame.vertices = reinterpret_cast<const TTF_TextVertex*>(m_frameVertices.data());
+    frame.quadCount = static_cast<uint32_t>(m_frameVertices.size() / 4);
+    frame.batches = m_frameBatches.data();
+    frame.batchCount = static_cast<uint32_t>(m_frameBatches.size());
+    frame.updates = m_frameUpdates.data();
+    frame.updateCount = static_cast<uint32_t>(m_frameUpdates.size());
+    frame.releasedPages = m_frameReleased.data();
+    frame.releasedCount = static_cast<uint32_t>(m_frameReleased.size());
+}
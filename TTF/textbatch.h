@@ -0,0 +1,109 @@
+#pragma once
+#include <stdint.h>
+
+// Exported C API for renderers that want to draw the text of a whole frame themselves instead of getting one
+// DrawPrimitive call per glyph. A renderer calls TTF_EnableTextBatching once, from then on the glyph textures stay
+// in system memory and every text draw call is recorded, TTF_GetTextFrame hands out everything recorded since
+// the previous call. Both functions have to be called on the thread the game draws text on.
+// Pages are opaque handles, a renderer creates its own texture the first time a page shows up in an update and
+// drops it once the page shows up in the released list. Releases come before updates within a frame so a handle
+// that gets reused by a new page is released first and updated after.
+#define TTF_TEXT_BATCH_VERSION 1
+
+// Only the Windows build exports the functions, the headless tools build the same code elsewhere
+#if !defined(_WIN32) && !defined(__cdecl)
+#define __cdecl
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Same layout as D3DTLVERTEX, quads are 4 vertices drawn as a triangle fan
+typedef struct TTF_TextVertex
+{
+    float sx;
+    float sy;
+    float sz;
+    float rhw;
+    uint32_t color;
+    uint32_t specular;
+    float tu;
+    float tv;
+} TTF_TextVertex;
+
+// Consecutive quads drawn with the same page
+typedef struct TTF_TextBatch
+{
+    const void* page;
+    uint32_t firstQuad;
+    uint32_t quads;
+} TTF_TextBatch;
+
+// Format is 0 for BGRA8888 and 1 for A8L8, texels points at the first texel of the dirty rectangle
+typedef struct TTF_TextPageUpdate
+{
+    const void* page;
+    uint32_t pageWidth;
+    uint32_t pageHeight;
+    uint32_t format;
+    uint32_t x, y;
+    uint32_t width, height;
+    const unsigned char* texels;
+    int32_t pitch;
+} TTF_TextPageUpdate;
+
+// Everything stays valid until the next TTF_GetTextFrame call
+typedef struct TTF_TextFrame
+{
+    uint32_t version;
+    uint32_t frame;
+    const TTF_TextVertex* vertices;
+    uint32_t quadCount;
+    const TTF_TextBatch* batches;
+    uint32_t batchCount;
+    const TTF_TextPageUpdate* updates;
+    uint32_t updateCount;
+    const void* const* releasedPages;
+    uint32_t releasedCount;
+} TTF_TextFrame;
+
+// Returns 0 when the plugin doesn't support the version, glyphs cached before the call get created again
+typedef int(__cdecl* TTF_EnableTextBatchingFunc)(uint32_t version);
+typedef int(__cdecl* TTF_GetTextFrameFunc)(TTF_TextFrame* frame);
+
+#ifdef __cplusplus
+}
+
+#include <unordered_map>
+#include <vector>
+
+#include "renderbackend.h"
+
+// Records instead of drawing, pages live in system memory and written rectangles are merged per page and frame
+class BatchRenderBackend : public HeadlessRenderBackend
+{
+    public:
+        BatchRenderBackend() = default;
+
+        bool LockPage(GlyphPage page, const AtlasRect* rect, bool readOnly, GlyphPageLock& lock) override;
+        void ReleasePage(GlyphPage page) override;
+        void DrawQuads(GlyphPage page, const TextVertex* vertices, size_t quads) override;
+
+        // Publishes the recorded frame and starts recording the next one
+        void GetFrame(uint32_t frameNumber, TTF_TextFrame& frame);
+
+    private:
+        std::vector<TextVertex> m_vertices;
+        std::vector<TTF_TextBatch> m_batches;
+        std::vector<TTF_TextPageUpdate> m_updates;
+        std::unordered_map<GlyphPage, size_t> m_updateIndex;
+        std::vector<const void*> m_released;
+
+        // What the last GetFrame handed out
+        std::vector<TextVertex> m_frameVertices;
+        std::vector<TTF_TextBatch> m_frameBatches;
+        std::vector<TTF_TextPageUpdate> m_frameUpdates;
+        std::vector<const void*> m_frameReleased;
+};
+#endif
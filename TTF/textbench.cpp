@@ -0,0 +1,370 @@
+#include "textbench.h"
+#include "alloctracker.h"
+#include "bidi.h"
+#include "compose.h"
+#include "textcorpus.h"
+#include "textcore.h"
+#include "textstats.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+struct BenchResult
+{
+    size_t bytes = 0;
+    size_t characters = 0;
+    size_t glyphs = 0;
+    uint32_t checksum = 2166136261u;
+    double decodeMs = 0.0;
+    double measureMs = 0.0;
+    double layoutMs = 0.0;
+    uint64_t decodeAllocs = 0;
+    uint64_t measureAllocs = 0;
+    uint64_t layoutAllocs = 0;
+};
+
+// Stand-in for the glyph cache of GetFontX, every lookup hits like it does in a warmed up game
+typedef std::unordered_map<uint32_t, int> AdvanceMap;
+
+static void PrepareSlice(const CorpusSlice& slice, AdvanceMap& advances, BenchResult& result)
+{
+    for(const std::string& line : slice.lines)
+    {
+        for(char character : line)
+            result.checksum = (result.checksum ^ static_cast<unsigned char>(character)) * 16777619u;
+        result.bytes += line.length();
+
+        for(int i = 0, len = static_cast<int>(line.length()); i < len;)
+        {
+            int utf8size;
+            uint32_t utf32 = DecodeCharacter(slice.encoding, line.c_str() + i, len - i, utf8size);
+            i += utf8size;
+            ++result.characters;
+            if(utf32 > 32)
+            {
+                advances.emplace(utf32, 6 + static_cast<int>(utf32 % 9));
+                ++result.glyphs;
+            }
+        }
+    }
+}
+
+static uint32_t DecodeSlice(const CorpusSlice& slice)
+{
+    uint32_t sum = 0;
+    for(const std::string& line : slice.lines)
+    {
+        for(int i = 0, len = static_cast<int>(line.length()); i < len;)
+        {
+            int utf8size;
+            sum += DecodeCharacter(slice.encoding, line.c_str() + i, len - i, utf8size);
+            i += utf8size;
+        }
+    }
+    return sum;
+}
+
+static int MeasureSlice(const CorpusSlice& slice, const AdvanceMap& advances)
+{
+    int width = 0;
+    for(const std::string& line : slice.lines)
+    {
+        width += MeasureText(slice.encoding, line.c_str(), static_cast<int>(line.length()), 5, [&advances](uint32_t utf32)
+        {
+            return advances.find(utf32)->second;
+        });
+    }
+    return width;
+}
+
+static float LayoutSlice(const CorpusSlice& slice, const AdvanceMap& advances, std::vector<TextVertex>& vertices)
+{
+    float sum = 0.f;
+    for(const std::string& line : slice.lines)
+    {
+        vertices.clear();
+        int x = 0;
+        for(int i = 0, len = static_cast<int>(line.length()); i < len;)
+        {
+            int utf8size;
+            uint32_t utf32 = DecodeCharacter(slice.encoding, line.c_str() + i, len - i, utf8size);
+            i += utf8size;
+            if(utf32 <= 32)
+            {
+                x += 5;
+                continue;
+            }
+
+            int advance = advances.find(utf32)->second;
+            GlyphQuad quad;
+            BuildGlyphQuad(x, 16, static_cast<unsigned int>(advance), 16, 0, 12, 0.f, 1.f, 0.f, 1.f, true, quad);
+
+            size_t first = vertices.size();
+            vertices.resize(first + 4);
+            BuildGlyphVertices(quad, 0xFFFFFFFF, &vertices[first]);
+            x += advance;
+        }
+        if(!vertices.empty())
+            sum += vertices.back().sx;
+    }
+    return sum;
+}
+
+// Best of all iterations, the minimum is the least noisy estimate
+template<typename Work>
+static double TimeBest(int iterations, Work work)
+{
+    double best = 0.0;
+    for(int i = 0; i < iterations; ++i)
+    {
+        int64_t start = TextStatsTimestamp();
+        work();
+        double elapsed = TextStatsTicksToMs(TextStatsTimestamp() - start);
+        if(i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+// Heap allocations of one more run once the timed ones warmed up every buffer
+template<typename Work>
+static uint64_t CountAllocations(Work work)
+{
+    uint64_t start = GetHeapAllocations();
+    work();
+    return GetHeapAllocations() - start;
+}
+
+static double PerSecond(double count, double ms)
+{
+    return (ms > 0.0 ? count * 1000.0 / ms : 0.0);
+}
+
+bool RunTextBenchmark(const char* outputPath, size_t linesPerSlice, int iterations)
+{
+    FILE* f = fopen(outputPath, "w");
+    if(!f)
+        return false;
+
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(linesPerSlice, slices);
+
+    fprintf(f, "slice,encoding,lines,bytes,characters,checksum,decode_mb_s,decode_mchars_s,measure_strings_s,layout_glyphs_s,decode_allocs,measure_allocs,layout_allocs\n");
+
+    volatile uint32_t sink = 0;
+    std::vector<TextVertex> vertices;
+    for(const CorpusSlice& slice : slices)
+    {
+        AdvanceMap advances;
+        BenchResult result;
+        PrepareSlice(slice, advances, result);
+
+        result.decodeMs = TimeBest(iterations, [&]() {sink += DecodeSlice(slice);});
+        result.measureMs = TimeBest(iterations, [&]() {sink += static_cast<uint32_t>(MeasureSlice(slice, advances));});
+        result.layoutMs = TimeBest(iterations, [&]() {sink += static_cast<uint32_t>(LayoutSlice(slice, advances, vertices));});
+        result.decodeAllocs = CountAllocations([&]() {sink += DecodeSlice(slice);});
+        result.measureAllocs = CountAllocations([&]() {sink += static_cast<uint32_t>(MeasureSlice(slice, advances));});
+        result.layoutAllocs = CountAllocations([&]() {sink += static_cast<uint32_t>(LayoutSlice(slice, advances, vertices));});
+
+        fprintf(f, "%s,%d,%u,%u,%u,%08X,%.2f,%.2f,%.0f,%.0f,", slice.name.c_str(), slice.encoding, static_cast<unsigned int>(slice.lines.size()),
+            static_cast<unsigned int>(result.bytes), static_cast<unsigned int>(result.characters), result.checksum,
+            PerSecond(static_cast<double>(result.bytes) / (1024.0 * 1024.0), result.decodeMs), PerSecond(result.characters / 1000000.0, result.decodeMs),
+            PerSecond(static_cast<double>(slice.lines.size()), result.measureMs), PerSecond(static_cast<double>(result.glyphs), result.layoutMs));
+        // Left empty by builds that don't count allocations
+        if(TTF_ALLOC_TRACKING_ENABLED)
+            fprintf(f, "%llu,%llu,%llu", static_cast<unsigned long long>(result.decodeAllocs),
+                static_cast<unsigned long long>(result.measureAllocs), static_cast<unsigned long long>(result.layoutAllocs));
+        fprintf(f, "\n");
+    }
+
+    fclose(f);
+    return true;
+}
+
+// Corpus lines per paragraph, enough for a long dialog or a book page
+#define WRAP_PARAGRAPH_LINES 16
+#define WRAP_WIDTH 1200
+
+// Stand-in for the engine's word wrap, words are split at spaces only so text without spaces stays on one line
+template<typename Measure>
+static size_t EngineWrapParagraph(const std::string& paragraph, std::string& line, Measure measure)
+{
+    size_t lines = 1;
+    line.clear();
+    for(size_t wordStart = 0; wordStart < paragraph.length();)
+    {
+        size_t wordEnd = paragraph.find(' ', wordStart);
+        if(wordEnd == std::string::npos)
+            wordEnd = paragraph.length();
+
+        size_t lineLength = line.length();
+        if(lineLength > 0)
+            line.push_back(' ');
+        line.append(paragraph, wordStart, wordEnd - wordStart);
+        if(lineLength > 0 && measure(line) > WRAP_WIDTH)
+        {
+            line.erase(0, lineLength + 1);
+            ++lines;
+        }
+        wordStart = wordEnd + 1;
+    }
+    return lines;
+}
+
+bool RunWrapBenchmark(const char* outputPath, size_t linesPerSlice, int iterations)
+{
+    FILE* f = fopen(outputPath, "w");
+    if(!f)
+        return false;
+
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(linesPerSlice, slices);
+
+    fprintf(f, "slice,encoding,paragraphs,characters,engine_lines,wrap_lines,engine_ms,engine_prefix_ms,wrap_ms\n");
+
+    volatile size_t sink = 0;
+    std::string line;
+    PrefixMeasure prefixMeasure;
+    TextParagraph textParagraph;
+    std::vector<TextLine> lines;
+    for(const CorpusSlice& slice : slices)
+    {
+        if(slice.kind != Corpus_Dialog)
+            continue;
+
+        AdvanceMap advances;
+        BenchResult result;
+        PrepareSlice(slice, advances, result);
+        auto getAdvance = [&advances](uint32_t utf32)
+        {
+            return advances.find(utf32)->second;
+        };
+
+        std::vector<std::string> paragraphs;
+        for(size_t i = 0; i < slice.lines.size(); ++i)
+        {
+            if(i % WRAP_PARAGRAPH_LINES == 0)
+                paragraphs.emplace_back();
+            else
+                paragraphs.back().push_back(' ');
+            paragraphs.back().append(slice.lines[i]);
+        }
+
+        size_t engineLines = 0, wrapLines = 0;
+        auto engineWrap = [&]()
+        {
+            engineLines = 0;
+            for(const std::string& paragraph : paragraphs)
+            {
+                engineLines += EngineWrapParagraph(paragraph, line, [&](const std::string& text)
+                {
+                    return MeasureText(slice.encoding, text.c_str(), static_cast<int>(text.length()), 5, getAdvance);
+                });
+            }
+            sink += engineLines;
+        };
+        auto prefixWrap = [&]()
+        {
+            size_t count = 0;
+            for(const std::string& paragraph : paragraphs)
+            {
+                count += EngineWrapParagraph(paragraph, line, [&](const std::string& text)
+                {
+                    return prefixMeasure.Measure(1, slice.encoding, text.c_str(), static_cast<int>(text.length()), 5, getAdvance);
+                });
+            }
+            sink += count;
+        };
+        auto breakWrap = [&]()
+        {
+            wrapLines = 0;
+            for(const std::string& paragraph : paragraphs)
+            {
+                WrapText(slice.encoding, paragraph.c_str(), static_cast<int>(paragraph.length()), 5, WRAP_WIDTH, getAdvance, textParagraph, lines);
+                wrapLines += lines.size();
+            }
+            sink += wrapLines;
+        };
+
+        double engineMs = TimeBest(iterations, engineWrap);
+        double prefixMs = TimeBest(iterations, prefixWrap);
+        double wrapMs = TimeBest(iterations, breakWrap);
+        fprintf(f, "%s,%d,%u,%u,%u,%u,%.3f,%.3f,%.3f\n", slice.name.c_str(), slice.encoding, static_cast<unsigned int>(paragraphs.size()),
+            static_cast<unsigned int>(result.characters), static_cast<unsigned int>(engineLines), static_cast<unsigned int>(wrapLines), engineMs, prefixMs, wrapMs);
+    }
+
+    fclose(f);
+    return true;
+}
+
+bool RunComposeBenchmark(const char* outputPath, size_t linesPerSlice, int iterations)
+{
+    FILE* f = fopen(outputPath, "w");
+    if(!f)
+        return false;
+
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(linesPerSlice, slices);
+
+    fprintf(f, "slice,encoding,lines,glyphs_per_line,composed_glyphs_per_line,compose_ms,cached_ms\n");
+
+    volatile size_t sink = 0;
+    std::vector<uint32_t> logical, composed;
+    auto hasCharacter = [](uint32_t) {return true;};
+    for(const CorpusSlice& slice : slices)
+    {
+        bool marks = false;
+        for(const std::string& line : slice.lines)
+            marks = (marks || MayNeedComposition(slice.encoding, line.c_str(), static_cast<int>(line.length())));
+        if(!marks)
+            continue;
+
+        // Only the composition pass so the glyph counts and timings aren't mixed with shaping and reordering
+        BidiCache cache(slice.lines.size());
+        cache.SetShaping(false);
+        cache.SetReordering(false);
+
+        size_t glyphs = 0, composedGlyphs = 0;
+        for(const std::string& line : slice.lines)
+        {
+            for(int i = 0, len = static_cast<int>(line.length()); i < len;)
+            {
+                int utf8size;
+                glyphs += (DecodeCharacter(slice.encoding, line.c_str() + i, len - i, utf8size) > 32 ? 1 : 0);
+                i += utf8size;
+            }
+            for(uint32_t utf32 : cache.Reorder(slice.encoding, line.c_str(), static_cast<int>(line.length())))
+                composedGlyphs += (utf32 > 32 ? 1 : 0);
+        }
+
+        double composeMs = TimeBest(iterations, [&]()
+        {
+            for(const std::string& line : slice.lines)
+            {
+                logical.clear();
+                for(int i = 0, len = static_cast<int>(line.length()); i < len;)
+                {
+                    int utf8size;
+                    logical.push_back(DecodeCharacter(slice.encoding, line.c_str() + i, len - i, utf8size));
+                    i += utf8size;
+                }
+                ComposeCharacters(logical.data(), logical.size(), composed, hasCharacter);
+                sink += composed.size();
+            }
+        });
+        double cachedMs = TimeBest(iterations, [&]()
+        {
+            for(const std::string& line : slice.lines)
+                sink += cache.Reorder(slice.encoding, line.c_str(), static_cast<int>(line.length())).size();
+        });
+
+        double lines = static_cast<double>(slice.lines.size());
+        fprintf(f, "%s,%d,%u,%.2f,%.2f,%.3f,%.3f\n", slice.name.c_str(), slice.encoding, static_cast<unsigned int>(slice.lines.size()),
+            glyphs / lines, composedGlyphs / lines, composeMs, cachedMs);
+    }
+
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <stddef.h>
+
+// Measures decode, measure and layout throughput of the text core on every corpus slice
+// Results are written as CSV with a fixed column order, the checksum column changes only when the corpus does
+// The allocation columns are only filled by builds with TTF_ALLOC_TRACKING and should read zero
+bool RunTextBenchmark(const char* outputPath, size_t linesPerSlice, int iterations);
+
+// Wraps long paragraphs built from the dialog slices the way the engine does, adding a word to the line and measuring
+// the whole line again, once measuring every string from scratch, once through PrefixMeasure and once with WrapText
+bool RunWrapBenchmark(const char* outputPath, size_t linesPerSlice, int iterations);
+
+// Glyphs drawn per line before and after folding the combining marks into precomposed letters on every slice that has marks,
+// with the cost of composing each line and of looking the composed line up in the cache the way DrawGlyphs does
+bool RunComposeBenchmark(const char* outputPath, size_t linesPerSlice, int iterations);
@@ -0,0 +1,254 @@
+#include "textcore.h"
+#include "codepages.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+uint32_t DecodeCharacter(int encoding, const char* text, int textlen, int& utf8size)
+{
+    switch(encoding)
+    {
+        case 1258: utf8size = 1; return static_cast<uint32_t>(CodePage1258[static_cast<unsigned char>(text[0])]);
+        case 1257: utf8size = 1; return static_cast<uint32_t>(CodePage1257[static_cast<unsigned char>(text[0])]);
+        case 1256: utf8size = 1; return static_cast<uint32_t>(CodePage1256[static_cast<unsigned char>(text[0])]);
+        case 1255: utf8size = 1; return static_cast<uint32_t>(CodePage1255[static_cast<unsigned char>(text[0])]);
+        case 1254: utf8size = 1; return static_cast<uint32_t>(CodePage1254[static_cast<unsigned char>(text[0])]);
+        case 1253: utf8size = 1; return static_cast<uint32_t>(CodePage1253[static_cast<unsigned char>(text[0])]);
+        case 1252: utf8size = 1; return static_cast<uint32_t>(CodePage1252[static_cast<unsigned char>(text[0])]);
+        case 1251: utf8size = 1; return static_cast<uint32_t>(CodePage1251[static_cast<unsigned char>(text[0])]);
+        case 1250: utf8size = 1; return static_cast<uint32_t>(CodePage1250[static_cast<unsigned char>(text[0])]);
+        default: break;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(text);
+    size_t left = 0;
+    int save_textlen = textlen;
+    bool underflow = false;
+    uint32_t ch = UNKNOWN_UNICODE;
+    if(p[0] >= 0xFC)
+    {
+        if((p[0] & 0xFE) == 0xFC)
+        {
+            ch = static_cast<uint32_t>(p[0] & 0x01);
+            left = 5;
+        }
+    }
+    else if(p[0] >= 0xF8)
+    {
+        if((p[0] & 0xFC) == 0xF8)
+        {
+            ch = static_cast<uint32_t>(p[0] & 0x03);
+            left = 4;
+        }
+    }
+    else if(p[0] >= 0xF0)
+    {
+        if((p[0] & 0xF8) == 0xF0)
+        {
+            ch = static_cast<uint32_t>(p[0] & 0x07);
+            left = 3;
+        }
+    }
+    else if(p[0] >= 0xE0)
+    {
+        if((p[0] & 0xF0) == 0xE0)
+        {
+            ch = static_cast<uint32_t>(p[0] & 0x0F);
+            left = 2;
+        }
+    }
+    else if(p[0] >= 0xC0)
+    {
+        if((p[0] & 0xE0) == 0xC0)
+        {
+            ch = static_cast<uint32_t>(p[0] & 0x1F);
+            left = 1;
+        }
+    }
+    else
+    {
+        if((p[0] & 0x80) == 0x00)
+            ch = static_cast<uint32_t>(p[0]);
+    }
+
+    --textlen;
+    while(left > 0 && textlen > 0)
+    {
+        ++p;
+        if((p[0] & 0xC0) != 0x80)
+        {
+            ch = UNKNOWN_UNICODE;
+            break;
+        }
+        ch <<= 6;
+        ch |= (p[0] & 0x3F);
+        --textlen;
+        --left;
+    }
+
+    if(left > 0) underflow = true;
+    if(underflow ||
+        (ch >= 0xD800 && ch <= 0xDFFF) ||
+        (ch == 0xFFFE || ch == 0xFFFF) || ch > 0x10FFFF)
+    {
+        ch = UNKNOWN_UNICODE;
+    }
+
+    utf8size = (save_textlen - textlen);
+    return ch;
+}
+
+bool EncodeCharacter(int encoding, uint32_t utf32, char& character)
+{
+    const unsigned int* codePage;
+    switch(encoding)
+    {
+        case 1258: codePage = CodePage1258; break;
+        case 1257: codePage = CodePage1257; break;
+        case 1256: codePage = CodePage1256; break;
+        case 1255: codePage = CodePage1255; break;
+        case 1254: codePage = CodePage1254; break;
+        case 1253: codePage = CodePage1253; break;
+        case 1252: codePage = CodePage1252; break;
+        case 1251: codePage = CodePage1251; break;
+        case 1250: codePage = CodePage1250; break;
+        default: return false;
+    }
+
+    // Unassigned bytes decode to the replacement character
+    if(utf32 == UNKNOWN_UNICODE)
+        return false;
+
+    for(int i = 0; i < 256; ++i)
+    {
+        if(codePage[i] == utf32)
+        {
+            character = static_cast<char>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void ReadFontDetail(const std::string& lhLine, const std::string& rhLine, int& fontSize, int& fontRed, int& fontGreen, int& fontBlue, int& fontAlpha)
+{
+    if(lhLine == "SIZE")
+    {
+        try {fontSize = std::stol(rhLine);}
+        catch(const std::exception&) {fontSize = 20;}
+    }
+    else if(lhLine == "R" || lhLine == "RED")
+    {
+        try {fontRed = std::stol(rhLine);}
+        catch(const std::exception&) {fontRed = 255;}
+    }
+    else if(lhLine == "G" || lhLine == "GREEN")
+    {
+        try {fontGreen = std::stol(rhLine);}
+        catch(const std::exception&) {fontGreen = 255;}
+    }
+    else if(lhLine == "B" || lhLine == "BLUE")
+    {
+        try {fontBlue = std::stol(rhLine);}
+        catch(const std::exception&) {fontBlue = 255;}
+    }
+    else if(lhLine == "A" || lhLine == "ALPHA")
+    {
+        try {fontAlpha = std::stol(rhLine);}
+        catch(const std::exception&) {fontAlpha = 255;}
+    }
+}
+
+void ReadFontDetails(const std::string& fontStr, std::string& fontName, int& fontSize, int& fontRed, int& fontGreen, int& fontBlue, int& fontAlpha)
+{
+    size_t pos = 0, start = 0;
+    while((pos = fontStr.find(':', pos)) != std::string::npos)
+    {
+        std::size_t eqpos;
+        std::string elem = fontStr.substr(start, pos - start);
+        if((eqpos = elem.find("=")) != std::string::npos)
+        {
+            std::transform(elem.begin(), elem.end(), elem.begin(), toupper);
+
+            std::string lhLine = elem.substr(0, eqpos);
+            std::string rhLine = elem.substr(eqpos + 1);
+            lhLine.erase(lhLine.find_last_not_of(' ') + 1);
+            lhLine.erase(0, lhLine.find_first_not_of(' '));
+            rhLine.erase(rhLine.find_last_not_of(' ') + 1);
+            rhLine.erase(0, rhLine.find_first_not_of(' '));
+            ReadFontDetail(lhLine, rhLine, fontSize, fontRed, fontGreen, fontBlue, fontAlpha);
+        }
+        else
+            fontName = elem;
+
+        start = ++pos;
+    }
+
+    pos = fontStr.length();
+    if(start >= pos)
+        return;
+
+    std::size_t eqpos;
+    std::string elem = fontStr.substr(start, pos - start);
+    if((eqpos = elem.find("=")) != std::string::npos)
+    {
+        std::transform(elem.begin(), elem.end(), elem.begin(), toupper);
+
+        std::string lhLine = elem.substr(0, eqpos);
+        std::string rhLine = elem.substr(eqpos + 1);
+        lhLine.erase(lhLine.find_last_not_of(' ') + 1);
+        lhLine.erase(0, lhLine.find_first_not_of(' '));
+        rhLine.erase(rhLine.find_last_not_of(' ') + 1);
+        rhLine.erase(0, rhLine.find_first_not_of(' '));
+        ReadFontDetail(lhLine, rhLine, fontSize, fontRed, fontGreen, fontBlue, fontAlpha);
+    }
+    else
+        fontName = elem;
+}
+
+void BuildGlyphQuad(int x, int baseline, unsigned int width, unsigned int rows, int left, int top, float u0, float u1, float v0, float v1, bool halfPixelOffset, GlyphQuad& quad)
+{
+    quad.minx = static_cast<float>(x) + left;
+    quad.miny = static_cast<float>(baseline) - top;
+    if(halfPixelOffset)
+    {
+        quad.minx -= 0.5f;
+        quad.miny -= 0.5f;
+    }
+    quad.maxx = quad.minx + width;
+    quad.maxy = quad.miny + rows;
+    quad.minu = u0;
+    quad.maxu = u1;
+    quad.minv = v0;
+    quad.maxv = v1;
+}
+
+void BuildGlyphVertices(const GlyphQuad& quad, uint32_t color, TextVertex vertices[4])
+{
+    vertices[0].sx = quad.minx;
+    vertices[0].sy = quad.miny;
+    vertices[0].tu = quad.minu;
+    vertices[0].tv = quad.minv;
+
+    vertices[1].sx = quad.maxx;
+    vertices[1].sy = quad.miny;
+    vertices[1].tu = quad.maxu;
+    vertices[1].tv = quad.minv;
+
+    vertices[2].sx = quad.maxx;
+    vertices[2].sy = quad.maxy;
+    vertices[2].tu = quad.maxu;
+    vertices[2].tv = quad.maxv;
+
+    vertices[3].sx = quad.minx;
+    vertices[3].sy = quad.maxy;
+    vertices[3].tu = quad.minu;
+    vertices[3].tv = quad.maxv;
+    for(int i = 0; i < 4; ++i)
+    {
+        vertices[i].sz = 1.f;
+        vertices[i].rhw = 1.f;
+        vertices[i].color = color;
+        vertices[i].specular = 0xFFFFFFFF;
+    }
+}
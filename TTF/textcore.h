@@ -0,0 +1,141 @@
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "linebreak.h"
+
+// Platform independent part of the text path, nothing in here touches the engine, DirectDraw or Win32
+#define UNKNOWN_UNICODE 0xFFFD
+
+// encoding is a Windows code page between 1250 and 1258, anything else decodes UTF-8
+uint32_t DecodeCharacter(int encoding, const char* text, int textlen, int& utf8size);
+// Reverse of DecodeCharacter for the Windows code pages, fails when the code page can't represent utf32
+bool EncodeCharacter(int encoding, uint32_t utf32, char& character);
+void ReadFontDetails(const std::string& fontStr, std::string& fontName, int& fontSize, int& fontRed, int& fontGreen, int& fontBlue, int& fontAlpha);
+
+struct GlyphQuad
+{
+    float minx, miny, maxx, maxy;
+    float minu, maxu, minv, maxv;
+};
+
+// Same memory layout as D3DTLVERTEX
+struct TextVertex
+{
+    float sx;
+    float sy;
+    float sz;
+    float rhw;
+    uint32_t color;
+    uint32_t specular;
+    float tu;
+    float tv;
+};
+
+// baseline is the pen y position plus the font ascent
+void BuildGlyphQuad(int x, int baseline, unsigned int width, unsigned int rows, int left, int top, float u0, float u1, float v0, float v1, bool halfPixelOffset, GlyphQuad& quad);
+void BuildGlyphVertices(const GlyphQuad& quad, uint32_t color, TextVertex vertices[4]);
+
+// Width of a string in pixels, control characters and spaces advance by spaceWidth and everything else by getAdvance(utf32)
+template<typename GetAdvance>
+int MeasureText(int encoding, const char* text, int len, int spaceWidth, GetAdvance getAdvance)
+{
+    int width = 0;
+    for(int i = 0; i < len;)
+    {
+        int utf8size;
+        uint32_t utf32 = DecodeCharacter(encoding, text + i, len - i, utf8size);
+        i += utf8size;
+        if(utf32 <= 32)
+            width += spaceWidth;
+        else
+            width += getAdvance(utf32);
+    }
+    return width;
+}
+
+// Remembers the prefix widths of the last string it measured, the engine's word wrap measures the line it builds
+// after every word it adds so only the new word gets decoded and looked up instead of the whole line again
+class PrefixMeasure
+{
+    public:
+        PrefixMeasure() = default;
+
+        // owner identifies the font, anything measured for another font, encoding or space width starts over
+        template<typename GetAdvance>
+        int Measure(uint32_t owner, int encoding, const char* text, int len, int spaceWidth, GetAdvance getAdvance)
+        {
+            size_t common = 0;
+            if(owner == m_owner && encoding == m_encoding && spaceWidth == m_spaceWidth)
+            {
+                size_t maxCommon = std::min(m_text.length(), static_cast<size_t>(len));
+                while(common < maxCommon && m_text[common] == text[common])
+                    ++common;
+                // The last character may have been cut short by the end of the old string
+                if(common == m_text.length() && common > 0)
+                    --common;
+                while(common > 0 && m_widths[common] < 0)
+                    --common;
+            }
+            m_owner = owner;
+            m_encoding = encoding;
+            m_spaceWidth = spaceWidth;
+            m_reusedLength = common;
+
+            int width = (common > 0 ? m_widths[common] : 0);
+            m_text.assign(text, static_cast<size_t>(len));
+            m_widths.resize(static_cast<size_t>(len) + 1);
+            for(int i = static_cast<int>(common); i < len;)
+            {
+                int utf8size;
+                uint32_t utf32 = DecodeCharacter(encoding, text + i, len - i, utf8size);
+                m_widths[i] = width;
+                for(int j = 1; j < utf8size; ++j)
+                    m_widths[i + j] = -1;
+                width += (utf32 <= 32 ? spaceWidth : getAdvance(utf32));
+                i += utf8size;
+            }
+            m_widths[len] = width;
+            return width;
+        }
+
+        // Bytes at the start of the last measured string whose characters getAdvance wasn't called for
+        size_t GetReusedLength() const {return m_reusedLength;}
+
+    private:
+        PrefixMeasure(const PrefixMeasure&) = delete;
+        PrefixMeasure& operator=(const PrefixMeasure&) = delete;
+
+        uint32_t m_owner = 0;
+        int m_encoding = 0;
+        int m_spaceWidth = 0;
+        size_t m_reusedLength = 0;
+        std::string m_text;
+        // Width of the characters before every byte a character starts at, -1 inside a character
+        std::vector<int> m_widths;
+};
+
+// Wraps text to maxWidth pixels at its UAX #14 break opportunities, see BreakParagraph
+// The paragraph holds the decoded characters and their prefix widths between calls
+template<typename GetAdvance>
+void WrapText(int encoding, const char* text, int len, int spaceWidth, int maxWidth, GetAdvance getAdvance, TextParagraph& paragraph, std::vector<TextLine>& lines,
+    LineMeasure measureLine = nullptr, const void* context = nullptr)
+{
+    paragraph.Clear();
+    int width = 0;
+    for(int i = 0; i < len;)
+    {
+        int utf8size;
+        uint32_t utf32 = DecodeCharacter(encoding, text + i, len - i, utf8size);
+        paragraph.characters.push_back(utf32);
+        paragraph.offsets.push_back(i);
+        paragraph.advances.push_back(width);
+        width += (utf32 <= 32 ? spaceWidth : getAdvance(utf32));
+        i += utf8size;
+    }
+    paragraph.offsets.push_back(len);
+    paragraph.advances.push_back(width);
+    BreakParagraph(paragraph, maxWidth, lines, measureLine, context);
+}
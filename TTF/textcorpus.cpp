@@ -0,0 +1,144 @@
+#include "textcorpus.h"
+#include "textcore.h"
+
+// Synthetic Gothic style vocabulary, Vietnamese keeps its tone marks combining the way Windows-1258 stores them
+static const char* g_wordsPL[] = {u8"Witaj", u8"w\u0119drowcze", u8"z\u0142oto", u8"\u017Co\u0142nierz", u8"miecz", u8"czarodziej", u8"wi\u0119zie\u0144", u8"kopalnia", u8"ob\u00F3z", u8"stra\u017Cnik", u8"ruda", u8"\u0142uk", u8"zbroja", u8"\u015Bwi\u0105tynia", u8"piwo", u8"ch\u0142op", u8"bagno", u8"smok"};
+static const char* g_wordsRU[] = {u8"\u041F\u0440\u0438\u0432\u0435\u0442", u8"\u0441\u0442\u0440\u0430\u043D\u043D\u0438\u043A", u8"\u0437\u043E\u043B\u043E\u0442\u043E", u8"\u0441\u043E\u043B\u0434\u0430\u0442", u8"\u043C\u0435\u0447", u8"\u043C\u0430\u0433", u8"\u0443\u0437\u043D\u0438\u043A", u8"\u0448\u0430\u0445\u0442\u0430", u8"\u043B\u0430\u0433\u0435\u0440\u044C", u8"\u0441\u0442\u0440\u0430\u0436\u043D\u0438\u043A", u8"\u0440\u0443\u0434\u0430", u8"\u043B\u0443\u043A", u8"\u0434\u043E\u0441\u043F\u0435\u0445\u0438", u8"\u0445\u0440\u0430\u043C", u8"\u043F\u0438\u0432\u043E", u8"\u043A\u0440\u0435\u0441\u0442\u044C\u044F\u043D\u0438\u043D", u8"\u0431\u043E\u043B\u043E\u0442\u043E", u8"\u0434\u0440\u0430\u043A\u043E\u043D"};
+static const char* g_wordsDE[] = {u8"Gr\u00FC\u00DF", u8"dich", u8"Fremder", u8"Gold", u8"S\u00F6ldner", u8"Schwert", u8"Magier", u8"Gefangener", u8"Mine", u8"Lager", u8"W\u00E4chter", u8"Erz", u8"Bogen", u8"R\u00FCstung", u8"Tempel", u8"Bier", u8"Bauer", u8"Sumpf", u8"Drache", u8"Stra\u00DFe"};
+static const char* g_wordsEL[] = {u8"\u03A7\u03B1\u03AF\u03C1\u03B5", u8"\u03C4\u03B1\u03BE\u03B9\u03B4\u03B9\u03CE\u03C4\u03B7", u8"\u03C7\u03C1\u03C5\u03C3\u03CC\u03C2", u8"\u03C3\u03C4\u03C1\u03B1\u03C4\u03B9\u03CE\u03C4\u03B7\u03C2", u8"\u03BE\u03AF\u03C6\u03BF\u03C2", u8"\u03BC\u03AC\u03B3\u03BF\u03C2", u8"\u03C6\u03C5\u03BB\u03B1\u03BA\u03B9\u03C3\u03BC\u03AD\u03BD\u03BF\u03C2", u8"\u03BF\u03C1\u03C5\u03C7\u03B5\u03AF\u03BF", u8"\u03C3\u03C4\u03C1\u03B1\u03C4\u03CC\u03C0\u03B5\u03B4\u03BF", u8"\u03C6\u03C1\u03BF\u03C5\u03C1\u03CC\u03C2", u8"\u03BC\u03B5\u03C4\u03AC\u03BB\u03BB\u03B5\u03C5\u03BC\u03B1", u8"\u03C4\u03CC\u03BE\u03BF", u8"\u03C0\u03B1\u03BD\u03BF\u03C0\u03BB\u03AF\u03B1", u8"\u03BD\u03B1\u03CC\u03C2", u8"\u03BC\u03C0\u03CD\u03C1\u03B1", u8"\u03C7\u03C9\u03C1\u03B9\u03BA\u03CC\u03C2", u8"\u03B2\u03AC\u03BB\u03C4\u03BF\u03C2", u8"\u03B4\u03C1\u03AC\u03BA\u03BF\u03C2"};
+static const char* g_wordsTR[] = {u8"Merhaba", u8"yolcu", u8"alt\u0131n", u8"asker", u8"k\u0131l\u0131\u00E7", u8"b\u00FCy\u00FCc\u00FC", u8"mahk\u00FBm", u8"maden", u8"kamp", u8"muhaf\u0131z", u8"cevher", u8"yay", u8"z\u0131rh", u8"tap\u0131nak", u8"bira", u8"k\u00F6yl\u00FC", u8"batakl\u0131k", u8"ejderha"};
+static const char* g_wordsHE[] = {u8"\u05E9\u05DC\u05D5\u05DD", u8"\u05E0\u05D5\u05E1\u05E2", u8"\u05D6\u05D4\u05D1", u8"\u05D7\u05D9\u05D9\u05DC", u8"\u05D7\u05E8\u05D1", u8"\u05E7\u05D5\u05E1\u05DD", u8"\u05D0\u05E1\u05D9\u05E8", u8"\u05DE\u05DB\u05E8\u05D4", u8"\u05DE\u05D7\u05E0\u05D4", u8"\u05E9\u05D5\u05DE\u05E8", u8"\u05E2\u05E4\u05E8\u05D4", u8"\u05E7\u05E9\u05EA", u8"\u05E9\u05E8\u05D9\u05D5\u05DF", u8"\u05DE\u05E7\u05D3\u05E9", u8"\u05D1\u05D9\u05E8\u05D4", u8"\u05D0\u05D9\u05DB\u05E8", u8"\u05D1\u05D9\u05E6\u05D4", u8"\u05D3\u05E8\u05E7\u05D5\u05DF"};
+static const char* g_wordsAR[] = {u8"\u0645\u0631\u062D\u0628\u0627", u8"\u0623\u064A\u0647\u0627", u8"\u0627\u0644\u0645\u0633\u0627\u0641\u0631", u8"\u0630\u0647\u0628", u8"\u062C\u0646\u062F\u064A", u8"\u0633\u064A\u0641", u8"\u0633\u0627\u062D\u0631", u8"\u0633\u062C\u064A\u0646", u8"\u0645\u0646\u062C\u0645", u8"\u0645\u0639\u0633\u0643\u0631", u8"\u062D\u0627\u0631\u0633", u8"\u062E\u0627\u0645", u8"\u0642\u0648\u0633", u8"\u062F\u0631\u0639", u8"\u0645\u0639\u0628\u062F", u8"\u062C\u0639\u0629", u8"\u0641\u0644\u0627\u062D", u8"\u0645\u0633\u062A\u0646\u0642\u0639", u8"\u062A\u0646\u064A\u0646"};
+static const char* g_wordsLT[] = {u8"Sveikas", u8"keliautojau", u8"auksas", u8"karys", u8"kardas", u8"burtininkas", u8"kalinys", u8"kasykla", u8"stovykla", u8"sargybinis", u8"r\u016Bda", u8"lankas", u8"\u0161arvai", u8"\u0161ventykla", u8"alus", u8"valstietis", u8"pelk\u0117", u8"drakonas"};
+static const char* g_wordsVI[] = {u8"Xin", u8"ch\u00E0o", u8"l\u01B0\u0303", u8"kh\u00E1ch", u8"v\u00E0ng", u8"l\u00EDnh", u8"g\u01B0\u01A1m", u8"ph\u00E1p", u8"s\u01B0", u8"t\u00F9", u8"nh\u00E2n", u8"mo\u0309", u8"tra\u0323i", u8"l\u00EDnh", u8"g\u00E1c", u8"qu\u0103\u0323ng", u8"cung", u8"\u00E1o", u8"gi\u00E1p", u8"\u0111\u00EA\u0300n", u8"bia", u8"n\u00F4ng", u8"d\u00E2n", u8"\u0111\u00E2\u0300m", u8"l\u00E2\u0300y", u8"r\u00F4\u0300ng"};
+static const char* g_wordsZH_HANS[] = {u8"\u4F60\u597D", u8"\u65C5\u884C\u8005", u8"\u91D1\u5B50", u8"\u58EB\u5175", u8"\u5251", u8"\u9B54\u6CD5\u5E08", u8"\u56DA\u72AF", u8"\u77FF\u4E95", u8"\u8425\u5730", u8"\u5B88\u536B", u8"\u77FF\u77F3", u8"\u5F13", u8"\u76D4\u7532", u8"\u795E\u5E99", u8"\u5564\u9152", u8"\u519C\u6C11", u8"\u6CBC\u6CFD", u8"\u9F99", u8"\u6211\u4EEC", u8"\u9700\u8981", u8"\u5E2E\u52A9"};
+static const char* g_wordsZH_HANT[] = {u8"\u4F60\u597D", u8"\u65C5\u884C\u8005", u8"\u91D1\u5B50", u8"\u58EB\u5175", u8"\u528D", u8"\u9B54\u6CD5\u5E2B", u8"\u56DA\u72AF", u8"\u7926\u4E95", u8"\u71DF\u5730", u8"\u5B88\u885B", u8"\u7926\u77F3", u8"\u5F13", u8"\u76D4\u7532", u8"\u795E\u5EDF", u8"\u5564\u9152", u8"\u8FB2\u6C11", u8"\u6CBC\u6FA4", u8"\u9F8D", u8"\u6211\u5011", u8"\u9700\u8981", u8"\u5E6B\u52A9"};
+static const char* g_speakers[] = {"Diego", "Xardas", "Lester", "Gorn", "Milten", "Lares", "Vatras", "Lee", "Thorus", "Gomez"};
+
+struct CorpusLanguage
+{
+    const char* name;
+    int encoding;
+    const char* const* words;
+    size_t wordCount;
+    bool spaced;
+};
+
+#define CORPUS_LANGUAGE(name, encoding, words, spaced) {name, encoding, words, sizeof(words) / sizeof(words[0]), spaced}
+static const CorpusLanguage g_languages[] = {
+    CORPUS_LANGUAGE("PL", 1250, g_wordsPL, true),
+    CORPUS_LANGUAGE("RU", 1251, g_wordsRU, true),
+    CORPUS_LANGUAGE("DE", 1252, g_wordsDE, true),
+    CORPUS_LANGUAGE("EL", 1253, g_wordsEL, true),
+    CORPUS_LANGUAGE("TR", 1254, g_wordsTR, true),
+    CORPUS_LANGUAGE("HE", 1255, g_wordsHE, true),
+    CORPUS_LANGUAGE("AR", 1256, g_wordsAR, true),
+    CORPUS_LANGUAGE("LT", 1257, g_wordsLT, true),
+    CORPUS_LANGUAGE("VI", 1258, g_wordsVI, true),
+    CORPUS_LANGUAGE("ZH-HANS", 0, g_wordsZH_HANS, false),
+    CORPUS_LANGUAGE("ZH-HANT", 0, g_wordsZH_HANT, false),
+};
+#undef CORPUS_LANGUAGE
+
+static const char* g_kindNames[Corpus_KindCount] = {"dialog", "menu", "subtitle"};
+
+// Fixed LCG so every build generates byte identical slices
+static uint32_t NextRandom(uint32_t& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static uint32_t RandomRange(uint32_t& state, uint32_t minValue, uint32_t maxValue)
+{
+    return minValue + NextRandom(state) % (maxValue - minValue + 1);
+}
+
+static void BuildLine(const CorpusLanguage& language, CorpusKind kind, uint32_t& state, std::string& line)
+{
+    const char* separator = (language.spaced ? " " : "");
+    const char* comma = (language.spaced ? ", " : u8"，");
+    const char* stop = (language.spaced ? "." : u8"。");
+
+    uint32_t words;
+    line.clear();
+    switch(kind)
+    {
+        case Corpus_Dialog: words = RandomRange(state, 6, 16); break;
+        case Corpus_Menu: words = RandomRange(state, 1, 3); break;
+        default:
+        {
+            words = RandomRange(state, 4, 10);
+            line.append(g_speakers[NextRandom(state) % (sizeof(g_speakers) / sizeof(g_speakers[0]))]);
+            line.append(": ");
+        }
+        break;
+    }
+
+    for(uint32_t i = 0; i < words; ++i)
+    {
+        if(i > 0)
+            line.append((kind == Corpus_Dialog && NextRandom(state) % 6 == 0) ? comma : separator);
+
+        // Ore prices and the like show up all over the dialogs
+        if(kind != Corpus_Menu && NextRandom(state) % 12 == 0)
+            line.append(std::to_string(RandomRange(state, 1, 500)));
+        else
+            line.append(language.words[NextRandom(state) % language.wordCount]);
+    }
+
+    if(kind != Corpus_Menu)
+        line.append(stop);
+}
+
+static void ConvertLine(int encoding, const std::string& utf8Line, std::string& line)
+{
+    line.clear();
+    for(int i = 0, len = static_cast<int>(utf8Line.length()); i < len;)
+    {
+        int utf8size;
+        uint32_t utf32 = DecodeCharacter(0, utf8Line.c_str() + i, len - i, utf8size);
+        i += utf8size;
+
+        char character;
+        line.append(1, (EncodeCharacter(encoding, utf32, character) ? character : '?'));
+    }
+}
+
+void BuildTextCorpus(size_t linesPerSlice, std::vector<CorpusSlice>& slices)
+{
+    slices.clear();
+
+    std::string utf8Line, line;
+    for(const CorpusLanguage& language : g_languages)
+    {
+        for(int kind = 0; kind < Corpus_KindCount; ++kind)
+        {
+            // Code page slices carry the same lines as their UTF-8 counterparts
+            size_t utf8Slice = slices.size();
+            slices.emplace_back();
+            slices.back().name = std::string(language.name) + "-UTF8-" + g_kindNames[kind];
+            slices.back().encoding = 0;
+            slices.back().kind = static_cast<CorpusKind>(kind);
+            if(language.encoding)
+            {
+                slices.emplace_back();
+                slices.back().name = std::string(language.name) + "-" + std::to_string(language.encoding) + "-" + g_kindNames[kind];
+                slices.back().encoding = language.encoding;
+                slices.back().kind = static_cast<CorpusKind>(kind);
+            }
+
+            uint32_t state = static_cast<uint32_t>(utf8Slice) * 2654435761u + 1;
+            for(size_t i = 0; i < linesPerSlice; ++i)
+            {
+                BuildLine(language, static_cast<CorpusKind>(kind), state, utf8Line);
+                slices[utf8Slice].lines.push_back(utf8Line);
+                if(language.encoding)
+                {
+                    ConvertLine(language.encoding, utf8Line, line);
+                    slices[utf8Slice + 1].lines.push_back(line);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Reproducible benchmark input made of synthetic dialog lines, menu entries and subtitles
+// Every language is generated in UTF-8 and, when the game supports one, in its Windows code page
+enum CorpusKind
+{
+    Corpus_Dialog = 0,
+    Corpus_Menu,
+    Corpus_Subtitle,
+    Corpus_KindCount
+};
+
+struct CorpusSlice
+{
+    std::string name;
+    int encoding;
+    CorpusKind kind;
+    std::vector<std::string> lines;
+};
+
+void BuildTextCorpus(size_t linesPerSlice, std::vector<CorpusSlice>& slices);
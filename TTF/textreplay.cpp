@@ -0,0 +1,211 @@
+#include "textreplay.h"
+#include "alloctracker.h"
+#include "glyphcache.h"
+#include "texttrace.h"
+#include "textcore.h"
+#include "textstats.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+struct ReplayFrame
+{
+    uint32_t drawCalls = 0;
+    uint32_t measures = 0;
+    uint32_t glyphs = 0;
+    uint32_t cacheHits = 0;
+    uint32_t cacheMisses = 0;
+    int64_t ticks = 0;
+    uint64_t heapAllocs = 0;
+    uint64_t freeTypeAllocs = 0;
+};
+
+class TextReplay
+{
+    public:
+        TextReplay(int encoding, TTFont*(*loadFont)(const std::string&)) : m_encoding(encoding), m_loadFont(loadFont) {}
+        ~TextReplay()
+        {
+            for(auto& it : m_fonts)
+            {
+                if(it.second)
+                    UnloadFont(it.second);
+            }
+        }
+
+        TextReplay(const TextReplay&) = delete;
+        TextReplay& operator=(const TextReplay&) = delete;
+
+        bool LoadFont(uint32_t fontId, const std::string& descriptor)
+        {
+            TTFont*& font = m_fonts[fontId];
+            if(font)
+                UnloadFont(font);
+            font = m_loadFont(descriptor);
+            return font != nullptr;
+        }
+
+        // Calls for fonts the trace never loaded are dropped
+        void Measure(uint32_t fontId, const std::string& text, ReplayFrame& frame)
+        {
+            TTFont* font = GetFont(fontId);
+            if(!font)
+                return;
+
+            ++frame.measures;
+            m_sink += MeasureGlyphs(font, static_cast<int>(font->scaler.height) / 4, m_encoding, text.c_str(), static_cast<int>(text.length()));
+        }
+
+        void Draw(uint32_t fontId, int x, int y, uint32_t color, const std::string& text, ReplayFrame& frame)
+        {
+            TTFont* font = GetFont(fontId);
+            if(!font)
+                return;
+
+            ++frame.drawCalls;
+            g_renderBackend->BeginText();
+            DrawGlyphs(font, x, y + font->ascent, static_cast<int>(font->scaler.height) / 4, 1000000.f, GetGlyphColor(font, color), m_encoding,
+                text.c_str(), static_cast<int>(text.length()));
+            g_renderBackend->EndText();
+        }
+
+    private:
+        TTFont* GetFont(uint32_t fontId) const
+        {
+            auto it = m_fonts.find(fontId);
+            return (it != m_fonts.end() ? it->second : nullptr);
+        }
+
+        int m_encoding;
+        TTFont*(*m_loadFont)(const std::string&);
+        // Keeps the optimizer from dropping the work
+        volatile uint32_t m_sink = 0;
+        std::unordered_map<uint32_t, TTFont*> m_fonts;
+};
+
+// Glyphs and cache lookups come from the counters the glyph cache keeps for the overlay
+static void TakeCounters(ReplayFrame& frame)
+{
+    frame.glyphs += g_textCounters.glyphsDrawn;
+    frame.cacheHits += g_textCounters.cacheHits;
+    frame.cacheMisses += g_textCounters.cacheMisses;
+    g_textCounters = TextFrameCounters();
+}
+
+static void AddFrame(ReplayFrame& total, const ReplayFrame& frame)
+{
+    total.drawCalls += frame.drawCalls;
+    total.measures += frame.measures;
+    total.glyphs += frame.glyphs;
+    total.cacheHits += frame.cacheHits;
+    total.cacheMisses += frame.cacheMisses;
+    total.ticks += frame.ticks;
+    total.heapAllocs += frame.heapAllocs;
+    total.freeTypeAllocs += frame.freeTypeAllocs;
+}
+
+static uint64_t GetFreeTypeAllocations()
+{
+    return g_ftAllocator.GetStats(FTArena_Face).allocations + g_ftAllocator.GetStats(FTArena_Transient).allocations;
+}
+
+static bool IsSameCall(const TextTraceEvent& a, const TextTraceEvent& b)
+{
+    return a.type == b.type && a.fontId == b.fontId && a.x == b.x && a.y == b.y && a.color == b.color && a.text == b.text;
+}
+
+// A frame making exactly the calls of the frame before finds every glyph and string in the caches already
+static bool IsRepeatedFrame(const std::vector<TextTraceEvent>& calls, const std::vector<TextTraceEvent>& previousCalls)
+{
+    if(calls.empty() || calls.size() != previousCalls.size())
+        return false;
+    for(size_t i = 0; i < calls.size(); ++i)
+    {
+        if(!IsSameCall(calls[i], previousCalls[i]))
+            return false;
+    }
+    return true;
+}
+
+static void WriteFrame(FILE* f, const char* name, const ReplayFrame& frame, bool repeated)
+{
+    fprintf(f, "%s,%u,%u,%u,%u,%u,%.1f,%d,%llu,", name, frame.drawCalls, frame.measures, frame.glyphs, frame.cacheHits, frame.cacheMisses,
+        TextStatsTicksToMs(frame.ticks) * 1000.0, (repeated ? 1 : 0), static_cast<unsigned long long>(frame.freeTypeAllocs));
+    // Left empty by builds that don't count allocations
+    if(TTF_ALLOC_TRACKING_ENABLED)
+        fprintf(f, "%llu", static_cast<unsigned long long>(frame.heapAllocs));
+    fprintf(f, "\n");
+}
+
+bool ReplayTextTrace(const char* tracePath, const char* reportPath, TTFont*(*loadFont)(const std::string& descriptor), uint32_t& allocatingFrames)
+{
+    allocatingFrames = 0;
+    TextTraceReader reader;
+    if(!reader.Open(tracePath))
+        return false;
+
+    FILE* f = fopen(reportPath, "w");
+    if(!f)
+        return false;
+
+    fprintf(f, "frame,draw_calls,measures,glyphs,cache_hits,cache_misses,cost_us,repeated,freetype_allocs,heap_allocs\n");
+
+    TextReplay replay(reader.GetEncoding(), loadFont);
+    ReplayFrame frame, total;
+    uint32_t frameIndex = 0;
+    bool success = true;
+    std::vector<TextTraceEvent> calls, previousCalls;
+    bool loadedFont = false;
+    TextTraceEvent event;
+    g_textCounters = TextFrameCounters();
+    while(success && reader.Next(event))
+    {
+        // Only the replayed calls count, the reader allocates for every event text
+        uint64_t allocs = GetHeapAllocations();
+        uint64_t freeTypeAllocs = GetFreeTypeAllocations();
+        int64_t start = TextStatsTimestamp();
+        switch(event.type)
+        {
+            case TextTrace_LoadFont: success = replay.LoadFont(event.fontId, event.text); break;
+            case TextTrace_Measure: replay.Measure(event.fontId, event.text, frame); break;
+            case TextTrace_Print:
+            case TextTrace_Blit: replay.Draw(event.fontId, event.x, event.y, event.color, event.text, frame); break;
+            default: break;
+        }
+        frame.ticks += TextStatsTimestamp() - start;
+        frame.heapAllocs += GetHeapAllocations() - allocs;
+        frame.freeTypeAllocs += GetFreeTypeAllocations() - freeTypeAllocs;
+
+        if(event.type == TextTrace_LoadFont)
+            loadedFont = true;
+        if(event.type != TextTrace_Frame)
+        {
+            if(event.type != TextTrace_LoadFont)
+                calls.push_back(event);
+            continue;
+        }
+
+        TakeCounters(frame);
+        ++g_textFrame;
+        // A repeated frame is in steady state and must not allocate, whatever the frame before it missed,
+        // unless it loaded a font again which starts out with no glyphs
+        bool repeated = !loadedFont && IsRepeatedFrame(calls, previousCalls);
+        WriteFrame(f, std::to_string(frameIndex++).c_str(), frame, repeated);
+        if(repeated && (frame.heapAllocs != 0 || frame.freeTypeAllocs != 0))
+            ++allocatingFrames;
+        AddFrame(total, frame);
+        frame = ReplayFrame();
+        previousCalls.swap(calls);
+        calls.clear();
+        loadedFont = false;
+    }
+
+    // Calls after the last frame boundary still count towards the total
+    TakeCounters(frame);
+    AddFrame(total, frame);
+    WriteFrame(f, "total", total, false);
+    fclose(f);
+    return success;
+}
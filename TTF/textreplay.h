@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+struct TTFont;
+
+// Feeds a captured text trace through the glyph cache and DrawGlyphs like the game's calls and writes one CSV row per frame
+// Traced fonts are opened again by loadFont from the descriptors the trace recorded, fonts loaded again start out empty
+// Pages go to g_renderBackend, allocatingFrames counts the frames repeating the calls of the frame before that still allocated from FreeType
+// or, in builds with TTF_ALLOC_TRACKING, from the heap
+bool ReplayTextTrace(const char* tracePath, const char* reportPath, TTFont*(*loadFont)(const std::string& descriptor), uint32_t& allocatingFrames);
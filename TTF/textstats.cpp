@@ -0,0 +1,89 @@
+#include "textstats.h"
+#include "log.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+bool g_useStatsOverlay = false;
+int g_statsLogInterval = 0;
+TextFrameCounters g_textCounters;
+
+static TextFrameCounters g_lastFrameCounters;
+static TextFrameCounters g_intervalCounters;
+static uint32_t g_intervalFrames = 0;
+static int64_t g_intervalStart = 0;
+
+// steady_clock is QueryPerformanceCounter on Windows
+int64_t TextStatsTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double TextStatsTicksToMs(int64_t ticks)
+{
+    return static_cast<double>(ticks) / 1000000.0;
+}
+
+static void AccumulateCounters(TextFrameCounters& sum, const TextFrameCounters& counters)
+{
+    sum.drawCalls += counters.drawCalls;
+    sum.glyphsDrawn += counters.glyphsDrawn;
+    sum.measureCalls += counters.measureCalls;
+    sum.cacheHits += counters.cacheHits;
+    sum.cacheMisses += counters.cacheMisses;
+    sum.stateChanges += counters.stateChanges;
+    sum.rasterTicks += counters.rasterTicks;
+    sum.textureBytesAllocated += counters.textureBytesAllocated;
+    sum.textureBytesUploaded += counters.textureBytesUploaded;
+    sum.heapAllocations += counters.heapAllocations;
+    sum.freeTypeAllocations += counters.freeTypeAllocations;
+}
+
+void TextStatsEndFrame()
+{
+    g_lastFrameCounters = g_textCounters;
+    g_textCounters = TextFrameCounters();
+    if(g_statsLogInterval <= 0)
+        return;
+
+    int64_t now = TextStatsTimestamp();
+    if(g_intervalStart == 0)
+        g_intervalStart = now;
+
+    AccumulateCounters(g_intervalCounters, g_lastFrameCounters);
+    ++g_intervalFrames;
+    if(TextStatsTicksToMs(now - g_intervalStart) < g_statsLogInterval * 1000.0)
+        return;
+
+    double frames = static_cast<double>(g_intervalFrames);
+    LogMessage("Text per frame over %u frames: %.1f draw calls, %.1f glyphs, %.1f measures, %.1f cache hits, %.1f cache misses, %.1f state changes, "
+        "%.3f ms rasterizing, %.0f bytes allocated, %.0f bytes uploaded", g_intervalFrames, g_intervalCounters.drawCalls / frames,
+        g_intervalCounters.glyphsDrawn / frames, g_intervalCounters.measureCalls / frames, g_intervalCounters.cacheHits / frames,
+        g_intervalCounters.cacheMisses / frames, g_intervalCounters.stateChanges / frames, TextStatsTicksToMs(g_intervalCounters.rasterTicks) / frames,
+        g_intervalCounters.textureBytesAllocated / frames, g_intervalCounters.textureBytesUploaded / frames);
+#ifdef TTF_ALLOC_TRACKING
+    LogMessage("Allocations per frame: %.2f heap, %.2f FreeType", g_intervalCounters.heapAllocations / frames, g_intervalCounters.freeTypeAllocations / frames);
+#endif
+
+    g_intervalCounters = TextFrameCounters();
+    g_intervalFrames = 0;
+    g_intervalStart = now;
+}
+
+const TextFrameCounters& GetLastFrameCounters()
+{
+    return g_lastFrameCounters;
+}
+
+void FormatFrameCounters(const TextFrameCounters& counters, char* buffer, size_t size)
+{
+    snprintf(buffer, size, "Text draws: %u calls, %u glyphs, %u measures\nGlyph cache: %u hits, %u misses, %.3f ms raster\n"
+        "Textures: %u KiB allocated, %u KiB uploaded, %u state changes", counters.drawCalls, counters.glyphsDrawn, counters.measureCalls,
+        counters.cacheHits, counters.cacheMisses, TextStatsTicksToMs(counters.rasterTicks), static_cast<unsigned int>(counters.textureBytesAllocated / 1024),
+        static_cast<unsigned int>(counters.textureBytesUploaded / 1024), counters.stateChanges);
+#ifdef TTF_ALLOC_TRACKING
+    size_t length = strlen(buffer);
+    snprintf(buffer + length, size - length, "\nAllocations: %u heap, %u FreeType", counters.heapAllocations, counters.freeTypeAllocations);
+#endif
+}
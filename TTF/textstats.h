@@ -0,0 +1,34 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Work done by the text path during one frame, frames are delimited by IDirect3DDevice7::EndScene
+struct TextFrameCounters
+{
+    uint32_t drawCalls = 0;
+    uint32_t glyphsDrawn = 0;
+    uint32_t measureCalls = 0;
+    uint32_t cacheHits = 0;
+    uint32_t cacheMisses = 0;
+    uint32_t stateChanges = 0;
+    int64_t rasterTicks = 0;
+    uint64_t textureBytesAllocated = 0;
+    uint64_t textureBytesUploaded = 0;
+    // Only counted by builds with TTF_ALLOC_TRACKING
+    uint32_t heapAllocations = 0;
+    uint32_t freeTypeAllocations = 0;
+};
+
+extern bool g_useStatsOverlay;
+extern int g_statsLogInterval;
+extern TextFrameCounters g_textCounters;
+
+int64_t TextStatsTimestamp();
+double TextStatsTicksToMs(int64_t ticks);
+
+// Closes the current frame, every g_statsLogInterval seconds the per-frame averages are written to the log
+void TextStatsEndFrame();
+const TextFrameCounters& GetLastFrameCounters();
+
+// Writes the overlay text, one line per counter group separated by '\n'
+void FormatFrameCounters(const TextFrameCounters& counters, char* buffer, size_t size);
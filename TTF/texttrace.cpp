@@ -0,0 +1,196 @@
+#include "texttrace.h"
+
+#include <string.h>
+
+#define TEXTTRACE_VERSION 1
+// Text lines longer than this get cut, nothing in the game comes close
+#define TEXTTRACE_MAX_STRING 0xFFFF
+
+static uint32_t ZigZagEncode(int value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int ZigZagDecode(uint32_t value)
+{
+    return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+
+bool TextTraceWriter::Open(const char* path, int encoding)
+{
+    Close();
+    m_file = fopen(path, "wb");
+    if(!m_file)
+        return false;
+
+    setvbuf(m_file, nullptr, _IOFBF, 64 * 1024);
+    fwrite("TTFT", 1, 4, m_file);
+    WriteVarint(TEXTTRACE_VERSION);
+    WriteVarint(static_cast<uint32_t>(encoding));
+    return true;
+}
+
+void TextTraceWriter::Close()
+{
+    if(m_file)
+    {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void TextTraceWriter::WriteVarint(uint32_t value)
+{
+    unsigned char bytes[5];
+    size_t count = 0;
+    do
+    {
+        bytes[count] = static_cast<unsigned char>(value & 0x7F);
+        value >>= 7;
+        if(value)
+            bytes[count] |= 0x80;
+        ++count;
+    } while(value);
+    fwrite(bytes, 1, count, m_file);
+}
+
+void TextTraceWriter::WriteString(const char* text, size_t len)
+{
+    if(len > TEXTTRACE_MAX_STRING)
+        len = TEXTTRACE_MAX_STRING;
+
+    WriteVarint(static_cast<uint32_t>(len));
+    fwrite(text, 1, len, m_file);
+}
+
+void TextTraceWriter::Frame()
+{
+    if(!m_file)
+        return;
+
+    fputc(TextTrace_Frame, m_file);
+}
+
+void TextTraceWriter::LoadFont(uint32_t fontId, const std::string& descriptor)
+{
+    if(!m_file)
+        return;
+
+    fputc(TextTrace_LoadFont, m_file);
+    WriteVarint(fontId);
+    WriteString(descriptor.c_str(), descriptor.length());
+}
+
+void TextTraceWriter::Text(TextTraceRecord type, uint32_t fontId, int x, int y, uint32_t color, const char* text, int len)
+{
+    if(!m_file)
+        return;
+
+    fputc(type, m_file);
+    WriteVarint(fontId);
+    WriteVarint(ZigZagEncode(x));
+    WriteVarint(ZigZagEncode(y));
+    WriteVarint(color);
+    WriteString(text, static_cast<size_t>(len));
+}
+
+void TextTraceWriter::Measure(uint32_t fontId, const char* text, int len)
+{
+    if(!m_file)
+        return;
+
+    fputc(TextTrace_Measure, m_file);
+    WriteVarint(fontId);
+    WriteString(text, static_cast<size_t>(len));
+}
+
+bool TextTraceReader::Open(const char* path)
+{
+    Close();
+    m_file = fopen(path, "rb");
+    if(!m_file)
+        return false;
+
+    char magic[4];
+    uint32_t version, encoding;
+    if(fread(magic, 1, 4, m_file) != 4 || memcmp(magic, "TTFT", 4) != 0 || !ReadVarint(version) || version != TEXTTRACE_VERSION || !ReadVarint(encoding))
+    {
+        Close();
+        return false;
+    }
+
+    m_encoding = static_cast<int>(encoding);
+    return true;
+}
+
+void TextTraceReader::Close()
+{
+    if(m_file)
+    {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+bool TextTraceReader::ReadVarint(uint32_t& value)
+{
+    value = 0;
+    for(int shift = 0; shift < 35; shift += 7)
+    {
+        int byte = fgetc(m_file);
+        if(byte == EOF)
+            return false;
+
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if(!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool TextTraceReader::ReadString(std::string& text)
+{
+    uint32_t len;
+    if(!ReadVarint(len) || len > TEXTTRACE_MAX_STRING)
+        return false;
+
+    text.resize(len);
+    return (len == 0 || fread(&text[0], 1, len, m_file) == len);
+}
+
+bool TextTraceReader::Next(TextTraceEvent& event)
+{
+    if(!m_file)
+        return false;
+
+    int type = fgetc(m_file);
+    if(type == EOF)
+        return false;
+
+    event.type = static_cast<TextTraceRecord>(type);
+    event.fontId = 0;
+    event.x = event.y = 0;
+    event.color = 0;
+    event.text.clear();
+    switch(type)
+    {
+        case TextTrace_Frame:
+            return true;
+        case TextTrace_LoadFont:
+        case TextTrace_Measure:
+            return (ReadVarint(event.fontId) && ReadString(event.text));
+        case TextTrace_Print:
+        case TextTrace_Blit:
+        {
+            uint32_t x, y;
+            if(!ReadVarint(event.fontId) || !ReadVarint(x) || !ReadVarint(y) || !ReadVarint(event.color) || !ReadString(event.text))
+                return false;
+
+            event.x = ZigZagDecode(x);
+            event.y = ZigZagDecode(y);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
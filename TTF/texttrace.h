@@ -0,0 +1,76 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+// Compact binary recording of every text call the game makes
+// The file starts with "TTFT", a format version and the text encoding, followed by records made of a type byte
+// and LEB128 encoded fields, positions are zigzag encoded and strings are a length followed by the raw bytes
+enum TextTraceRecord
+{
+    TextTrace_Frame = 1,
+    TextTrace_LoadFont,
+    TextTrace_Print,
+    TextTrace_Blit,
+    TextTrace_Measure
+};
+
+struct TextTraceEvent
+{
+    TextTraceRecord type;
+    uint32_t fontId;
+    int x;
+    int y;
+    uint32_t color;
+    std::string text;
+};
+
+class TextTraceWriter
+{
+    public:
+        TextTraceWriter() = default;
+        ~TextTraceWriter() {Close();}
+
+        TextTraceWriter(const TextTraceWriter&) = delete;
+        TextTraceWriter& operator=(const TextTraceWriter&) = delete;
+
+        bool Open(const char* path, int encoding);
+        void Close();
+        bool IsOpen() const {return m_file != nullptr;}
+
+        void Frame();
+        void LoadFont(uint32_t fontId, const std::string& descriptor);
+        void Text(TextTraceRecord type, uint32_t fontId, int x, int y, uint32_t color, const char* text, int len);
+        void Measure(uint32_t fontId, const char* text, int len);
+
+    private:
+        void WriteVarint(uint32_t value);
+        void WriteString(const char* text, size_t len);
+
+        FILE* m_file = nullptr;
+};
+
+class TextTraceReader
+{
+    public:
+        TextTraceReader() = default;
+        ~TextTraceReader() {Close();}
+
+        TextTraceReader(const TextTraceReader&) = delete;
+        TextTraceReader& operator=(const TextTraceReader&) = delete;
+
+        bool Open(const char* path);
+        void Close();
+        int GetEncoding() const {return m_encoding;}
+
+        // Returns false at the end of the trace or when the trace is truncated
+        bool Next(TextTraceEvent& event);
+
+    private:
+        bool ReadVarint(uint32_t& value);
+        bool ReadString(std::string& text);
+
+        FILE* m_file = nullptr;
+        int m_encoding = 0;
+};
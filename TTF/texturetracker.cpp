@@ -0,0 +1,89 @@
+#include "texturetracker.h"
+#include "log.h"
+
+static double GetPaddingRatio(const TextureUsage& usage)
+{
+    if(usage.bytes == 0)
+        return 0.0;
+    return 1.0 - static_cast<double>(usage.glyphBytes) / usage.bytes;
+}
+
+void TextureTracker::AddUsage(TextureUsage& usage, size_t bytes, size_t glyphBytes)
+{
+    ++usage.surfaces;
+    usage.bytes += bytes;
+    usage.glyphBytes += glyphBytes;
+    if(usage.bytes > usage.peakBytes)
+        usage.peakBytes = usage.bytes;
+}
+
+void TextureTracker::RemoveUsage(TextureUsage& usage, size_t bytes, size_t glyphBytes)
+{
+    --usage.surfaces;
+    usage.bytes -= bytes;
+    usage.glyphBytes -= glyphBytes;
+}
+
+void TextureTracker::Track(const void* surface, const std::string& owner, unsigned int width, unsigned int height, GlyphTextureFormat format,
+    unsigned int glyphWidth, unsigned int glyphHeight)
+{
+    Untrack(surface);
+
+    unsigned int texelSize = GetGlyphTexelSize(format);
+    Surface& entry = m_surfaces[surface];
+    entry.owner = &m_owners[owner];
+    entry.width = width;
+    entry.height = height;
+    entry.format = format;
+    entry.bytes = static_cast<size_t>(width) * height * texelSize;
+    entry.glyphBytes = static_cast<size_t>(glyphWidth) * glyphHeight * texelSize;
+    AddUsage(*entry.owner, entry.bytes, entry.glyphBytes);
+    AddUsage(m_total, entry.bytes, entry.glyphBytes);
+
+    if(m_budget && !m_overBudget && m_total.bytes > m_budget)
+    {
+        m_overBudget = true;
+        LogMessage("Warning: glyph textures use %u KiB which exceeds the budget of %u KiB", static_cast<unsigned int>(m_total.bytes / 1024),
+            static_cast<unsigned int>(m_budget / 1024));
+    }
+}
+
+void TextureTracker::Untrack(const void* surface)
+{
+    auto it = m_surfaces.find(surface);
+    if(it == m_surfaces.end())
+        return;
+
+    RemoveUsage(*it->second.owner, it->second.bytes, it->second.glyphBytes);
+    RemoveUsage(m_total, it->second.bytes, it->second.glyphBytes);
+    m_surfaces.erase(it);
+
+    // Warn again the next time the budget gets exceeded
+    if(m_overBudget && m_total.bytes <= m_budget)
+        m_overBudget = false;
+}
+
+void TextureTracker::SetGlyphArea(const void* surface, size_t glyphTexels)
+{
+    auto it = m_surfaces.find(surface);
+    if(it == m_surfaces.end())
+        return;
+
+    Surface& entry = it->second;
+    size_t glyphBytes = glyphTexels * GetGlyphTexelSize(entry.format);
+    entry.owner->glyphBytes = entry.owner->glyphBytes - entry.glyphBytes + glyphBytes;
+    m_total.glyphBytes = m_total.glyphBytes - entry.glyphBytes + glyphBytes;
+    entry.glyphBytes = glyphBytes;
+}
+
+void TextureTracker::LogReport() const
+{
+    for(const auto& it : m_owners)
+    {
+        const TextureUsage& usage = it.second;
+        LogMessage("Glyph textures of \"%s\": %u surfaces, %u KiB, %.1f%% padding, %u KiB peak", it.first.c_str(), static_cast<unsigned int>(usage.surfaces),
+            static_cast<unsigned int>(usage.bytes / 1024), GetPaddingRatio(usage) * 100.0, static_cast<unsigned int>(usage.peakBytes / 1024));
+    }
+    LogMessage("Glyph textures total: %u surfaces, %u KiB, %.1f%% padding, %u KiB peak", static_cast<unsigned int>(m_total.surfaces),
+        static_cast<unsigned int>(m_total.bytes / 1024), GetPaddingRatio(m_total) * 100.0, static_cast<unsigned int>(m_total.peakBytes / 1024));
+}
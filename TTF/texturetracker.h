@@ -0,0 +1,59 @@
+#pragma once
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "glyphconvert.h"
+
+struct TextureUsage
+{
+    size_t surfaces = 0;
+    size_t bytes = 0;
+    size_t glyphBytes = 0;
+    size_t peakBytes = 0;
+};
+
+// Keeps track of every glyph surface together with the area the glyph really covers
+// Usage is grouped by the font descriptor so it survives fonts getting reloaded
+class TextureTracker
+{
+    public:
+        TextureTracker() = default;
+        TextureTracker(const TextureTracker&) = delete;
+        TextureTracker& operator=(const TextureTracker&) = delete;
+
+        // Logs a warning whenever the total usage crosses the budget, 0 disables it
+        void SetBudget(size_t bytes) {m_budget = bytes;}
+        size_t GetBudget() const {return m_budget;}
+
+        void Track(const void* surface, const std::string& owner, unsigned int width, unsigned int height, GlyphTextureFormat format,
+            unsigned int glyphWidth, unsigned int glyphHeight);
+        void Untrack(const void* surface);
+
+        // Surfaces shared by several glyphs report the area their glyphs cover whenever it changes
+        void SetGlyphArea(const void* surface, size_t glyphTexels);
+
+        const TextureUsage& GetTotal() const {return m_total;}
+        void LogReport() const;
+
+    private:
+        struct Surface
+        {
+            TextureUsage* owner;
+            unsigned int width;
+            unsigned int height;
+            GlyphTextureFormat format;
+            size_t bytes;
+            size_t glyphBytes;
+        };
+
+        static void AddUsage(TextureUsage& usage, size_t bytes, size_t glyphBytes);
+        static void RemoveUsage(TextureUsage& usage, size_t bytes, size_t glyphBytes);
+
+        std::unordered_map<const void*, Surface> m_surfaces;
+        std::map<std::string, TextureUsage> m_owners;
+        TextureUsage m_total;
+        size_t m_budget = 0;
+        bool m_overBudget = false;
+};
@@ -0,0 +1,64 @@
+#include "toolfonts.h"
+
+#include <stdio.h>
+#include <ctype.h>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+static std::filesystem::path g_toolFontDirectory;
+
+static void ShowToolError(const char* message)
+{
+    fprintf(stderr, "%s\n", message);
+}
+
+bool InitializeToolFonts(const std::string& fontDirectory)
+{
+    g_toolFontDirectory = fontDirectory;
+    g_showFatalError = &ShowToolError;
+    return InitializeFreeType(nullptr);
+}
+
+void ShutdownToolFonts()
+{
+    UnloadToolFonts();
+    ShutdownFreeType();
+}
+
+void UnloadToolFonts()
+{
+    while(!g_fonts.empty())
+        UnloadFont(*g_fonts.begin());
+}
+
+void ResolveToolFontFile(std::string& file, int&)
+{
+    auto sameName = [&file](const std::string& name)
+    {
+        return std::equal(name.begin(), name.end(), file.begin(), file.end(), [](char a, char b)
+        {
+            return toupper(static_cast<unsigned char>(a)) == toupper(static_cast<unsigned char>(b));
+        });
+    };
+
+    std::error_code error;
+    for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(g_toolFontDirectory, error))
+    {
+        std::string name = entry.path().filename().string();
+        if(sameName(name))
+        {
+            file = entry.path().string();
+            return;
+        }
+    }
+    file = (g_toolFontDirectory / file).string();
+}
+
+TTFont* LoadToolFont(const std::string& descriptor)
+{
+    std::string fontName = descriptor;
+    if(!ResolveFontDescriptor(fontName))
+        return nullptr;
+    return LoadFont(fontName, &ResolveToolFontFile);
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+
+#include "glyphcache.h"
+
+// Font setup shared by the headless benchmark, tools and tests
+// Descriptors go through ResolveFontDescriptor and LoadFont like in game, their files are looked up in one font directory
+bool InitializeToolFonts(const std::string& fontDirectory);
+void ShutdownToolFonts();
+// Releases the glyphs of every font while g_renderBackend still holds their pages
+void UnloadToolFonts();
+
+// Descriptors come out of ResolveFontDescriptor uppercased, so the file is matched ignoring case
+void ResolveToolFontFile(std::string& file, int& size);
+// nullptr when the descriptor names no font or the face doesn't open
+TTFont* LoadToolFont(const std::string& descriptor);
@@ -0,0 +1,83 @@
+#include "tooltrace.h"
+#include "textcorpus.h"
+
+// Lines of the corpus drawn per traced frame
+#define CORPUS_FRAME_LINES 24
+
+TTFont* LoadTracedFont(const std::string& descriptor)
+{
+    TTFont* font = LoadToolFont(descriptor);
+    if(!font)
+        fprintf(stderr, "Failed to open traced font %s\n", descriptor.c_str());
+    return font;
+}
+
+bool TracedFonts::Load(uint32_t fontId, const std::string& descriptor)
+{
+    auto it = m_descriptors.find(descriptor);
+    if(it == m_descriptors.end())
+    {
+        TTFont* font = LoadTracedFont(descriptor);
+        if(!font)
+            return false;
+        it = m_descriptors.emplace(descriptor, static_cast<uint32_t>(m_fonts.size())).first;
+        m_fonts.push_back(font);
+    }
+    m_ids[fontId] = it->second;
+    return true;
+}
+
+int TracedFonts::GetIndex(uint32_t fontId) const
+{
+    auto it = m_ids.find(fontId);
+    return (it != m_ids.end() ? static_cast<int>(it->second) : -1);
+}
+
+bool WriteCorpusTrace(const char* tracePath, size_t linesPerSlice, const std::vector<std::string>& descriptors)
+{
+    TextTraceWriter writer;
+    if(descriptors.empty() || !writer.Open(tracePath, 0))
+        return false;
+
+    uint32_t fonts = static_cast<uint32_t>(descriptors.size());
+    for(uint32_t font = 0; font < fonts; ++font)
+        writer.LoadFont(font + 1, descriptors[font]);
+
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(linesPerSlice, slices);
+    std::vector<const std::string*> frameLines;
+    uint32_t line = 0;
+    // Every frame is traced twice like a dialog box standing on screen, the replay requires the second one to allocate nothing
+    auto writeFrames = [&]()
+    {
+        for(int repeat = 0; repeat < 2 && !frameLines.empty(); ++repeat)
+        {
+            for(size_t i = 0; i < frameLines.size(); ++i)
+            {
+                const std::string& text = *frameLines[i];
+                uint32_t fontId = (line + static_cast<uint32_t>(i)) % fonts + 1;
+                int len = static_cast<int>(text.length());
+                writer.Measure(fontId, text.c_str(), len);
+                writer.Text(TextTrace_Print, fontId, 16, 16 + static_cast<int>(i) * 40, 0xFFFFFFFF, text.c_str(), len);
+            }
+            writer.Frame();
+        }
+        line += static_cast<uint32_t>(frameLines.size());
+        frameLines.clear();
+    };
+
+    for(const CorpusSlice& slice : slices)
+    {
+        if(slice.encoding != 0)
+            continue;
+
+        for(const std::string& text : slice.lines)
+        {
+            frameLines.push_back(&text);
+            if(frameLines.size() == CORPUS_FRAME_LINES)
+                writeFrames();
+        }
+    }
+    writeFrames();
+    return true;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "textcore.h"
+#include "textstats.h"
+#include "texttrace.h"
+#include "toolfonts.h"
+
+// Reading traces in the tools and tests, traced fonts are opened again through LoadToolFont
+
+// Prints the descriptor of fonts that don't open
+TTFont* LoadTracedFont(const std::string& descriptor);
+
+// Fonts a trace loads, ids that load the same descriptor again share one font and its glyphs
+class TracedFonts
+{
+    public:
+        TracedFonts() = default;
+        TracedFonts(const TracedFonts&) = delete;
+        TracedFonts& operator=(const TracedFonts&) = delete;
+
+        bool Load(uint32_t fontId, const std::string& descriptor);
+
+        // Index of the font the id stands for, -1 for ids the trace never loaded
+        int GetIndex(uint32_t fontId) const;
+        TTFont* GetFont(uint32_t index) const {return m_fonts[index];}
+        const std::string& GetDescriptor(uint32_t index) const {return m_fonts[index]->name;}
+
+    private:
+        std::vector<TTFont*> m_fonts;
+        std::unordered_map<std::string, uint32_t> m_descriptors;
+        std::unordered_map<uint32_t, uint32_t> m_ids;
+};
+
+// Writes the UTF-8 slices of the benchmark corpus as a trace that measures and prints every line like dialog text,
+// the lines take turns between the descriptors and every frame is traced twice in a row
+bool WriteCorpusTrace(const char* tracePath, size_t linesPerSlice, const std::vector<std::string>& descriptors);
+
+// Calls func(font index, utf32) for every visible character the trace measures or draws
+template<typename Func>
+bool ForEachTracedCharacter(const char* tracePath, TracedFonts& fonts, Func func)
+{
+    TextTraceReader reader;
+    if(!reader.Open(tracePath))
+    {
+        fprintf(stderr, "Failed to open %s\n", tracePath);
+        return false;
+    }
+
+    TextTraceEvent event;
+    while(reader.Next(event))
+    {
+        if(event.type == TextTrace_LoadFont)
+        {
+            if(!fonts.Load(event.fontId, event.text))
+                return false;
+            continue;
+        }
+
+        int font = fonts.GetIndex(event.fontId);
+        if(font < 0 || (event.type != TextTrace_Print && event.type != TextTrace_Blit && event.type != TextTrace_Measure))
+            continue;
+
+        for(int i = 0, len = static_cast<int>(event.text.length()); i < len;)
+        {
+            int utf8size;
+            uint32_t utf32 = DecodeCharacter(reader.GetEncoding(), event.text.c_str() + i, len - i, utf8size);
+            i += utf8size;
+            if(utf32 > 32)
+                func(static_cast<uint32_t>(font), utf32);
+        }
+    }
+    return true;
+}
+
+// Draws the traced Print and Blit calls through the glyph cache and g_renderBackend the way the game's hooks do,
+// draw(frame) picks the frames that get drawn and endFrame(frame, drawTicks) follows every traced frame
+template<typename Draw, typename EndFrame>
+bool DrawTracedText(const char* tracePath, TracedFonts& fonts, Draw draw, EndFrame endFrame)
+{
+    TextTraceReader reader;
+    if(!reader.Open(tracePath))
+    {
+        fprintf(stderr, "Failed to open %s\n", tracePath);
+        return false;
+    }
+
+    uint32_t frame = 0;
+    int64_t drawTicks = 0;
+    TextTraceEvent event;
+    while(reader.Next(event))
+    {
+        if(event.type == TextTrace_LoadFont)
+        {
+            if(!fonts.Load(event.fontId, event.text))
+                return false;
+        }
+        else if(event.type == TextTrace_Frame)
+        {
+            endFrame(frame++, drawTicks);
+            drawTicks = 0;
+            ++g_textFrame;
+        }
+        else if((event.type == TextTrace_Print || event.type == TextTrace_Blit) && fonts.GetIndex(event.fontId) >= 0 && draw(frame))
+        {
+            TTFont* font = fonts.GetFont(static_cast<uint32_t>(fonts.GetIndex(event.fontId)));
+            int fontHeight = static_cast<int>(font->scaler.height);
+            int64_t drawStart = TextStatsTimestamp();
+            ++g_textCounters.drawCalls;
+            g_renderBackend->BeginText();
+            DrawGlyphs(font, event.x, event.y + font->ascent, fontHeight / 4, 1000000.f, GetGlyphColor(font, event.color), reader.GetEncoding(),
+                event.text.c_str(), static_cast<int>(event.text.length()));
+            g_renderBackend->EndText();
+            drawTicks += TextStatsTimestamp() - drawStart;
+        }
+    }
+    return true;
+}
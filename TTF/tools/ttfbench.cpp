@@ -0,0 +1,405 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ftmemory.h"
+#include "glyphconvert.h"
+#include "textbench.h"
+#include "textcorpus.h"
+#include "textstats.h"
+#include "toolfonts.h"
+
+// Headless benchmark of the text core and the glyph pipeline, runs without the game on the bundled fonts
+// Every benchmark writes a CSV into the output directory and TTFBenchReport.txt sums them up
+
+#ifndef TTF_BUNDLED_FONTS
+#define TTF_BUNDLED_FONTS "fonts"
+#endif
+#define BENCH_FONT "DejaVuSans.ttf"
+
+struct GlyphBenchCase
+{
+    const char* name;
+    unsigned int pageSize;
+    GlyphTextureFormat format;
+    bool directRaster;
+};
+
+static const GlyphBenchCase g_glyphBenchCases[] = {
+    {"surfaces_bgra", 0, GlyphFormat_BGRA8888, false},
+    {"atlas_bgra", 512, GlyphFormat_BGRA8888, false},
+    {"atlas_a8l8", 512, GlyphFormat_A8L8, false},
+    {"atlas_bgra_direct", 512, GlyphFormat_BGRA8888, true},
+};
+
+static const int g_glyphBenchSizes[] = {16, 24, 48};
+
+static void DrawCorpus(TTFont* font, const std::vector<CorpusSlice>& slices)
+{
+    uint32_t glyphColor = GetGlyphColor(font, 0xFFFFFFFF);
+    for(const CorpusSlice& slice : slices)
+    {
+        int y = 0;
+        for(const std::string& line : slice.lines)
+        {
+            ++g_textCounters.drawCalls;
+            g_renderBackend->BeginText();
+            DrawGlyphs(font, 0, y + font->ascent, static_cast<int>(font->scaler.height) / 4, 1000000.f, glyphColor, slice.encoding,
+                line.c_str(), static_cast<int>(line.length()));
+            g_renderBackend->EndText();
+            y = (y + font->height) % 1024;
+        }
+    }
+}
+
+// Draws the whole corpus once with an empty cache and then with every glyph cached, per font size and texture setup
+static bool RunGlyphBenchmark(const char* outputPath, size_t linesPerSlice, int iterations)
+{
+    FILE* f = fopen(outputPath, "w");
+    if(!f)
+        return false;
+
+    std::vector<CorpusSlice> slices;
+    BuildTextCorpus(linesPerSlice, slices);
+
+    fprintf(f, "setup,size,glyphs_drawn,cache_misses,cold_ms,raster_ms,warm_ms,warm_glyphs_s,draw_calls,pages,page_kb\n");
+
+    bool success = true;
+    for(const GlyphBenchCase& setup : g_glyphBenchCases)
+    {
+        for(int size : g_glyphBenchSizes)
+        {
+            HeadlessRenderBackend backend;
+            g_renderBackend = &backend;
+            g_glyphAtlas.SetPageSize(setup.pageSize);
+            g_textureFormat = setup.format;
+            g_useDirectRaster = setup.directRaster;
+
+            TTFont* font = LoadToolFont(std::string(BENCH_FONT) + ":Size=" + std::to_string(size));
+            if(!font)
+            {
+                success = false;
+                g_renderBackend = nullptr;
+                break;
+            }
+
+            g_textCounters = TextFrameCounters();
+            int64_t coldStart = TextStatsTimestamp();
+            DrawCorpus(font, slices);
+            double coldMs = TextStatsTicksToMs(TextStatsTimestamp() - coldStart);
+            TextFrameCounters cold = g_textCounters;
+
+            double warmMs = 0.0;
+            for(int i = 0; i < iterations; ++i)
+            {
+                g_textCounters = TextFrameCounters();
+                int64_t warmStart = TextStatsTimestamp();
+                DrawCorpus(font, slices);
+                double ms = TextStatsTicksToMs(TextStatsTimestamp() - warmStart);
+                warmMs = (i == 0 ? ms : std::min(warmMs, ms));
+            }
+
+            const RenderBackendStats& stats = backend.GetStats();
+            fprintf(f, "%s,%d,%u,%u,%.3f,%.3f,%.3f,%.0f,%u,%u,%u\n", setup.name, size, cold.glyphsDrawn, cold.cacheMisses, coldMs,
+                TextStatsTicksToMs(cold.rasterTicks), warmMs, (warmMs > 0.0 ? cold.glyphsDrawn * 1000.0 / warmMs : 0.0),
+                static_cast<unsigned int>(stats.drawCalls), static_cast<unsigned int>(stats.livePages), static_cast<unsigned int>(stats.pageBytes / 1024));
+
+            UnloadFont(font);
+            g_renderBackend = nullptr;
+        }
+    }
+
+    g_glyphAtlas.SetPageSize(0);
+    g_textureFormat = GlyphFormat_BGRA8888;
+    g_useDirectRaster = false;
+    fclose(f);
+    return success;
+}
+
+static const char* const g_convertLevelNames[] = {"scalar", "sse2", "ssse3"};
+static const int g_convertBenchWidths[] = {8, 24, 64};
+
+// Converts glyph sized coverage bitmaps with every kernel the CPU runs, per texture format and glyph width
+static bool RunConvertBenchmark(const char* outputPath, size_t linesPerSlice, int iterations)
+{
+    FILE* f = fopen(outputPath, "w");
+    if(!f)
+        return false;
+
+    fprintf(f, "format,kernel,width,texels,best_ms,texels_s\n");
+
+    const int height = 64;
+    unsigned char alphaTable[256];
+    BuildAlphaTable(alphaTable, 255, 1.4f);
+    std::vector<unsigned char> src(static_cast<size_t>(64 * height));
+    for(size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<unsigned char>(i * 37 + i / 64);
+    std::vector<unsigned char> dst(src.size() * 4);
+
+    // The bitmap count follows the corpus size so --lines scales this benchmark like the others
+    int bitmaps = static_cast<int>(std::max<size_t>(linesPerSlice, 1) * 20);
+    for(int format = 0; format < GlyphFormat_Count; ++format)
+    {
+        GlyphTextureFormat textureFormat = static_cast<GlyphTextureFormat>(format);
+        for(int level = GlyphConvert_Scalar; level <= GetGlyphConvertLevel(); ++level)
+        {
+            GlyphConvertRowFunc convertRow = GetGlyphConvertRow(textureFormat, static_cast<GlyphConvertLevel>(level));
+            for(int width : g_convertBenchWidths)
+            {
+                int dstPitch = width * static_cast<int>(GetGlyphTexelSize(textureFormat));
+                double bestMs = 0.0;
+                for(int i = 0; i < iterations; ++i)
+                {
+                    int64_t start = TextStatsTimestamp();
+                    for(int b = 0; b < bitmaps; ++b)
+                    {
+                        for(int h = 0; h < height; ++h)
+                            convertRow(dst.data() + h * dstPitch, src.data() + h * width, width, alphaTable, 0x00FFFFFF);
+                    }
+                    double ms = TextStatsTicksToMs(TextStatsTimestamp() - start);
+                    bestMs = (i == 0 ? ms : std::min(bestMs, ms));
+                }
+
+                double texels = static_cast<double>(bitmaps) * width * height;
+                fprintf(f, "%s,%s,%d,%.0f,%.3f,%.0f\n", (textureFormat == GlyphFormat_A8L8 ? "A8L8" : "BGRA"), g_convertLevelNames[level], width,
+                    texels, bestMs, (bestMs > 0.0 ? texels * 1000.0 / bestMs : 0.0));
+            }
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+struct AllocBenchPattern
+{
+    const char* name;
+    size_t liveBlocks;
+    // One allocation in this many is above the pool's largest size class
+    unsigned int largeEvery;
+};
+
+static const AllocBenchPattern g_allocBenchPatterns[] = {
+    {"glyph_load", 32, 0},
+    {"face_cache", 1024, 0},
+    {"mixed_large", 256, 16},
+};
+
+// Replaces random blocks of a working set the way FreeType churns through glyph loads, once through FTPoolAllocator and once through malloc
+static bool RunAllocBenchmark(const char* outputPath, size_t linesPerSlice, int iterations)
+{
+    FILE* f = fopen(outputPath, "w");
+    if(!f)
+        return false;
+
+    fprintf(f, "allocator,pattern,operations,best_ms,ops_s\n");
+
+    size_t operations = std::max<size_t>(linesPerSlice, 1) * 2000;
+    for(const AllocBenchPattern& pattern : g_allocBenchPatterns)
+    {
+        // The same sizes and replaced slots for both allocators, mostly small blocks like FreeType's outlines and glyph slots
+        std::vector<size_t> sizes(operations), slots(operations);
+        uint32_t seed = 12345;
+        for(size_t i = 0; i < operations; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            uint32_t value = seed >> 8;
+            if(pattern.largeEvery && value % pattern.largeEvery == 0)
+                sizes[i] = 4097 + value % 60000;
+            else
+                sizes[i] = 8 + (value % 1024) * (value % 4 == 0 ? 4 : 1) / 2;
+            slots[i] = (value >> 10) % pattern.liveBlocks;
+        }
+
+        for(int useMalloc = 0; useMalloc < 2; ++useMalloc)
+        {
+            double bestMs = 0.0;
+            for(int i = 0; i < iterations; ++i)
+            {
+                FTPoolAllocator allocator;
+                std::vector<void*> blocks(pattern.liveBlocks, nullptr);
+                int64_t start = TextStatsTimestamp();
+                for(size_t op = 0; op < operations; ++op)
+                {
+                    void*& block = blocks[slots[op]];
+                    if(useMalloc)
+                    {
+                        free(block);
+                        block = malloc(sizes[op]);
+                    }
+                    else
+                    {
+                        allocator.Free(block);
+                        block = allocator.Allocate(sizes[op]);
+                    }
+                }
+                for(void* block : blocks)
+                {
+                    if(useMalloc)
+                        free(block);
+                    else
+                        allocator.Free(block);
+                }
+                double ms = TextStatsTicksToMs(TextStatsTimestamp() - start);
+                bestMs = (i == 0 ? ms : std::min(bestMs, ms));
+            }
+
+            // Every replaced block is one allocation and one free
+            double ops = static_cast<double>(operations) * 2;
+            fprintf(f, "%s,%s,%.0f,%.3f,%.0f\n", (useMalloc ? "malloc" : "pool"), pattern.name, ops, bestMs, (bestMs > 0.0 ? ops * 1000.0 / bestMs : 0.0));
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+static void SplitCSVLine(const std::string& line, std::vector<std::string>& fields)
+{
+    fields.clear();
+    for(size_t pos = 0, start = 0; pos != std::string::npos; start = pos + 1)
+    {
+        pos = line.find(',', start);
+        fields.push_back(line.substr(start, pos - start));
+    }
+}
+
+// Median of every numeric column over the rows of one benchmark, the label columns and checksums are left out
+static bool ReportCSV(FILE* report, const std::string& path)
+{
+    FILE* f = fopen(path.c_str(), "r");
+    if(!f)
+        return false;
+
+    std::vector<std::string> header, fields;
+    std::vector<std::vector<double>> columns;
+    char buffer[1024];
+    size_t rows = 0;
+    while(fgets(buffer, sizeof(buffer), f))
+    {
+        std::string line(buffer);
+        while(!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+        if(header.empty())
+        {
+            SplitCSVLine(line, header);
+            columns.resize(header.size());
+            continue;
+        }
+
+        SplitCSVLine(line, fields);
+        for(size_t i = 0; i < fields.size() && i < columns.size(); ++i)
+        {
+            char* end;
+            double value = strtod(fields[i].c_str(), &end);
+            if(!fields[i].empty() && *end == '\0' && header[i] != "checksum" && header[i] != "encoding" && header[i] != "size")
+                columns[i].push_back(value);
+        }
+        ++rows;
+    }
+    fclose(f);
+
+    fprintf(report, "%s, %u rows, column medians:\n", path.c_str(), static_cast<unsigned int>(rows));
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        std::vector<double>& values = columns[i];
+        if(values.empty() || values.size() != rows)
+            continue;
+        std::sort(values.begin(), values.end());
+        fprintf(report, "  %-26s %14.3f\n", header[i].c_str(), values[values.size() / 2]);
+    }
+    fprintf(report, "\n");
+    return true;
+}
+
+static void PrintUsage()
+{
+    fprintf(stderr, "Usage: ttfbench [--fonts <directory>] [--lines <lines per slice>] [--iterations <count>] [--out <directory>]\n");
+}
+
+int main(int argc, char** argv)
+{
+    std::string fontDirectory = TTF_BUNDLED_FONTS;
+    std::string outputDirectory = ".";
+    size_t lines = 200;
+    int iterations = 5;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(i + 1 == argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+        if(strcmp(argv[i], "--fonts") == 0)
+            fontDirectory = argv[++i];
+        else if(strcmp(argv[i], "--lines") == 0)
+            lines = static_cast<size_t>(std::max(atoi(argv[++i]), 1));
+        else if(strcmp(argv[i], "--iterations") == 0)
+            iterations = std::max(atoi(argv[++i]), 1);
+        else if(strcmp(argv[i], "--out") == 0)
+            outputDirectory = argv[++i];
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if(!InitializeToolFonts(fontDirectory))
+    {
+        fprintf(stderr, "Failed to initialize FreeType\n");
+        return 1;
+    }
+
+    struct Benchmark
+    {
+        const char* file;
+        bool(*run)(const char*, size_t, int);
+    };
+    const Benchmark benchmarks[] = {
+        {"TTFBench.csv", &RunTextBenchmark},
+        {"TTFWrapBench.csv", &RunWrapBenchmark},
+        {"TTFComposeBench.csv", &RunComposeBenchmark},
+        {"TTFGlyphBench.csv", &RunGlyphBenchmark},
+        {"TTFConvertBench.csv", &RunConvertBenchmark},
+        {"TTFAllocBench.csv", &RunAllocBenchmark},
+    };
+
+    std::string reportPath = outputDirectory + "/TTFBenchReport.txt";
+    FILE* report = fopen(reportPath.c_str(), "w");
+    if(!report)
+    {
+        fprintf(stderr, "Failed to write %s\n", reportPath.c_str());
+        ShutdownToolFonts();
+        return 1;
+    }
+    fprintf(report, "ttfbench, %u lines per slice, best of %d iterations, glyph convert level %d, fonts from %s\n\n",
+        static_cast<unsigned int>(lines), iterations, static_cast<int>(GetGlyphConvertLevel()), fontDirectory.c_str());
+
+    int result = 0;
+    for(const Benchmark& benchmark : benchmarks)
+    {
+        std::string path = outputDirectory + "/" + benchmark.file;
+        if(!benchmark.run(path.c_str(), lines, iterations) || !ReportCSV(report, path))
+        {
+            fprintf(stderr, "Failed to write %s\n", path.c_str());
+            result = 1;
+        }
+    }
+    fclose(report);
+    ShutdownToolFonts();
+
+    if(result == 0)
+    {
+        report = fopen(reportPath.c_str(), "r");
+        char buffer[256];
+        while(report && fgets(buffer, sizeof(buffer), report))
+            fputs(buffer, stdout);
+        if(report)
+            fclose(report);
+    }
+    return result;
+}
@@ -0,0 +1,359 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "atlasdump.h"
+#include "cachesim.h"
+#include "glyphusage.h"
+#include "textreplay.h"
+#include "telemetry.h"
+#include "tooltrace.h"
+
+// Offline tools working on text traces captured with CaptureTrace=True, they run without the game
+// Traced fonts are opened again from their descriptors with the font files looked up in a font directory
+
+// ttftool corpus-trace <trace> <lines per slice> <descriptor...>
+static int CorpusTrace(char** args, int count)
+{
+    int linesPerSlice = atoi(args[1]);
+    if(linesPerSlice <= 0)
+        return -1;
+
+    if(!WriteCorpusTrace(args[0], static_cast<size_t>(linesPerSlice), std::vector<std::string>(args + 2, args + count)))
+    {
+        fprintf(stderr, "Failed to write %s\n", args[0]);
+        return 1;
+    }
+    return 0;
+}
+
+// ttftool replay <font directory> <trace> <report.csv>
+static int ReplayTrace(char** args, int)
+{
+    if(!InitializeToolFonts(args[0]))
+    {
+        fprintf(stderr, "Failed to initialize FreeType\n");
+        return 1;
+    }
+
+    // Pages stay in system memory, the report covers the text core and the glyph cache
+    HeadlessRenderBackend backend;
+    g_renderBackend = &backend;
+    uint32_t allocatingFrames;
+    bool success = ReplayTextTrace(args[1], args[2], &LoadTracedFont, allocatingFrames);
+    ShutdownToolFonts();
+    g_renderBackend = nullptr;
+
+    if(!success)
+    {
+        fprintf(stderr, "Failed to replay %s\n", args[1]);
+        return 1;
+    }
+    if(allocatingFrames != 0)
+    {
+        fprintf(stderr, "%u repeated frames allocated, see the freetype_allocs and heap_allocs columns\n", allocatingFrames);
+        return 1;
+    }
+    return 0;
+}
+
+// ttftool merge-usage <manifest> <histograms...>
+static int MergeUsage(char** args, int count)
+{
+    // Shells expand TTFUsage_*.txt, the Windows build links setargv.obj to do the same
+    GlyphUsage usage;
+    int merged = 0;
+    for(int i = 1; i < count; ++i)
+    {
+        if(usage.Load(args[i]))
+            ++merged;
+        else
+            fprintf(stderr, "Failed to read %s\n", args[i]);
+    }
+
+    if(merged == 0)
+    {
+        fprintf(stderr, "No glyph usage histograms found\n");
+        return 1;
+    }
+    if(!usage.Save(args[0]))
+    {
+        fprintf(stderr, "Failed to write %s\n", args[0]);
+        return 1;
+    }
+    return 0;
+}
+
+// ttftool simulate-cache <font directory> <trace> <report.csv>
+static int SimulateCache(char** args, int)
+{
+    if(!InitializeToolFonts(args[0]))
+    {
+        fprintf(stderr, "Failed to initialize FreeType\n");
+        return 1;
+    }
+
+    // Glyph sizes come from FreeType without creating any texture
+    TracedFonts fonts;
+    std::vector<GlyphRequest> requests;
+    std::unordered_map<uint64_t, std::pair<unsigned int, unsigned int>> glyphSizes;
+    bool success = ForEachTracedCharacter(args[1], fonts, [&](uint32_t font, uint32_t utf32)
+    {
+        uint64_t key = (static_cast<uint64_t>(font) << 32) | utf32;
+        auto it = glyphSizes.find(key);
+        if(it == glyphSizes.end())
+        {
+            GlyphImage image;
+            LoadGlyphImage(fonts.GetFont(font), utf32, image);
+            it = glyphSizes.emplace(key, std::make_pair(image.width, image.rows)).first;
+        }
+        requests.push_back({font, utf32, it->second.first, it->second.second});
+    });
+    ShutdownToolFonts();
+    if(!success)
+        return 1;
+
+    std::vector<CachePolicy> policies;
+    GetDefaultCachePolicies(policies);
+    if(!WriteCacheSimulation(args[2], policies, requests))
+    {
+        fprintf(stderr, "Failed to write %s\n", args[2]);
+        return 1;
+    }
+    return 0;
+}
+
+// ttftool dump-atlas <font directory> <trace> <page size> <prefix>
+static int DumpAtlas(char** args, int)
+{
+    if(atoi(args[2]) <= 0)
+        return -1;
+    if(!InitializeToolFonts(args[0]))
+    {
+        fprintf(stderr, "Failed to initialize FreeType\n");
+        return 1;
+    }
+
+    // Pages live in memory as 8-bit coverage and glyphs get packed in the order the text first uses them
+    GlyphAtlas atlas;
+    atlas.SetPageSize(static_cast<unsigned int>(atoi(args[2])));
+    unsigned int pageSize = atlas.GetPageSize();
+    TracedFonts fonts;
+    std::vector<std::vector<unsigned char>> pixels;
+    std::vector<AtlasDumpGlyph> glyphs;
+    std::unordered_map<uint64_t, size_t> packed;
+    uint32_t characters = 0;
+    bool success = ForEachTracedCharacter(args[1], fonts, [&](uint32_t font, uint32_t utf32)
+    {
+        // Without frames the position in the text serves as the last-used time
+        ++characters;
+        auto it = packed.emplace((static_cast<uint64_t>(font) << 32) | utf32, glyphs.size());
+        if(!it.second)
+        {
+            if(it.first->second < glyphs.size())
+                glyphs[it.first->second].lastUsed = characters;
+            return;
+        }
+
+        GlyphImage image;
+        LoadGlyphImage(fonts.GetFont(font), utf32, image);
+        if(!atlas.Fits(image.width, image.rows))
+        {
+            it.first->second = SIZE_MAX;
+            return;
+        }
+
+        AtlasRect rect;
+        int page = atlas.Allocate(image.width, image.rows, rect);
+        if(page < 0)
+        {
+            page = atlas.ReservePage();
+            pixels.resize(atlas.GetPageCount());
+            pixels[page].assign(static_cast<size_t>(pageSize) * pageSize, 0);
+            atlas.Allocate(image.width, image.rows, rect);
+        }
+
+        if(image.buffer)
+        {
+            for(unsigned int y = 0; y < image.rows; ++y)
+                memcpy(&pixels[page][(rect.y + y) * pageSize + rect.x], image.buffer + static_cast<int>(y) * image.pitch, image.width);
+        }
+        glyphs.push_back({fonts.GetDescriptor(font), utf32, page, rect, characters});
+    });
+    ShutdownToolFonts();
+    if(!success)
+        return 1;
+
+    if(!WriteAtlasDump(args[3], atlas, glyphs, pixels, characters))
+    {
+        fprintf(stderr, "Failed to write %s\n", args[3]);
+        return 1;
+    }
+    return 0;
+}
+
+// ttftool watch-telemetry <report.csv> [interval ms] [seconds]
+static int WatchTelemetry(char** args, int count)
+{
+    int intervalMs = (count > 1 ? std::max(atoi(args[1]), 1) : 1000);
+    int seconds = (count > 2 ? atoi(args[2]) : 0);
+    if(!PollTelemetry(TTF_TELEMETRY_NAME, args[0], intervalMs, seconds))
+    {
+        fprintf(stderr, "No game is publishing telemetry, enable Telemetry in TTF.ini\n");
+        return 1;
+    }
+    return 0;
+}
+
+// ttftool bench-trace <font directory> <trace> <page size> <report.csv>
+static int BenchTrace(char** args, int)
+{
+    FILE* f = fopen(args[3], "w");
+    if(!f)
+    {
+        fprintf(stderr, "Failed to write %s\n", args[3]);
+        return 1;
+    }
+    if(!InitializeToolFonts(args[0]))
+    {
+        fprintf(stderr, "Failed to initialize FreeType\n");
+        fclose(f);
+        return 1;
+    }
+    fprintf(f, "frame,draw_calls,glyphs_drawn,batches,cache_misses,raster_ms,draw_ms,pages,page_kb\n");
+
+    // Pages stay in system memory so the numbers only cover the cache, the atlas and the batching
+    HeadlessRenderBackend backend;
+    g_renderBackend = &backend;
+    g_glyphAtlas.SetPageSize(static_cast<unsigned int>(std::max(atoi(args[2]), 0)));
+    g_textCounters = TextFrameCounters();
+    TracedFonts fonts;
+    size_t batches = 0;
+    bool success = DrawTracedText(args[1], fonts, [](uint32_t)
+    {
+        return true;
+    }, [&](uint32_t frame, int64_t drawTicks)
+    {
+        const RenderBackendStats& stats = backend.GetStats();
+        fprintf(f, "%u,%u,%u,%u,%u,%.3f,%.3f,%u,%u\n", frame, g_textCounters.drawCalls, g_textCounters.glyphsDrawn,
+            static_cast<unsigned int>(stats.drawCalls - batches), g_textCounters.cacheMisses, TextStatsTicksToMs(g_textCounters.rasterTicks),
+            TextStatsTicksToMs(drawTicks), static_cast<unsigned int>(stats.livePages), static_cast<unsigned int>(stats.pageBytes / 1024));
+        batches = stats.drawCalls;
+        g_textCounters = TextFrameCounters();
+    });
+    fclose(f);
+
+    ShutdownToolFonts();
+    g_renderBackend = nullptr;
+    return (success ? 0 : 1);
+}
+
+// ttftool render-trace <font directory> <trace> <page size> <frame> <width> <height> <image.png>
+static int RenderTrace(char** args, int)
+{
+    int width = atoi(args[4]);
+    int height = atoi(args[5]);
+    if(width <= 0 || height <= 0)
+        return -1;
+    if(!InitializeToolFonts(args[0]))
+    {
+        fprintf(stderr, "Failed to initialize FreeType\n");
+        return 1;
+    }
+
+    // Earlier frames still go through the cache so the atlas looks the way it did in game
+    SoftwareRenderBackend backend;
+    backend.SetTarget(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+    g_renderBackend = &backend;
+    g_glyphAtlas.SetPageSize(static_cast<unsigned int>(std::max(atoi(args[2]), 0)));
+    uint32_t renderFrame = static_cast<uint32_t>(atoi(args[3]));
+    bool rendered = false;
+    TracedFonts fonts;
+    bool success = DrawTracedText(args[1], fonts, [renderFrame](uint32_t frame)
+    {
+        return frame <= renderFrame;
+    }, [&](uint32_t frame, int64_t)
+    {
+        if(frame + 1 == renderFrame)
+            backend.SetTarget(static_cast<unsigned int>(width), static_cast<unsigned int>(height));
+        else if(frame == renderFrame)
+            rendered = true;
+    });
+
+    ShutdownToolFonts();
+    g_renderBackend = nullptr;
+    if(!success)
+        return 1;
+    if(!rendered)
+    {
+        fprintf(stderr, "The trace ends before frame %u\n", renderFrame);
+        return 1;
+    }
+
+    // Luminance of the composited frame, glyph colors only matter through their brightness in reference images
+    const std::vector<uint32_t>& target = backend.GetTarget();
+    std::vector<unsigned char> pixels(target.size());
+    for(size_t i = 0; i < target.size(); ++i)
+        pixels[i] = static_cast<unsigned char>((((target[i] >> 16) & 0xFF) * 77 + ((target[i] >> 8) & 0xFF) * 150 + (target[i] & 0xFF) * 29) >> 8);
+    if(!WriteGrayPNG(args[6], backend.GetTargetWidth(), backend.GetTargetHeight(), pixels.data()))
+    {
+        fprintf(stderr, "Failed to write %s\n", args[6]);
+        return 1;
+    }
+    return 0;
+}
+
+struct ToolCommand
+{
+    const char* name;
+    const char* arguments;
+    int minArgs;
+    int maxArgs;
+    // Returns the exit code, -1 for bad arguments
+    int(*run)(char** args, int count);
+};
+
+static const ToolCommand g_toolCommands[] = {
+    {"corpus-trace", "<trace> <lines per slice> <descriptor...>", 3, 64, &CorpusTrace},
+    {"replay", "<font directory> <trace> <report.csv>", 3, 3, &ReplayTrace},
+    {"simulate-cache", "<font directory> <trace> <report.csv>", 3, 3, &SimulateCache},
+    {"dump-atlas", "<font directory> <trace> <page size> <prefix>", 4, 4, &DumpAtlas},
+    {"bench-trace", "<font directory> <trace> <page size> <report.csv>", 4, 4, &BenchTrace},
+    {"render-trace", "<font directory> <trace> <page size> <frame> <width> <height> <image.png>", 7, 7, &RenderTrace},
+    {"merge-usage", "<manifest> <histograms...>", 2, 1024, &MergeUsage},
+    {"watch-telemetry", "<report.csv> [interval ms] [seconds]", 1, 3, &WatchTelemetry},
+};
+
+static int PrintUsage(const ToolCommand* command)
+{
+    for(const ToolCommand& usage : g_toolCommands)
+    {
+        if(!command || command == &usage)
+            fprintf(stderr, "Usage: ttftool %s %s\n", usage.name, usage.arguments);
+    }
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+        return PrintUsage(nullptr);
+
+    for(const ToolCommand& command : g_toolCommands)
+    {
+        if(strcmp(argv[1], command.name) != 0)
+            continue;
+
+        int count = argc - 2;
+        if(count < command.minArgs || count > command.maxArgs)
+            return PrintUsage(&command);
+        int result = command.run(argv + 2, count);
+        return (result < 0 ? PrintUsage(&command) : result);
+    }
+    return PrintUsage(nullptr);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// Exported C API for mods and plugins that want TrueType text without going through a zCFont or shipping FreeType themselves
+// Fonts, glyph cache and textures are shared with the game's text, look the functions up with GetProcAddress on TTF.dll
+// and call them on the thread the game draws on. Text is UTF-8, a negative length takes the text as null terminated.
+#define TTF_API_VERSION 1
+
+// Only the Windows build exports the functions, the headless tools build the same code elsewhere
+#if !defined(_WIN32) && !defined(__cdecl)
+#define __cdecl
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TTF_Font TTF_Font;
+
+// Size is the pixel size after UI scaling, descent is negative below the baseline
+typedef struct TTF_FontMetrics
+{
+    int32_t size;
+    int32_t height;
+    int32_t ascent;
+    int32_t descent;
+} TTF_FontMetrics;
+
+// Byte range of one wrapped line and its width in pixels
+typedef struct TTF_TextLine
+{
+    int32_t start;
+    int32_t length;
+    int32_t width;
+} TTF_TextLine;
+
+typedef uint32_t(__cdecl* TTF_GetApiVersionFunc)();
+// Descriptors look like the [FONTS] entries of TTF.ini or name one of them, fonts stay loaded until the game exits
+typedef TTF_Font*(__cdecl* TTF_GetFontFunc)(const char* descriptor);
+typedef int(__cdecl* TTF_GetFontMetricsFunc)(TTF_Font* font, TTF_FontMetrics* metrics);
+typedef int32_t(__cdecl* TTF_MeasureTextFunc)(TTF_Font* font, const char* text, int32_t length);
+// Wraps at the UAX #14 break opportunities, so between words and between any two ideographs, returns how many lines the text needs and writes no more than maxLines of them
+typedef int32_t(__cdecl* TTF_LayoutTextFunc)(TTF_Font* font, const char* text, int32_t length, int32_t maxWidth, TTF_TextLine* lines, int32_t maxLines);
+// Queues text with its top left corner at x, y in screen pixels, queued text gets drawn over the game's text when the frame ends
+// color is 0xAARRGGBB multiplied with the font color, returns 0 while the game has no device to draw on
+typedef int(__cdecl* TTF_DrawTextFunc)(TTF_Font* font, int32_t x, int32_t y, uint32_t color, const char* text, int32_t length);
+
+#ifdef __cplusplus
+}
+#endif